@@ -0,0 +1,41 @@
+#include "alloc_stats.h"
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include <atomic>
+#include <new>
+#include <stdlib.h>
+
+static std::atomic<uint32_t> newCount{0};
+static std::atomic<uint32_t> deleteCount{0};
+
+static void* countedAlloc(size_t size) {
+    newCount.fetch_add(1, std::memory_order_relaxed);
+    void* p = malloc(size ? size : 1);
+    if(!p) abort();
+    return p;
+}
+
+static void countedFree(void* p) {
+    if(!p) return;
+    deleteCount.fetch_add(1, std::memory_order_relaxed);
+    free(p);
+}
+
+void* operator new(size_t size) { return countedAlloc(size); }
+void* operator new[](size_t size) { return countedAlloc(size); }
+void operator delete(void* p) noexcept { countedFree(p); }
+void operator delete[](void* p) noexcept { countedFree(p); }
+void operator delete(void* p, size_t) noexcept { countedFree(p); }
+void operator delete[](void* p, size_t) noexcept { countedFree(p); }
+
+AllocStats allocStats() {
+    multi_heap_info_t info;
+    heap_caps_get_info(&info, MALLOC_CAP_8BIT);
+    AllocStats s;
+    s.news = newCount.load(std::memory_order_relaxed);
+    s.deletes = deleteCount.load(std::memory_order_relaxed);
+    s.heapBlocks = info.allocated_blocks;
+    s.freeHeap = info.total_free_bytes;
+    s.minFreeHeap = info.minimum_free_bytes;
+    return s;
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <stdint.h>
+
+/* ================== ALLOCATION COUNTER ================== */
+// Counts every C++ operator new/delete made anywhere in the firmware
+// (std::string, containers, library objects) and samples the heap's live
+// block count, which also catches malloc()/realloc() users such as String.
+// Take two snapshots a few seconds apart: a path that is heap-free in steady
+// state shows no new allocations and a flat block count.
+
+struct AllocStats {
+    uint32_t news;        // operator new calls since boot
+    uint32_t deletes;
+    uint32_t heapBlocks;  // live blocks in the 8-bit capable heap
+    uint32_t freeHeap;
+    uint32_t minFreeHeap;
+};
+
+AllocStats allocStats();
@@ -0,0 +1,61 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+
+/* ================== SPSC RING ================== */
+// Lock-free single-producer/single-consumer queue. The producer (a radio
+// callback) only ever writes head, the consumer (loop) only ever writes tail,
+// so neither side blocks or disables interrupts. Full rings drop the new item
+// and count it rather than overwrite data the consumer may be reading.
+template <typename T, uint32_t N>
+class SpscRing {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscRing size must be a power of two");
+
+public:
+    // Producer side
+    bool push(const T& item) {
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if(h - tail.load(std::memory_order_acquire) >= N) {
+            overflows.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        slots[h & (N - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T& item) {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if(t == head.load(std::memory_order_acquire)) return false;
+        item = slots[t & (N - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Discards everything queued so far. Consumer side only.
+    void clear() { tail.store(head.load(std::memory_order_acquire), std::memory_order_release); }
+
+    uint32_t size() const { return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire); }
+    uint32_t dropped() const { return overflows.load(std::memory_order_relaxed); }
+    static constexpr uint32_t capacity() { return N; }
+
+private:
+    T slots[N];
+    std::atomic<uint32_t> head{0};
+    std::atomic<uint32_t> tail{0};
+    std::atomic<uint32_t> overflows{0};
+};
+
+/* ================== CAPTURE RECORD ================== */
+// Compact per-frame summary the promiscuous callback hands to the loop.
+struct CaptureRecord {
+    uint32_t timestampUs;   // rx_ctrl.timestamp, WiFi local clock
+    uint16_t length;        // sig_len, including FCS
+    int8_t   rssi;
+    uint8_t  channel;
+    uint8_t  frameType;     // 0 mgmt, 1 ctrl, 2 data, 3 extension
+    uint8_t  frameSubtype;  // 0..15
+    uint8_t  flags;         // frame control byte 1 (ToDS, FromDS, retry, ...)
+    uint8_t  reserved;
+};
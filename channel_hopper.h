@@ -0,0 +1,91 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+
+/* ================== CHANNEL HOPPER ================== */
+// Round-robin over channels 1..13 with a per-channel dwell, plus the
+// activity each channel showed while it was being listened to. poll() is
+// called from the radio task's tick and only says when to retune, so the
+// hop loop never sleeps. With adaptive dwell each channel's time is scaled
+// by its share of the recent frame rate: busy channels are watched longer,
+// idle ones are skimmed, and the average stays at the base dwell so a full
+// sweep takes about as long either way.
+
+#define HOP_CHANNELS      13
+#define HOP_DWELL_MS      250    // default base dwell
+#define HOP_MIN_DWELL_MS  50
+#define HOP_MAX_DWELL_MS  2000
+
+enum FrameKind : uint8_t { KIND_MGMT, KIND_CTRL, KIND_DATA, KIND_COUNT };
+
+struct ChannelActivity {
+    uint32_t frames;              // since reset
+    uint32_t kinds[KIND_COUNT];   // ... by frame type
+    uint32_t listenMs;            // time spent tuned here
+    uint16_t rate;                // frames/s while tuned here, smoothed over visits
+    int16_t rssiQ4;               // smoothed RSSI in 1/16 dBm, 0 = nothing heard
+};
+
+class ChannelHopper {
+public:
+    void reset() { memset(act, 0, sizeof(act)); }
+
+    // Starts a dwell on channel (the caller has just tuned to it)
+    void tuneTo(uint8_t channel, uint32_t now) {
+        cur = channel;
+        since = now;
+        dwellFrames = 0;
+        dwell = dwellFor(cur);
+    }
+
+    void setBaseDwell(uint16_t ms) { base = ms < HOP_MIN_DWELL_MS ? HOP_MIN_DWELL_MS : (ms > HOP_MAX_DWELL_MS ? HOP_MAX_DWELL_MS : ms); }
+    void setAdaptive(bool on) { adaptive = on; }
+    uint16_t baseDwell() const { return base; }
+    bool isAdaptive() const { return adaptive; }
+
+    // One captured frame; channel is the one it was received on
+    void record(uint8_t channel, int8_t rssi, uint8_t frameType) {
+        if(channel < 1 || channel > HOP_CHANNELS) return;
+        ChannelActivity& a = act[channel - 1];
+        a.frames++;
+        a.kinds[frameType == 0 ? KIND_MGMT : (frameType == 2 ? KIND_DATA : KIND_CTRL)]++;
+        if(a.rssiQ4 == 0) a.rssiQ4 = rssi * 16;
+        else a.rssiQ4 += (rssi * 16 - a.rssiQ4) / 8;
+        if(channel == cur) dwellFrames++;
+    }
+
+    // Channel to tune to if the current dwell is over, otherwise 0
+    uint8_t poll(uint32_t now) {
+        uint32_t elapsed = now - since;
+        if(elapsed < dwell) return 0;
+        ChannelActivity& a = act[cur - 1];
+        uint32_t sample = elapsed ? dwellFrames * 1000 / elapsed : 0;
+        if(sample > 0xFFFF) sample = 0xFFFF;
+        a.rate = a.listenMs ? (uint16_t)(a.rate + ((int32_t)sample - a.rate) / 4) : (uint16_t)sample;
+        a.listenMs += elapsed;
+        tuneTo(cur % HOP_CHANNELS + 1, now);
+        return cur;
+    }
+
+    // base/2 .. base/2 + base * 13/2 by the channel's share of all traffic
+    uint16_t dwellFor(uint8_t channel) const {
+        if(!adaptive) return base;
+        uint32_t sum = 0;
+        for(int i = 0; i < HOP_CHANNELS; i++) sum += act[i].rate;
+        if(!sum) return base;
+        uint32_t d = base / 2 + (uint32_t)base * HOP_CHANNELS * act[channel - 1].rate / (2 * sum);
+        return d < HOP_MIN_DWELL_MS ? HOP_MIN_DWELL_MS : (d > HOP_MAX_DWELL_MS ? HOP_MAX_DWELL_MS : (uint16_t)d);
+    }
+
+    uint8_t current() const { return cur; }
+    const ChannelActivity& at(uint8_t channel) const { return act[channel - 1]; }
+
+private:
+    ChannelActivity act[HOP_CHANNELS];
+    uint8_t cur = 1;
+    uint32_t since = 0;
+    uint32_t dwellFrames = 0;
+    uint32_t dwell = HOP_DWELL_MS;
+    uint16_t base = HOP_DWELL_MS;
+    bool adaptive = true;
+};
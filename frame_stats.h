@@ -0,0 +1,56 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+
+/* ================== 802.11 FRAME HISTOGRAM ================== */
+// One counter per (type, subtype) pair: 64 x uint32 = 256 bytes, indexed
+// straight from the frame control byte, so add() is a single increment with
+// no branches. Cheap enough for the promiscuous callback, though the packet
+// monitor feeds it from the capture ring on the loop() side.
+
+enum FrameCategory : uint8_t {
+    FCAT_BEACON, FCAT_PROBE_REQ, FCAT_PROBE_RESP, FCAT_MGMT,
+    FCAT_DATA, FCAT_QOS_DATA,
+    FCAT_ACK, FCAT_RTS, FCAT_CTS, FCAT_OTHER,
+    FCAT_COUNT
+};
+
+static const char* const FRAME_CATEGORY_LABELS[FCAT_COUNT] = {
+    "BCN", "PRQ", "PRS", "MGT", "DAT", "QOS", "ACK", "RTS", "CTS", "OTH"
+};
+
+// (type << 4 | subtype) -> display category
+static const uint8_t FRAME_CATEGORY_OF[64] = {
+    // mgmt: assoc req/resp, reassoc req/resp, probe req/resp, timing adv, -, beacon, ATIM, disassoc, auth, deauth, action, action no-ack, -
+    FCAT_MGMT, FCAT_MGMT, FCAT_MGMT, FCAT_MGMT, FCAT_PROBE_REQ, FCAT_PROBE_RESP, FCAT_MGMT, FCAT_MGMT,
+    FCAT_BEACON, FCAT_MGMT, FCAT_MGMT, FCAT_MGMT, FCAT_MGMT, FCAT_MGMT, FCAT_MGMT, FCAT_MGMT,
+    // ctrl: 0-6 reserved, wrapper, BAR, BA, PS-Poll, RTS, CTS, ACK, CF-End, CF-End+Ack
+    FCAT_OTHER, FCAT_OTHER, FCAT_OTHER, FCAT_OTHER, FCAT_OTHER, FCAT_OTHER, FCAT_OTHER, FCAT_OTHER,
+    FCAT_OTHER, FCAT_OTHER, FCAT_OTHER, FCAT_RTS, FCAT_CTS, FCAT_ACK, FCAT_OTHER, FCAT_OTHER,
+    // data: 0-7 plain (incl. null), 8-15 QoS (incl. QoS null)
+    FCAT_DATA, FCAT_DATA, FCAT_DATA, FCAT_DATA, FCAT_DATA, FCAT_DATA, FCAT_DATA, FCAT_DATA,
+    FCAT_QOS_DATA, FCAT_QOS_DATA, FCAT_QOS_DATA, FCAT_QOS_DATA, FCAT_QOS_DATA, FCAT_QOS_DATA, FCAT_QOS_DATA, FCAT_QOS_DATA,
+    // extension
+    FCAT_OTHER, FCAT_OTHER, FCAT_OTHER, FCAT_OTHER, FCAT_OTHER, FCAT_OTHER, FCAT_OTHER, FCAT_OTHER,
+    FCAT_OTHER, FCAT_OTHER, FCAT_OTHER, FCAT_OTHER, FCAT_OTHER, FCAT_OTHER, FCAT_OTHER, FCAT_OTHER,
+};
+
+struct FrameStats {
+    uint32_t counts[64];
+    uint32_t total;
+
+    void reset() { memset(this, 0, sizeof(*this)); }
+
+    void add(uint8_t type, uint8_t subtype) {
+        counts[((type & 0x03) << 4) | (subtype & 0x0F)]++;
+        total++;
+    }
+
+    uint32_t get(uint8_t type, uint8_t subtype) const { return counts[((type & 0x03) << 4) | (subtype & 0x0F)]; }
+
+    // Folds the 64 raw counters into the display categories
+    void categories(uint32_t out[FCAT_COUNT]) const {
+        memset(out, 0, sizeof(uint32_t) * FCAT_COUNT);
+        for(int i = 0; i < 64; i++) out[FRAME_CATEGORY_OF[i]] += counts[i];
+    }
+};
@@ -0,0 +1,313 @@
+#include "framebuffer.h"
+#include <esp_heap_caps.h>
+
+#define FB_BYTES (320 * 240 / 2)
+
+static inline bool bitGet(const uint8_t* bits, int i) { return bits[i >> 3] & (1 << (i & 7)); }
+static inline void bitSet(uint8_t* bits, int i) { bits[i >> 3] |= (1 << (i & 7)); }
+
+FrameBufferGFX::FrameBufferGFX(Adafruit_ILI9341& panel)
+    : Adafruit_GFX(ILI9341_TFTWIDTH, ILI9341_TFTHEIGHT), panel(panel) {
+    memset(touched, 0, sizeof(touched));
+    memset(shown, 0, sizeof(shown));
+}
+
+void FrameBufferGFX::begin(uint32_t freq) {
+    panel.begin(freq);
+    fb = (uint8_t*)(psramFound() ? ps_malloc(FB_BYTES) : malloc(FB_BYTES));
+    if(!fb) {
+        Serial.println("[FB] No memory for framebuffer, drawing direct");
+        return;
+    }
+    memset(fb, 0, FB_BYTES);
+    palette[0] = 0x0000; paletteCount = 1;
+    for(int i = 0; i < 2; i++) band[i] = (uint16_t*)heap_caps_malloc(FB_BAND_PX * 2, MALLOC_CAP_DMA);
+    if(!band[0] || !band[1]) {
+        Serial.println("[FB] No DMA memory for bands, drawing direct");
+        heap_caps_free(band[0]); heap_caps_free(band[1]);
+        free(fb); fb = nullptr;
+        return;
+    }
+    beginDma(freq ? freq : FB_SPI_HZ);
+}
+
+// A second device on the bus the panel already drives: the pins are the
+// same, so the library's transfers keep working between ours
+void FrameBufferGFX::beginDma(uint32_t freq) {
+    spi_bus_config_t bus = {};
+    bus.mosi_io_num = FB_SPI_MOSI;
+    bus.miso_io_num = -1;
+    bus.sclk_io_num = FB_SPI_SCK;
+    bus.quadwp_io_num = -1;
+    bus.quadhd_io_num = -1;
+    bus.max_transfer_sz = FB_BAND_PX * 2;
+    spi_device_interface_config_t dev = {};
+    dev.mode = 0;
+    dev.clock_speed_hz = freq;
+    dev.spics_io_num = -1;                   // CS stays with the library
+    dev.flags = SPI_DEVICE_NO_DUMMY;
+    dev.queue_size = 2;
+    if(spi_bus_initialize(FB_SPI_HOST, &bus, SPI_DMA_CH_AUTO) != ESP_OK ||
+       spi_bus_add_device(FB_SPI_HOST, &dev, &dma) != ESP_OK) {
+        Serial.println("[FB] No SPI DMA, pushing bands with writePixels");
+        dma = nullptr;
+    }
+    memset(trans, 0, sizeof(trans));
+}
+
+// Waits for the oldest band on the bus; transfers finish in queue order
+void FrameBufferGFX::reclaimBand() {
+    spi_transaction_t* done;
+    spi_device_get_trans_result(dma, &done, portMAX_DELAY);
+    inFlight--;
+}
+
+void FrameBufferGFX::setRotation(uint8_t r) {
+    Adafruit_GFX::setRotation(r);
+    panel.setRotation(r);
+    memset(shown, 0, sizeof(shown));  // tile grid no longer lines up with the panel
+}
+
+// --- palette ---
+uint8_t FrameBufferGFX::colorIndex(uint16_t color) {
+    if(color == lastColor && lastIndex != 0xFF) return lastIndex;
+    uint8_t idx = 0xFF;
+    for(uint8_t i = 0; i < paletteCount; i++) if(palette[i] == color) { idx = i; break; }
+    if(idx == 0xFF) {
+        if(paletteCount < FB_PALETTE) {
+            idx = paletteCount++;
+            palette[idx] = color;
+        } else {
+            // Out of slots: fold onto the closest entry in RGB565 space.
+            long best = 0x7FFFFFFF;
+            for(uint8_t i = 0; i < FB_PALETTE; i++) {
+                long dr = (long)(color >> 11) - (palette[i] >> 11);
+                long dg = (long)((color >> 5) & 0x3F) - ((palette[i] >> 5) & 0x3F);
+                long db = (long)(color & 0x1F) - (palette[i] & 0x1F);
+                long d = 4 * dr * dr + dg * dg + 4 * db * db;
+                if(d < best) { best = d; idx = i; }
+            }
+            fbStats.paletteMisses++;
+        }
+    }
+    lastColor = color; lastIndex = idx;
+    return idx;
+}
+
+// --- dirty tracking ---
+void FrameBufferGFX::markTiles(int16_t x, int16_t y, int16_t w, int16_t h) {
+    int tx0 = x / FB_TILE, tx1 = (x + w - 1) / FB_TILE;
+    int ty0 = y / FB_TILE, ty1 = (y + h - 1) / FB_TILE;
+    int tilesX = _width / FB_TILE;
+    for(int ty = ty0; ty <= ty1; ty++)
+        for(int tx = tx0; tx <= tx1; tx++) bitSet(touched, ty * tilesX + tx);
+}
+
+uint32_t FrameBufferGFX::tileHash(int tx, int ty) const {
+    uint32_t h = 2166136261u;
+    for(int y = ty * FB_TILE; y < (ty + 1) * FB_TILE; y++) {
+        const uint8_t* row = fb + (y * _width + tx * FB_TILE) / 2;
+        for(int i = 0; i < FB_TILE / 2; i++) {
+            h = (h ^ palette[row[i] >> 4]) * 16777619u;
+            h = (h ^ palette[row[i] & 0x0F]) * 16777619u;
+        }
+    }
+    return h;
+}
+
+// --- primitives ---
+void FrameBufferGFX::fillClipped(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t idx) {
+    if(w < 0) { x += w + 1; w = -w; }
+    if(h < 0) { y += h + 1; h = -h; }
+    if(x >= _width || y >= _height || x + w <= 0 || y + h <= 0) return;
+    if(x < 0) { w += x; x = 0; }
+    if(y < 0) { h += y; y = 0; }
+    if(x + w > _width) w = _width - x;
+    if(y + h > _height) h = _height - y;
+    if(w <= 0 || h <= 0) return;
+
+    uint8_t both = (idx << 4) | idx;
+    for(int16_t j = y; j < y + h; j++) {
+        uint8_t* row = fb + (j * _width) / 2;
+        int16_t i = x, end = x + w;
+        if(i & 1) { row[i >> 1] = (row[i >> 1] & 0xF0) | idx; i++; }
+        if(end - i >= 2) { memset(row + (i >> 1), both, (end - i) >> 1); i += (end - i) & ~1; }
+        if(i < end) row[i >> 1] = (row[i >> 1] & 0x0F) | (idx << 4);
+    }
+    markTiles(x, y, w, h);
+}
+
+void FrameBufferGFX::startWrite() { if(!fb) panel.startWrite(); }
+void FrameBufferGFX::endWrite() { if(!fb) panel.endWrite(); }
+
+void FrameBufferGFX::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    if(!fb) { panel.drawPixel(x, y, color); return; }
+    writePixel(x, y, color);
+}
+
+void FrameBufferGFX::writePixel(int16_t x, int16_t y, uint16_t color) {
+    if(!fb) { panel.writePixel(x, y, color); return; }
+    if(x < 0 || y < 0 || x >= _width || y >= _height) return;
+    uint8_t idx = colorIndex(color);
+    uint8_t& b = fb[(y * _width + x) / 2];
+    b = (x & 1) ? ((b & 0xF0) | idx) : ((b & 0x0F) | (idx << 4));
+    bitSet(touched, (y / FB_TILE) * (_width / FB_TILE) + x / FB_TILE);
+}
+
+void FrameBufferGFX::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if(!fb) { panel.writeFillRect(x, y, w, h, color); return; }
+    fillClipped(x, y, w, h, colorIndex(color));
+}
+
+void FrameBufferGFX::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { writeFillRect(x, y, 1, h, color); }
+void FrameBufferGFX::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { writeFillRect(x, y, w, 1, color); }
+
+void FrameBufferGFX::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    if(!fb) { panel.drawFastVLine(x, y, h, color); return; }
+    writeFillRect(x, y, 1, h, color);
+}
+
+void FrameBufferGFX::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    if(!fb) { panel.drawFastHLine(x, y, w, color); return; }
+    writeFillRect(x, y, w, 1, color);
+}
+
+void FrameBufferGFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if(!fb) { panel.fillRect(x, y, w, h, color); return; }
+    writeFillRect(x, y, w, h, color);
+}
+
+void FrameBufferGFX::fillScreen(uint16_t color) {
+    if(!fb) { panel.fillScreen(color); return; }
+    // The whole screen is one colour afterwards, so the palette can start over.
+    palette[0] = color; paletteCount = 1;
+    lastIndex = 0xFF;
+    memset(fb, 0, FB_BYTES);
+    markTiles(0, 0, _width, _height);
+}
+
+void FrameBufferGFX::drawRGBBitmap(int16_t x, int16_t y, const uint16_t* bitmap, int16_t w, int16_t h) {
+    // Non-const pointer: that overload is the panel's one-window bulk write
+    if(!fb) { panel.drawRGBBitmap(x, y, (uint16_t*)bitmap, w, h); return; }
+    int16_t i0 = x < 0 ? -x : 0, j0 = y < 0 ? -y : 0;
+    int16_t i1 = x + w > _width ? _width - x : w, j1 = y + h > _height ? _height - y : h;
+    if(i0 >= i1 || j0 >= j1) return;
+    // Bitmaps are mostly runs of a few colours (text is two), so remember
+    // the last two lookups rather than searching the palette per pixel.
+    uint16_t c0 = bitmap[j0 * w + i0], c1 = c0;
+    uint8_t x0 = colorIndex(c0), x1 = x0;
+    for(int16_t j = j0; j < j1; j++) {
+        uint8_t* row = fb + ((y + j) * _width) / 2;
+        const uint16_t* src = bitmap + j * w;
+        for(int16_t i = i0; i < i1; i++) {
+            uint16_t c = src[i];
+            uint8_t idx;
+            if(c == c0) idx = x0;
+            else if(c == c1) idx = x1;
+            else { c1 = c0; x1 = x0; c0 = c; x0 = idx = colorIndex(c); }
+            int16_t px = x + i;
+            uint8_t& b = row[px >> 1];
+            b = (px & 1) ? ((b & 0xF0) | idx) : ((b & 0x0F) | (idx << 4));
+        }
+    }
+    markTiles(x + i0, y + j0, i1 - i0, j1 - j0);
+}
+
+/* ================== FLUSH ================== */
+void FrameBufferGFX::pushRegion(int16_t x, int16_t y, int16_t w, int16_t h) {
+    // Tile-aligned, so every row starts on a whole byte: two pixels per byte
+    int16_t rowsPerBand = FB_BAND_PX / w;
+    int cur = 0;
+    panel.startWrite();
+    panel.setAddrWindow(x, y, w, h);
+    for(int16_t j = y; j < y + h; j += rowsPerBand) {
+        int16_t rows = (y + h - j < rowsPerBand) ? y + h - j : rowsPerBand;
+        // Both bands queued: the older one is this one, wait for it
+        if(inFlight == 2) reclaimBand();
+        uint16_t* out = band[cur];
+        for(int16_t r = 0; r < rows; r++) {
+            const uint8_t* src = fb + ((j + r) * _width + x) / 2;
+            for(int16_t i = 0; i < w / 2; i++) {
+                *out++ = wire[src[i] >> 4];
+                *out++ = wire[src[i] & 0x0F];
+            }
+        }
+        if(dma) {
+            trans[cur].length = (uint32_t)w * rows * 16;
+            trans[cur].tx_buffer = band[cur];
+            spi_device_queue_trans(dma, &trans[cur], portMAX_DELAY);
+            inFlight++;
+        } else {
+            panel.writePixels(band[cur], (uint32_t)w * rows, true, true);
+        }
+        cur ^= 1;
+        fbStats.bands++;
+    }
+    while(inFlight) reclaimBand();
+    panel.endWrite();
+    fbStats.regions++;
+    fbStats.pixelsPushed += (uint32_t)w * h;
+}
+
+void FrameBufferGFX::flush() {
+    if(!fb) return;
+    int tilesX = _width / FB_TILE, tilesY = _height / FB_TILE;
+
+    // A tile goes out only if it was drawn to and its content changed.
+    bool anyDirty = false;
+    for(int ty = 0; ty < tilesY; ty++) {
+        for(int tx = 0; tx < tilesX; tx++) {
+            int t = ty * tilesX + tx;
+            if(!bitGet(touched, t)) continue;
+            uint32_t h = tileHash(tx, ty);
+            if(bitGet(shown, t) && shownHash[t] == h) {
+                touched[t >> 3] &= ~(1 << (t & 7));
+                fbStats.tilesSkipped++;
+                continue;
+            }
+            shownHash[t] = h;
+            bitSet(shown, t);
+            anyDirty = true;
+        }
+    }
+    if(!anyDirty) { memset(touched, 0, sizeof(touched)); return; }
+    for(int i = 0; i < paletteCount; i++) wire[i] = (palette[i] << 8) | (palette[i] >> 8);
+
+    // Merge dirty tiles into rectangles: horizontal runs per tile row, grown
+    // downwards while the next row has a run with the same extent.
+    struct Run { int8_t x0, x1, y0, y1; };
+    Run open[FB_TILES_X];
+    int openCount = 0;
+    for(int ty = 0; ty <= tilesY; ty++) {
+        Run rowRuns[FB_TILES_X];
+        int rowCount = 0;
+        for(int tx = 0; ty < tilesY && tx < tilesX; tx++) {
+            if(!bitGet(touched, ty * tilesX + tx)) continue;
+            int start = tx;
+            while(tx + 1 < tilesX && bitGet(touched, ty * tilesX + tx + 1)) tx++;
+            rowRuns[rowCount++] = {(int8_t)start, (int8_t)tx, (int8_t)ty, (int8_t)ty};
+        }
+        Run stillOpen[FB_TILES_X];
+        int stillCount = 0;
+        for(int i = 0; i < openCount; i++) {
+            bool grown = false;
+            for(int j = 0; j < rowCount; j++) {
+                if(rowRuns[j].y0 == ty && rowRuns[j].x0 == open[i].x0 && rowRuns[j].x1 == open[i].x1) {
+                    open[i].y1 = ty;
+                    rowRuns[j].y0 = -1;  // consumed
+                    stillOpen[stillCount++] = open[i];
+                    grown = true;
+                    break;
+                }
+            }
+            if(!grown)
+                pushRegion(open[i].x0 * FB_TILE, open[i].y0 * FB_TILE,
+                           (open[i].x1 - open[i].x0 + 1) * FB_TILE, (open[i].y1 - open[i].y0 + 1) * FB_TILE);
+        }
+        for(int j = 0; j < rowCount; j++) if(rowRuns[j].y0 != -1) stillOpen[stillCount++] = rowRuns[j];
+        memcpy(open, stillOpen, sizeof(Run) * stillCount);
+        openCount = stillCount;
+    }
+    memset(touched, 0, sizeof(touched));
+    fbStats.flushes++;
+}
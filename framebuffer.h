@@ -0,0 +1,91 @@
+#pragma once
+#include <Adafruit_GFX.h>
+#include <Adafruit_ILI9341.h>
+#include <driver/spi_master.h>
+
+/* ================== OFF-SCREEN FRAMEBUFFER ================== */
+// Drop-in replacement for drawing straight to the ILI9341: primitives land in
+// a 4-bit indexed copy of the screen (38.4 KB, PSRAM when fitted) and flush()
+// pushes only the 16x16 tiles whose content differs from what the panel
+// already shows, merged into rectangles and sent as one address window each.
+// If the buffer can't be allocated every call passes through to the panel.
+//
+// A region goes out in bands of FB_BAND_PX pixels under one address window,
+// expanded from the palette straight into bus byte order. Adafruit's
+// writePixels() is synchronous on the ESP32, so the bands go to an esp-idf
+// spi_master device added on the panel's bus instead: while one band is on
+// the bus under DMA the next is expanded into the other, and a band is only
+// refilled once spi_device_get_trans_result() has handed it back. The
+// library still opens the window and holds CS; the DMA device has no CS of
+// its own and only runs between setAddrWindow() and endWrite(). If the bus
+// can't be set up, the bands go through writePixels() one at a time.
+
+#define FB_TILE        16
+#define FB_PALETTE     16
+#define FB_TILES_X     (320 / FB_TILE)
+#define FB_TILES_Y     (240 / FB_TILE)
+#define FB_TILE_COUNT  (FB_TILES_X * FB_TILES_Y)
+#define FB_BAND_PX     2048   // pixels per transfer
+#define FB_SPI_HOST    VSPI_HOST   // the bus Adafruit_ILI9341 uses by default
+#define FB_SPI_SCK     18
+#define FB_SPI_MOSI    23
+#define FB_SPI_HZ      40000000    // Adafruit_ILI9341's default clock on the ESP32
+
+struct FrameBufferStats {
+    uint32_t flushes;
+    uint32_t regions;        // address windows opened by flush()
+    uint32_t tilesSkipped;   // touched but unchanged since the last flush
+    uint32_t pixelsPushed;
+    uint32_t bands;          // transfers handed to the panel
+    uint32_t paletteMisses;  // colours folded onto the nearest palette entry
+};
+
+class FrameBufferGFX : public Adafruit_GFX {
+public:
+    explicit FrameBufferGFX(Adafruit_ILI9341& panel);
+
+    void begin(uint32_t freq = 0);
+    bool active() const { return fb != nullptr; }
+    void flush();
+    const FrameBufferStats& stats() const { return fbStats; }
+
+    void setRotation(uint8_t r) override;
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    void startWrite() override;
+    void endWrite() override;
+    void writePixel(int16_t x, int16_t y, uint16_t color) override;
+    void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+    void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+    void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+    void fillScreen(uint16_t color) override;
+    // Not virtual in Adafruit_GFX: reached through FrameBufferGFX itself (GlyphCache::draw is templated on it)
+    void drawRGBBitmap(int16_t x, int16_t y, const uint16_t* bitmap, int16_t w, int16_t h);
+
+private:
+    uint8_t colorIndex(uint16_t color);
+    void fillClipped(int16_t x, int16_t y, int16_t w, int16_t h, uint8_t idx);
+    void markTiles(int16_t x, int16_t y, int16_t w, int16_t h);
+    uint32_t tileHash(int tx, int ty) const;
+    void pushRegion(int16_t x, int16_t y, int16_t w, int16_t h);
+    void beginDma(uint32_t freq);
+    void reclaimBand();
+
+    Adafruit_ILI9341& panel;
+    uint8_t* fb = nullptr;                  // two pixels per byte, even x in the high nibble
+    uint16_t palette[FB_PALETTE];
+    uint8_t paletteCount = 0;
+    uint16_t lastColor = 0;
+    uint8_t lastIndex = 0xFF;
+    uint8_t touched[(FB_TILE_COUNT + 7) / 8];
+    uint8_t shown[(FB_TILE_COUNT + 7) / 8];  // tile hash below is valid
+    uint32_t shownHash[FB_TILE_COUNT];      // content the panel holds per tile
+    uint16_t* band[2] = {};                 // DMA-capable internal RAM
+    spi_device_handle_t dma = nullptr;      // null: bands go through writePixels()
+    spi_transaction_t trans[2];
+    uint8_t inFlight = 0;                   // queued bands not yet reclaimed
+    uint16_t wire[FB_PALETTE];              // palette byte-swapped into bus order
+    FrameBufferStats fbStats = {};
+};
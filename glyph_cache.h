@@ -0,0 +1,86 @@
+#pragma once
+#include <Adafruit_GFX.h>
+#include <string.h>
+
+/* ================== GLYPH CACHE ================== */
+// Opaque text without the per-pixel path. print() sends every glyph pixel
+// (or 2x2 block at size 2) as its own write, which on the bare panel means
+// one address window each, and callers clear behind it with a fillRect
+// first. begin() renders the library's own font once through drawChar into
+// row masks; draw() expands a whole string in two colours into a line
+// buffer and hands it over as one drawRGBBitmap, a single address window.
+// The pixels match print() with setTextColor(fg, bg), including the
+// spacing column, so it can replace a fillRect + print pair outright.
+
+#define GLYPH_W         6      // 5 font columns + the spacing column print() advances by
+#define GLYPH_H         8
+#define GLYPH_MAX_SIZE  2      // larger sizes go through drawChar
+#define GLYPH_LINE_W    320    // widest run drawn in one write; the rest is clipped
+
+class GlyphCache {
+public:
+    void begin() {
+        Capture cap;
+        for(int c = 0; c < 256; c++) {
+            memset(cap.rows, 0, sizeof(cap.rows));
+            cap.drawChar(0, 0, (unsigned char)c, 1, 1, 1);   // fg == bg: only the lit pixels
+            memcpy(rows[c], cap.rows, GLYPH_H);
+        }
+        // Size 2 doubles every column: 6-bit row mask -> 12-bit
+        for(int m = 0; m < 64; m++) {
+            uint16_t d = 0;
+            for(int b = 0; b < GLYPH_W; b++) if(m & (1 << b)) d |= 3 << (2 * b);
+            doubled[m] = d;
+        }
+        built = true;
+    }
+
+    static int16_t width(const char* s, uint8_t size = 1) { return (int16_t)(strlen(s) * GLYPH_W * size); }
+
+    // Draws s at (x, y) in fg on bg, padded with bg out to at least minW px.
+    // Returns the x just past the text (not the padding), for chaining
+    // differently coloured runs on one line.
+    template <class Display>
+    int16_t draw(Display& gfx, int16_t x, int16_t y, const char* s, uint16_t fg, uint16_t bg, uint8_t size = 1, int16_t minW = 0) {
+        int16_t textW = width(s, size);
+        if(!built || size > GLYPH_MAX_SIZE) {
+            for(const char* c = s; *c; c++) gfx.drawChar(x + (c - s) * GLYPH_W * size, y, *c, fg, bg, size);
+            if(minW > textW) gfx.fillRect(x + textW, y, minW - textW, GLYPH_H * size, bg);
+            return x + textW;
+        }
+        int16_t w = textW > minW ? textW : minW;
+        if(w > GLYPH_LINE_W) w = GLYPH_LINE_W;
+        if(x + w > gfx.width()) w = gfx.width() - x;
+        if(w <= 0) return x + textW;
+
+        int16_t h = GLYPH_H * size, cellW = GLYPH_W * size;
+        for(int16_t j = 0; j < h; j++) {
+            uint16_t* out = line + j * w;
+            int16_t px = 0;
+            for(const char* c = s; *c && px < w; c++) {
+                uint8_t m = rows[(uint8_t)*c][j / size];
+                uint16_t bits = size == 1 ? m : doubled[m];
+                for(int16_t b = 0; b < cellW && px < w; b++, bits >>= 1) out[px++] = (bits & 1) ? fg : bg;
+            }
+            while(px < w) out[px++] = bg;
+        }
+        gfx.drawRGBBitmap(x, y, line, w, h);
+        return x + textW;
+    }
+
+private:
+    // Records what drawChar lights in a single cell
+    class Capture : public Adafruit_GFX {
+    public:
+        Capture() : Adafruit_GFX(GLYPH_W, GLYPH_H) {}
+        void drawPixel(int16_t x, int16_t y, uint16_t color) override {
+            if(color && x >= 0 && x < GLYPH_W && y >= 0 && y < GLYPH_H) rows[y] |= 1 << x;
+        }
+        uint8_t rows[GLYPH_H];
+    };
+
+    uint8_t rows[256][GLYPH_H];      // bit i = column i lit, at size 1
+    uint16_t doubled[64];
+    uint16_t line[GLYPH_LINE_W * GLYPH_H * GLYPH_MAX_SIZE];
+    bool built = false;
+};
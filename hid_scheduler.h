@@ -0,0 +1,92 @@
+#pragma once
+#include <stdint.h>
+#include "capture_ring.h"
+
+/* ================== HID SCHEDULER ================== */
+// Consumer-control key presses for the BLE HID report, without sleeping.
+// The UI task tap()s a usage code and returns immediately; the intake is a
+// single-producer ring, so taps must all come from that one task. The
+// scheduler runs from a timer and turns each request into a press report,
+// holds it for HID_PRESS_MS, sends the release, and waits HID_GAP_MS before
+// the next key, so press/release pairs never interleave and go out in the
+// order they were asked for. Consecutive taps of the same key (a volume
+// burst, or a held button repeating) merge into one queue entry with a
+// count, so a burst doesn't crowd out the keys queued behind it.
+
+#define HID_PRESS_MS   40      // reported down this long
+#define HID_GAP_MS     20      // released this long before the next press
+#define HID_QUEUE_LEN  8       // distinct keys waiting
+#define HID_MAX_BURST  20      // taps one entry can hold
+#define HID_USAGE_MAX  0x28C   // LOGICAL_MAXIMUM of the consumer report in reportMap
+
+// Consumer page (0x0C) usages
+#define HID_USAGE_NEXT       0xB5
+#define HID_USAGE_PREV       0xB6
+#define HID_USAGE_STOP       0xB7
+#define HID_USAGE_PLAY_PAUSE 0xCD
+#define HID_USAGE_MUTE       0xE2
+#define HID_USAGE_VOL_UP     0xE9
+#define HID_USAGE_VOL_DOWN   0xEA
+
+class HidScheduler {
+public:
+    // One producer task only (the UI task). False if the usage isn't in the
+    // report's range or the intake is full.
+    bool tap(uint16_t usage) {
+        if(usage == 0 || usage > HID_USAGE_MAX) return false;
+        return intake.push(usage);
+    }
+
+    // Timer side only. send(usage) writes one report, 0 meaning all keys up.
+    // Returns the ms until service() wants to run again, or -1 when idle.
+    template <class Send>
+    int32_t service(uint32_t now, Send send) {
+        uint16_t usage;
+        while(intake.pop(usage)) enqueue(usage);
+
+        if(state == PRESSED) {
+            if(now - since < HID_PRESS_MS) return HID_PRESS_MS - (now - since);
+            send(0);
+            state = GAP;
+            since = now;
+        }
+        if(state == GAP) {
+            if(now - since < HID_GAP_MS) return HID_GAP_MS - (now - since);
+            state = IDLE;
+        }
+        if(count == 0) return -1;
+
+        Entry& e = queue[head];
+        send(e.usage);
+        reports++;
+        if(--e.repeats == 0) { head = (head + 1) % HID_QUEUE_LEN; count--; }
+        state = PRESSED;
+        since = now;
+        return HID_PRESS_MS;
+    }
+
+    uint32_t pressed() const { return reports; }        // presses sent
+    uint32_t dropped() const { return overflows + intake.dropped(); }
+
+private:
+    struct Entry { uint16_t usage; uint8_t repeats; };
+    enum State : uint8_t { IDLE, PRESSED, GAP };
+
+    void enqueue(uint16_t usage) {
+        if(count) {
+            Entry& tail = queue[(head + count - 1) % HID_QUEUE_LEN];
+            if(tail.usage == usage && tail.repeats < HID_MAX_BURST) { tail.repeats++; return; }
+        }
+        if(count == HID_QUEUE_LEN) { overflows++; return; }
+        queue[(head + count) % HID_QUEUE_LEN] = { usage, 1 };
+        count++;
+    }
+
+    SpscRing<uint16_t, 16> intake;   // tap() -> service()
+    Entry queue[HID_QUEUE_LEN];
+    uint8_t head = 0, count = 0;
+    State state = IDLE;
+    uint32_t since = 0;
+    uint32_t reports = 0;
+    uint32_t overflows = 0;
+};
@@ -0,0 +1,49 @@
+// Host stand-in for Adafruit_ILI9341 (via Adafruit_SPITFT). Every primitive
+// lands in the simulated panel RAM and is costed in SPI bytes.
+#pragma once
+#include "Adafruit_GFX.h"
+#include "SPI.h"
+
+#define ILI9341_TFTWIDTH  240
+#define ILI9341_TFTHEIGHT 320
+
+#define ILI9341_BLACK 0x0000
+#define ILI9341_WHITE 0xFFFF
+
+class Adafruit_ILI9341 : public Adafruit_GFX {
+public:
+    Adafruit_ILI9341(int8_t cs, int8_t dc, int8_t rst = -1);
+    Adafruit_ILI9341(SPIClass* spi, int8_t dc, int8_t cs = -1, int8_t rst = -1);
+
+    void begin(uint32_t freq = 0);
+    void setRotation(uint8_t r) override;
+    void scrollTo(uint16_t y);
+    void setScrollMargins(uint16_t top, uint16_t bottom);
+
+    void drawPixel(int16_t x, int16_t y, uint16_t color) override;
+    void startWrite() override {}
+    void endWrite() override {}
+    void writePixel(int16_t x, int16_t y, uint16_t color) override;
+    void writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+    void writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+    void writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+
+    void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) override;
+    void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) override;
+    void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) override;
+    void fillScreen(uint16_t color) override;
+    // Adafruit_SPITFT's one-window bulk write takes a non-const buffer; const ones go pixel by pixel through the base
+    using Adafruit_GFX::drawRGBBitmap;
+    void drawRGBBitmap(int16_t x, int16_t y, uint16_t* pcolors, int16_t w, int16_t h);
+
+    void setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h);
+    void writePixels(uint16_t* colors, uint32_t len, bool block = true, bool bigEndian = false);
+    void writeColor(uint16_t color, uint32_t len);
+    void pushColor(uint16_t color);
+    void dmaWait() {}
+
+    uint16_t color565(uint8_t r, uint8_t g, uint8_t b) { return ((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3); }
+
+private:
+    bool clip(int16_t& x, int16_t& y, int16_t& w, int16_t& h) const;
+};
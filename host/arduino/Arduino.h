@@ -0,0 +1,86 @@
+// Host stand-in for the ESP32 Arduino core. Time is virtual: millis() and
+// micros() only move when the simulator advances the clock, and delay()
+// advances it instead of sleeping, so runs are deterministic.
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "WString.h"
+#include "Print.h"
+
+using std::abs;
+using std::max;
+using std::min;
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW  0x0
+#define INPUT        0x01
+#define OUTPUT       0x03
+#define INPUT_PULLUP 0x05
+#define RISING  0x01
+#define FALLING 0x02
+#define CHANGE  0x03
+
+#define IRAM_ATTR
+#define PROGMEM
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+long random(long howbig);
+long random(long howsmall, long howbig);
+void randomSeed(unsigned long seed);
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode);
+void detachInterrupt(uint8_t pin);
+#define digitalPinToInterrupt(p) (p)
+
+bool psramFound();
+void* ps_malloc(size_t size);
+
+class HardwareSerial : public Print {
+public:
+    void begin(unsigned long baud) { baudRate = baud; }
+    void end() {}
+    void updateBaudRate(unsigned long baud) { baudRate = baud; }
+    size_t setTxBufferSize(size_t size) { return size; }
+    size_t setRxBufferSize(size_t size) { return size; }
+    int availableForWrite() override { return 1024; }
+    unsigned long baudRate = 0;
+
+    int available();
+    int read();
+    int peek();
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    operator bool() const { return true; }
+};
+extern HardwareSerial Serial;
+
+class EspClass {
+public:
+    uint32_t getFreeHeap();
+    uint32_t getHeapSize();
+    uint32_t getMinFreeHeap();
+    uint32_t getMaxAllocHeap();
+    uint32_t getCpuFreqMHz() { return 240; }
+    uint32_t getCycleCount();
+};
+extern EspClass ESP;
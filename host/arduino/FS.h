@@ -0,0 +1,65 @@
+// Host stand-in for the ESP32 core's fs::FS / fs::File, backed by a real
+// directory (see sim::fsRoot). Paths are absolute inside the mounted
+// filesystem, as on the device.
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "Print.h"
+
+#define FILE_READ   "r"
+#define FILE_WRITE  "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+enum SeekMode { SeekSet = 0, SeekCur = 1, SeekEnd = 2 };
+
+struct FileImpl;
+typedef std::shared_ptr<FileImpl> FileImplPtr;
+
+class File : public Print {
+public:
+    File() {}
+    explicit File(FileImplPtr p) : impl(p) {}
+
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buf, size_t size) override;
+    using Print::write;
+    int available();
+    int read();
+    int peek();
+    size_t read(uint8_t* buf, size_t size);
+    bool seek(uint32_t pos, SeekMode mode = SeekSet);
+    size_t position() const;
+    size_t size() const;
+    void flush() override;
+    void close();
+    bool isDirectory() const;
+    File openNextFile(const char* mode = FILE_READ);
+    const char* path() const;
+    const char* name() const;
+    operator bool() const;
+
+private:
+    FileImplPtr impl;
+};
+
+class FS {
+public:
+    File open(const char* path, const char* mode = FILE_READ, const bool create = false);
+    bool exists(const char* path);
+    bool remove(const char* path);
+    bool rename(const char* from, const char* to);
+    bool mkdir(const char* path);
+    bool rmdir(const char* path);
+};
+
+}  // namespace fs
+
+using fs::FS;
+using fs::File;
+using fs::SeekMode;
+using fs::SeekSet;
+using fs::SeekCur;
+using fs::SeekEnd;
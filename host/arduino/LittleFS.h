@@ -0,0 +1,18 @@
+// Host stand-in for the ESP32 core's LittleFS. The partition is a directory
+// on the host (sim::fsRoot); totalBytes() reports the default 4 MB layout's
+// spiffs partition.
+#pragma once
+#include "FS.h"
+
+namespace fs {
+class LittleFSFS : public FS {
+public:
+    bool begin(bool formatOnFail = false, const char* basePath = "/littlefs", uint8_t maxOpenFiles = 10, const char* partitionLabel = "spiffs");
+    void end();
+    bool format();
+    size_t totalBytes();
+    size_t usedBytes();
+};
+}  // namespace fs
+
+extern fs::LittleFSFS LittleFS;
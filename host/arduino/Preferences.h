@@ -0,0 +1,27 @@
+// Host stand-in for the ESP32 core's Preferences (NVS). Each namespace is a
+// file of key=value lines under sim::fsRoot(), so settings survive between
+// runs that share a --fs directory.
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+class Preferences {
+public:
+    bool begin(const char* name, bool readOnly = false, const char* partitionLabel = nullptr);
+    void end();
+    bool clear();
+    bool remove(const char* key);
+    bool isKey(const char* key);
+
+    size_t putUChar(const char* key, uint8_t value) { return putUInt(key, value) ? 1 : 0; }
+    size_t putUShort(const char* key, uint16_t value) { return putUInt(key, value) ? 2 : 0; }
+    size_t putUInt(const char* key, uint32_t value);
+    uint8_t getUChar(const char* key, uint8_t defaultValue = 0) { return (uint8_t)getUInt(key, defaultValue); }
+    uint16_t getUShort(const char* key, uint16_t defaultValue = 0) { return (uint16_t)getUInt(key, defaultValue); }
+    uint32_t getUInt(const char* key, uint32_t defaultValue = 0);
+
+private:
+    char ns[16] = "";
+    bool open = false;
+    bool readOnly = false;
+};
@@ -0,0 +1,28 @@
+// Host stand-in for the ESP32 SPI driver.
+#pragma once
+#include "Arduino.h"
+
+#define FSPI 1
+#define HSPI 2
+#define VSPI 3
+
+#define SPI_MODE0 0x00
+#define MSBFIRST 1
+
+class SPISettings {
+public:
+    SPISettings(uint32_t clock = 1000000, uint8_t bitOrder = MSBFIRST, uint8_t dataMode = SPI_MODE0) {}
+};
+
+class SPIClass {
+public:
+    explicit SPIClass(uint8_t bus = VSPI) : bus(bus) {}
+    void begin(int8_t sck = -1, int8_t miso = -1, int8_t mosi = -1, int8_t ss = -1) {}
+    void end() {}
+    void beginTransaction(SPISettings) {}
+    void endTransaction() {}
+    uint8_t transfer(uint8_t data) { return 0; }
+    uint16_t transfer16(uint16_t data) { return 0; }
+    uint8_t bus;
+};
+extern SPIClass SPI;
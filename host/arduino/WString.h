@@ -0,0 +1,63 @@
+// Host stand-in for the Arduino String class. Only the surface main.cpp
+// touches is provided; every buffer (re)allocation bumps simStringAllocs so
+// the simulator can report heap churn from String-heavy paths.
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+extern unsigned long simStringAllocs;
+
+class String {
+public:
+    String(const char* s = "") { assign(s, s ? strlen(s) : 0); }
+    String(const String& o) { assign(o.buf, o.len); }
+    String(String&& o) noexcept : buf(o.buf), len(o.len), cap(o.cap) { o.buf = nullptr; o.len = o.cap = 0; }
+    String(const std::string& s) { assign(s.data(), s.size()); }
+    explicit String(char c) { char t[2] = {c, 0}; assign(t, 1); }
+    explicit String(int v, unsigned char base = 10);
+    explicit String(unsigned int v, unsigned char base = 10);
+    explicit String(long v, unsigned char base = 10);
+    explicit String(unsigned long v, unsigned char base = 10);
+    ~String();
+
+    String& operator=(const String& o) { if(this != &o) assign(o.buf, o.len); return *this; }
+    String& operator=(String&& o) noexcept;
+    String& operator=(const char* s) { assign(s, s ? strlen(s) : 0); return *this; }
+
+    String& operator+=(const String& o) { append(o.buf, o.len); return *this; }
+    String& operator+=(const char* s) { append(s, strlen(s)); return *this; }
+    String& operator+=(char c) { append(&c, 1); return *this; }
+    String& operator+=(int v) { return *this += String(v); }
+    bool concat(const String& o) { *this += o; return true; }
+    bool concat(const char* s) { *this += s; return true; }
+
+    bool operator==(const String& o) const { return len == o.len && memcmp(c_str(), o.c_str(), len) == 0; }
+    bool operator==(const char* s) const { return strcmp(c_str(), s) == 0; }
+    bool operator!=(const String& o) const { return !(*this == o); }
+    char operator[](unsigned int i) const { return i < len ? buf[i] : 0; }
+
+    const char* c_str() const { return buf ? buf : ""; }
+    unsigned int length() const { return len; }
+    String substring(unsigned int from) const { return substring(from, len); }
+    String substring(unsigned int from, unsigned int to) const;
+    int indexOf(char c) const;
+    long toInt() const { return strtol(c_str(), nullptr, 10); }
+    void toUpperCase();
+    void trim();
+
+private:
+    void assign(const char* s, size_t n);
+    void append(const char* s, size_t n);
+    bool reserve(size_t n);
+
+    char* buf = nullptr;
+    size_t len = 0;
+    size_t cap = 0;
+};
+
+String operator+(const String& a, const String& b);
+String operator+(const String& a, const char* b);
+String operator+(const char* a, const String& b);
@@ -0,0 +1,32 @@
+// Host stand-in for XPT2046_Touchscreen. Reports the raw 12-bit readings the
+// simulator derives from sim::press().
+#pragma once
+#include "Arduino.h"
+#include "SPI.h"
+
+class TS_Point {
+public:
+    TS_Point() : x(0), y(0), z(0) {}
+    TS_Point(int16_t x, int16_t y, int16_t z) : x(x), y(y), z(z) {}
+    bool operator==(TS_Point p) { return p.x == x && p.y == y && p.z == z; }
+    bool operator!=(TS_Point p) { return !(*this == p); }
+    int16_t x, y, z;
+};
+
+class XPT2046_Touchscreen {
+public:
+    XPT2046_Touchscreen(uint8_t cspin, uint8_t tirq = 255) : csPin(cspin), tirqPin(tirq) {}
+    bool begin(SPIClass& wspi = SPI) { return true; }
+    TS_Point getPoint();
+    bool tirqTouched();
+    bool touched();
+    void readData(uint16_t* x, uint16_t* y, uint8_t* z);
+    bool bufferEmpty() { return true; }
+    uint8_t bufferSize() { return 1; }
+    void setRotation(uint8_t n) { rotation = n % 4; }
+
+    volatile bool isrWake = true;
+
+private:
+    uint8_t csPin, tirqPin, rotation = 1;
+};
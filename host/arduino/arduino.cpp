@@ -0,0 +1,339 @@
+// Arduino core stand-in: virtual clock, String/Print, Serial and ESP.
+#include <cstdarg>
+#include <cstdio>
+#include <deque>
+#include "Arduino.h"
+#include "esp_heap_caps.h"
+#include "esp_timer.h"
+#include "freertos/task.h"
+#include "sim_internal.h"
+
+unsigned long simStringAllocs = 0;
+static long simStringLiveBytes = 0;
+static long simStringLiveBlocks = 0;
+
+HardwareSerial Serial;
+EspClass ESP;
+
+/* ================== CLOCK ================== */
+static unsigned long long simClockUs = 0;
+
+/* ================== ESP_TIMER ================== */
+struct esp_timer {
+    esp_timer_create_args_t args;
+    bool armed;
+    uint64_t dueUs, periodUs;   // periodUs 0 = one-shot
+};
+static std::deque<esp_timer*> simTimers;
+static bool simTimersRunning = false;
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* out) {
+    if(!args || !args->callback || !out) return ESP_ERR_INVALID_ARG;
+    *out = new esp_timer{*args, false, 0, 0};
+    simTimers.push_back(*out);
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t t, uint64_t timeoutUs) {
+    if(t->armed) return ESP_ERR_INVALID_STATE;
+    t->armed = true; t->dueUs = simClockUs + timeoutUs; t->periodUs = 0;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t t, uint64_t periodUs) {
+    if(t->armed) return ESP_ERR_INVALID_STATE;
+    t->armed = true; t->dueUs = simClockUs + periodUs; t->periodUs = periodUs;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t t) {
+    if(!t->armed) return ESP_ERR_INVALID_STATE;
+    t->armed = false;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t t) {
+    if(t->armed) return ESP_ERR_INVALID_STATE;
+    for(auto it = simTimers.begin(); it != simTimers.end(); ++it)
+        if(*it == t) { simTimers.erase(it); break; }
+    delete t;
+    return ESP_OK;
+}
+
+// Callbacks that call delay() advance the clock themselves; they don't
+// re-enter the timer list.
+static void runTimers() {
+    if(simTimersRunning) return;
+    simTimersRunning = true;
+    for(size_t i = 0; i < simTimers.size(); i++) {
+        esp_timer* t = simTimers[i];
+        while(t->armed && t->dueUs <= simClockUs) {
+            if(t->periodUs) t->dueUs += t->periodUs; else t->armed = false;
+            t->args.callback(t->args.arg);
+        }
+    }
+    simTimersRunning = false;
+}
+
+namespace sim {
+unsigned long nowMicros() { return (unsigned long)simClockUs; }
+void deliverRadio(unsigned long long fromUs, unsigned long long toUs);
+
+void advance(unsigned long ms) {
+    for(unsigned long i = 0; i < ms; i++) {
+        unsigned long long from = simClockUs;
+        simClockUs += 1000;
+        deliverRadio(from, simClockUs);
+        runTimers();
+        runTasks();
+    }
+}
+
+unsigned long stringAllocs() { return simStringAllocs; }
+}
+
+unsigned long millis() { return (unsigned long)(simClockUs / 1000); }
+unsigned long micros() { return (unsigned long)simClockUs; }
+// As on target, delay() in a task blocks that task; in loop() it runs the world forward
+void delay(unsigned long ms) { if(sim::inTask()) vTaskDelay(ms); else sim::advance(ms); }
+void delayMicroseconds(unsigned int us) { simClockUs += us; }
+void yield() {}
+
+/* ================== MATH ================== */
+static uint32_t simRandState = 0x1234567;
+
+static uint32_t nextRandom() {
+    simRandState = simRandState * 1664525u + 1013904223u;
+    return simRandState >> 8;
+}
+
+long random(long howbig) { return howbig <= 0 ? 0 : (long)(nextRandom() % (uint32_t)howbig); }
+long random(long howsmall, long howbig) { return howsmall >= howbig ? howsmall : howsmall + random(howbig - howsmall); }
+void randomSeed(unsigned long seed) { if(seed) simRandState = seed; }
+
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    const long run = in_max - in_min;
+    if(run == 0) return -1;
+    return ((x - in_min) * (out_max - out_min)) / run + out_min;
+}
+
+/* ================== PINS ================== */
+// Inputs idle high. The stand-in peripherals drive their own lines through
+// sim::setPin(), which fires an attached interrupt on a matching edge.
+#define SIM_PINS 40
+static bool simPinLow[SIM_PINS];
+static void (*simPinIsr[SIM_PINS])(void);
+static int simPinIsrMode[SIM_PINS];
+
+void pinMode(uint8_t, uint8_t) {}
+void digitalWrite(uint8_t, uint8_t) {}
+int digitalRead(uint8_t pin) { return pin < SIM_PINS && simPinLow[pin] ? LOW : HIGH; }
+void attachInterrupt(uint8_t pin, void (*isr)(void), int mode) {
+    if(pin < SIM_PINS) { simPinIsr[pin] = isr; simPinIsrMode[pin] = mode; }
+}
+void detachInterrupt(uint8_t pin) { if(pin < SIM_PINS) simPinIsr[pin] = nullptr; }
+
+namespace sim {
+void setPin(uint8_t pin, int level) {
+    if(pin >= SIM_PINS) return;
+    int old = simPinLow[pin] ? LOW : HIGH;
+    simPinLow[pin] = (level == LOW);
+    if(old == level || !simPinIsr[pin]) return;
+    int mode = simPinIsrMode[pin];
+    if(mode == CHANGE || (mode == FALLING && level == LOW) || (mode == RISING && level == HIGH)) simPinIsr[pin]();
+}
+}
+bool psramFound() { return false; }
+void* ps_malloc(size_t size) { return malloc(size); }
+
+/* ================== ESP ================== */
+uint32_t EspClass::getFreeHeap() { return 200000 - (uint32_t)simStringLiveBytes; }
+uint32_t EspClass::getHeapSize() { return 327680; }
+uint32_t EspClass::getMinFreeHeap() { return 180000; }
+uint32_t EspClass::getMaxAllocHeap() { return 110592; }
+void heap_caps_get_info(multi_heap_info_t* info, uint32_t) {
+    info->total_free_bytes = ESP.getFreeHeap();
+    info->total_allocated_bytes = ESP.getHeapSize() - info->total_free_bytes;
+    info->largest_free_block = ESP.getMaxAllocHeap();
+    info->minimum_free_bytes = ESP.getMinFreeHeap();
+    info->allocated_blocks = 400 + simStringLiveBlocks;
+    info->free_blocks = 12;
+    info->total_blocks = info->allocated_blocks + info->free_blocks;
+}
+
+void* heap_caps_malloc(size_t size, uint32_t) { return malloc(size); }
+void heap_caps_free(void* ptr) { free(ptr); }
+
+uint32_t EspClass::getCycleCount() { return (uint32_t)(simClockUs * 240); }
+
+/* ================== SERIAL ================== */
+static bool serialEchoOn = false;
+static FILE* serialCaptureFile = nullptr;
+static std::deque<uint8_t> serialRx;
+
+namespace sim {
+void serialEcho(bool on) { serialEchoOn = on; }
+
+bool serialCapture(const char* path) {
+    if(serialCaptureFile) fclose(serialCaptureFile);
+    serialCaptureFile = path ? fopen(path, "wb") : nullptr;
+    return serialCaptureFile != nullptr;
+}
+
+void serialInput(const uint8_t* data, size_t len) { serialRx.insert(serialRx.end(), data, data + len); }
+
+void serialWrite(const uint8_t* data, size_t len) {
+    if(serialEchoOn) fwrite(data, 1, len, stderr);
+    if(serialCaptureFile) { fwrite(data, 1, len, serialCaptureFile); fflush(serialCaptureFile); }
+}
+
+int serialAvailable() { return (int)serialRx.size(); }
+
+int serialRead(bool consume) {
+    if(serialRx.empty()) return -1;
+    int c = serialRx.front();
+    if(consume) serialRx.pop_front();
+    return c;
+}
+}
+
+int HardwareSerial::available() { return sim::serialAvailable(); }
+int HardwareSerial::read() { return sim::serialRead(true); }
+int HardwareSerial::peek() { return sim::serialRead(false); }
+size_t HardwareSerial::write(uint8_t c) { sim::serialWrite(&c, 1); return 1; }
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) { sim::serialWrite(buffer, size); return size; }
+
+/* ================== PRINT ================== */
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while(size--) n += write(*buffer++);
+    return n;
+}
+
+size_t Print::printNumber(unsigned long long n, int base) {
+    char buf[8 * sizeof(n) + 1];
+    char* str = &buf[sizeof(buf) - 1];
+    *str = '\0';
+    if(base < 2) base = 10;
+    do {
+        int d = (int)(n % base);
+        n /= base;
+        *--str = d < 10 ? d + '0' : d + 'A' - 10;
+    } while(n);
+    return write(str);
+}
+
+size_t Print::print(long v, int base) { return print((long long)v, base); }
+size_t Print::print(unsigned long v, int base) { return printNumber(v, base); }
+size_t Print::print(unsigned long long v, int base) { return printNumber(v, base); }
+
+size_t Print::print(long long v, int base) {
+    if(base == 10 && v < 0) return print('-') + printNumber((unsigned long long)(-v), 10);
+    return printNumber((unsigned long long)v, base);
+}
+
+size_t Print::print(double v, int digits) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", digits, v);
+    return write(buf);
+}
+
+size_t Print::printf(const char* fmt, ...) {
+    char buf[256];
+    va_list ap;
+    va_start(ap, fmt);
+    int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+    va_end(ap);
+    if(n < 0) return 0;
+    return write((const uint8_t*)buf, (size_t)n < sizeof(buf) ? (size_t)n : sizeof(buf) - 1);
+}
+
+/* ================== STRING ================== */
+static String fromNumber(unsigned long long v, bool neg, unsigned char base) {
+    char buf[8 * sizeof(v) + 2];
+    char* str = &buf[sizeof(buf) - 1];
+    *str = '\0';
+    do {
+        int d = (int)(v % base);
+        v /= base;
+        *--str = d < 10 ? d + '0' : d + 'a' - 10;
+    } while(v);
+    if(neg) *--str = '-';
+    return String(str);
+}
+
+String::String(int v, unsigned char base) : String(fromNumber(v < 0 && base == 10 ? -(long long)v : (unsigned)v, v < 0 && base == 10, base)) {}
+String::String(unsigned int v, unsigned char base) : String(fromNumber(v, false, base)) {}
+String::String(long v, unsigned char base) : String(fromNumber(v < 0 && base == 10 ? -(long long)v : (unsigned long)v, v < 0 && base == 10, base)) {}
+String::String(unsigned long v, unsigned char base) : String(fromNumber(v, false, base)) {}
+
+String& String::operator=(String&& o) noexcept {
+    if(this != &o) {
+        if(buf) simStringLiveBlocks--;
+        delete[] buf;
+        simStringLiveBytes -= (long)cap;
+        buf = o.buf; len = o.len; cap = o.cap;
+        o.buf = nullptr; o.len = o.cap = 0;
+    }
+    return *this;
+}
+
+bool String::reserve(size_t n) {
+    if(buf && cap >= n) return true;
+    char* nb = new char[n + 1];
+    if(buf) memcpy(nb, buf, len + 1); else { nb[0] = 0; simStringLiveBlocks++; }
+    delete[] buf;
+    simStringLiveBytes += (long)(n - cap);
+    buf = nb; cap = n;
+    simStringAllocs++;
+    return true;
+}
+
+void String::assign(const char* s, size_t n) {
+    reserve(n);
+    if(n) memmove(buf, s, n);
+    buf[n] = 0;
+    len = n;
+}
+
+void String::append(const char* s, size_t n) {
+    if(!n) return;
+    std::string tmp(s, n);  // s may alias buf
+    reserve(len + n);
+    memcpy(buf + len, tmp.data(), n);
+    len += n;
+    buf[len] = 0;
+}
+
+String String::substring(unsigned int from, unsigned int to) const {
+    if(from > to) std::swap(from, to);
+    if(from >= len) return String();
+    if(to > len) to = len;
+    std::string tmp(c_str() + from, to - from);
+    return String(tmp.c_str());
+}
+
+int String::indexOf(char c) const {
+    const char* p = strchr(c_str(), c);
+    return p ? (int)(p - c_str()) : -1;
+}
+
+void String::toUpperCase() { for(size_t i = 0; i < len; i++) if(buf[i] >= 'a' && buf[i] <= 'z') buf[i] -= 32; }
+
+void String::trim() {
+    size_t b = 0, e = len;
+    while(b < e && isspace((unsigned char)buf[b])) b++;
+    while(e > b && isspace((unsigned char)buf[e - 1])) e--;
+    std::string tmp(c_str() + b, e - b);
+    assign(tmp.data(), tmp.size());
+}
+
+String operator+(const String& a, const String& b) { String r(a); r += b; return r; }
+String operator+(const String& a, const char* b) { String r(a); r += b; return r; }
+String operator+(const char* a, const String& b) { String r(a); r += b; return r; }
+
+String::~String() {
+    if(buf) simStringLiveBlocks--;
+    simStringLiveBytes -= (long)cap;
+    delete[] buf;
+}
@@ -0,0 +1,66 @@
+#pragma once
+// Host stand-in for the esp-idf spi_master driver, enough for a write-only
+// DMA device on the panel's bus (see ili9341.cpp). A queued transaction is in
+// flight until spi_device_get_trans_result() hands it back, and its buffer is
+// only read then, so a buffer reused too early reaches the panel wrong.
+#include <cstddef>
+#include <cstdint>
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+
+typedef enum { SPI1_HOST = 0, SPI2_HOST = 1, SPI3_HOST = 2 } spi_host_device_t;
+#define HSPI_HOST SPI2_HOST
+#define VSPI_HOST SPI3_HOST
+
+#define SPI_DMA_DISABLED 0
+#define SPI_DMA_CH_AUTO  3
+
+typedef struct {
+    int mosi_io_num;
+    int miso_io_num;
+    int sclk_io_num;
+    int quadwp_io_num;
+    int quadhd_io_num;
+    int max_transfer_sz;
+    uint32_t flags;
+    int intr_flags;
+} spi_bus_config_t;
+
+typedef struct {
+    uint8_t command_bits;
+    uint8_t address_bits;
+    uint8_t dummy_bits;
+    uint8_t mode;
+    uint16_t duty_cycle_pos;
+    uint16_t cs_ena_pretrans;
+    uint8_t cs_ena_posttrans;
+    int clock_speed_hz;
+    int input_delay_ns;
+    int spics_io_num;
+    uint32_t flags;
+    int queue_size;
+    void (*pre_cb)(struct spi_transaction_t*);
+    void (*post_cb)(struct spi_transaction_t*);
+} spi_device_interface_config_t;
+
+#define SPI_DEVICE_NO_DUMMY (1 << 6)
+
+struct spi_transaction_t {
+    uint32_t flags;
+    uint16_t cmd;
+    uint64_t addr;
+    size_t length;      // bits
+    size_t rxlength;
+    void* user;
+    const void* tx_buffer;
+    void* rx_buffer;
+};
+typedef struct spi_transaction_t spi_transaction_t;
+
+typedef struct spi_device_t* spi_device_handle_t;
+
+esp_err_t spi_bus_initialize(spi_host_device_t host, const spi_bus_config_t* bus, int dmaChan);
+esp_err_t spi_bus_add_device(spi_host_device_t host, const spi_device_interface_config_t* dev, spi_device_handle_t* handle);
+// Fails with ESP_ERR_TIMEOUT once queue_size transactions are outstanding
+esp_err_t spi_device_queue_trans(spi_device_handle_t handle, spi_transaction_t* trans, TickType_t ticks);
+esp_err_t spi_device_get_trans_result(spi_device_handle_t handle, spi_transaction_t** trans, TickType_t ticks);
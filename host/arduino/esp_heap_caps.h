@@ -0,0 +1,24 @@
+#pragma once
+// Host stand-in for esp_heap_caps.h: heap_caps_get_info() and plain
+// malloc/free. The sim heap is modelled as a fixed baseline plus the live
+// String buffers.
+#include <cstddef>
+#include <cstdint>
+
+#define MALLOC_CAP_8BIT    (1 << 2)
+#define MALLOC_CAP_DMA     (1 << 3)
+#define MALLOC_CAP_DEFAULT (1 << 12)
+
+typedef struct {
+    size_t total_free_bytes;
+    size_t total_allocated_bytes;
+    size_t largest_free_block;
+    size_t minimum_free_bytes;
+    size_t allocated_blocks;
+    size_t free_blocks;
+    size_t total_blocks;
+} multi_heap_info_t;
+
+void heap_caps_get_info(multi_heap_info_t* info, uint32_t caps);
+void* heap_caps_malloc(size_t size, uint32_t caps);
+void heap_caps_free(void* ptr);
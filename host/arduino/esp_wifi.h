@@ -0,0 +1,96 @@
+// Host stand-in for the ESP-IDF WiFi driver calls main.cpp uses. Promiscuous
+// frames come from the simulator's traffic model on the current channel.
+#pragma once
+#include <cstdint>
+#include "esp_err.h"
+
+typedef enum { WIFI_MODE_NULL = 0, WIFI_MODE_STA, WIFI_MODE_AP, WIFI_MODE_APSTA, WIFI_MODE_MAX } wifi_mode_t;
+typedef enum { WIFI_IF_STA = 0, WIFI_IF_AP } wifi_interface_t;
+typedef enum { WIFI_SECOND_CHAN_NONE = 0, WIFI_SECOND_CHAN_ABOVE, WIFI_SECOND_CHAN_BELOW } wifi_second_chan_t;
+typedef enum { WIFI_STORAGE_FLASH, WIFI_STORAGE_RAM } wifi_storage_t;
+typedef enum { WIFI_PKT_MGMT, WIFI_PKT_CTRL, WIFI_PKT_DATA, WIFI_PKT_MISC } wifi_promiscuous_pkt_type_t;
+typedef enum {
+    WIFI_AUTH_OPEN = 0, WIFI_AUTH_WEP, WIFI_AUTH_WPA_PSK, WIFI_AUTH_WPA2_PSK, WIFI_AUTH_WPA_WPA2_PSK,
+    WIFI_AUTH_WPA2_ENTERPRISE, WIFI_AUTH_WPA3_PSK, WIFI_AUTH_WPA2_WPA3_PSK, WIFI_AUTH_MAX
+} wifi_auth_mode_t;
+
+typedef struct {
+    signed rssi : 8;
+    unsigned rate : 5;
+    unsigned : 1;
+    unsigned sig_mode : 2;
+    unsigned : 16;
+    unsigned mcs : 7;
+    unsigned cwb : 1;
+    unsigned : 16;
+    unsigned smoothing : 1;
+    unsigned not_sounding : 1;
+    unsigned : 1;
+    unsigned aggregation : 1;
+    unsigned stbc : 2;
+    unsigned fec_coding : 1;
+    unsigned sgi : 1;
+    signed noise_floor : 8;
+    unsigned ampdu_cnt : 8;
+    unsigned channel : 4;
+    unsigned secondary_channel : 4;
+    unsigned : 8;
+    unsigned timestamp : 32;
+    unsigned : 32;
+    unsigned : 31;
+    unsigned ant : 1;
+    unsigned sig_len : 12;
+    unsigned : 12;
+    unsigned rx_state : 8;
+} wifi_pkt_rx_ctrl_t;
+
+typedef struct {
+    wifi_pkt_rx_ctrl_t rx_ctrl;
+    uint8_t payload[0];
+} wifi_promiscuous_pkt_t;
+
+typedef struct {
+    uint32_t filter_mask;
+} wifi_promiscuous_filter_t;
+
+#define WIFI_PROMIS_FILTER_MASK_ALL         (0xFFFFFFFF)
+#define WIFI_PROMIS_FILTER_MASK_MGMT        (1 << 0)
+#define WIFI_PROMIS_FILTER_MASK_CTRL        (1 << 1)
+#define WIFI_PROMIS_FILTER_MASK_DATA        (1 << 2)
+#define WIFI_PROMIS_FILTER_MASK_MISC        (1 << 3)
+
+#define WIFI_PROMIS_CTRL_FILTER_MASK_ALL    (0xFF800000)
+#define WIFI_PROMIS_CTRL_FILTER_MASK_RTS    (1 << 27)
+#define WIFI_PROMIS_CTRL_FILTER_MASK_CTS    (1 << 28)
+#define WIFI_PROMIS_CTRL_FILTER_MASK_ACK    (1 << 29)
+
+typedef struct {
+    uint8_t bssid[6];
+    uint8_t ssid[33];
+    uint8_t primary;
+    wifi_second_chan_t second;
+    int8_t rssi;
+    wifi_auth_mode_t authmode;
+} wifi_ap_record_t;
+
+typedef struct {
+    int magic;
+} wifi_init_config_t;
+#define WIFI_INIT_CONFIG_DEFAULT() { 0x1F2F3F4F }
+
+typedef void (*wifi_promiscuous_cb_t)(void* buf, wifi_promiscuous_pkt_type_t type);
+
+esp_err_t esp_wifi_init(const wifi_init_config_t* config);
+esp_err_t esp_wifi_deinit(void);
+esp_err_t esp_wifi_set_storage(wifi_storage_t storage);
+esp_err_t esp_wifi_set_mode(wifi_mode_t mode);
+esp_err_t esp_wifi_get_mode(wifi_mode_t* mode);
+esp_err_t esp_wifi_start(void);
+esp_err_t esp_wifi_stop(void);
+esp_err_t esp_wifi_set_promiscuous(bool en);
+esp_err_t esp_wifi_set_promiscuous_rx_cb(wifi_promiscuous_cb_t cb);
+esp_err_t esp_wifi_set_promiscuous_filter(const wifi_promiscuous_filter_t* filter);
+esp_err_t esp_wifi_set_promiscuous_ctrl_filter(const wifi_promiscuous_filter_t* filter);
+esp_err_t esp_wifi_set_channel(uint8_t primary, wifi_second_chan_t second);
+esp_err_t esp_wifi_get_channel(uint8_t* primary, wifi_second_chan_t* second);
+esp_err_t esp_wifi_80211_tx(wifi_interface_t ifx, const void* buffer, int len, bool en_sys_seq);
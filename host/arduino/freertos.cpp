@@ -0,0 +1,156 @@
+// FreeRTOS stand-in: cooperative tasks (ucontext) and fixed-size queues.
+// Everything runs on the host's single thread, so a run is deterministic.
+// Tasks are resumed from sim::advance() once per virtual millisecond, after
+// radio delivery and timers. A task that calls sim::advance() itself (a
+// simulated blocking driver call) just burns the time; nothing else is
+// scheduled until it blocks.
+#include <cstdlib>
+#include <cstring>
+#include <ucontext.h>
+#include <vector>
+#include "Arduino.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "sim_internal.h"
+
+#define SIM_TASK_STACK (256 * 1024)
+#define SIM_MAX_TASKS  8
+
+struct SimQueue {
+    UBaseType_t length, itemSize;
+    uint8_t* storage;   // preallocated like the real kernel: no heap traffic per message
+    UBaseType_t head, count;
+};
+
+struct SimTask {
+    ucontext_t ctx;
+    TaskFunction_t fn;
+    void* arg;
+    const char* name;
+    uint32_t stackDepth;
+    char* stack;
+    unsigned long long wakeUs;   // resume at this time...
+    SimQueue* waitRecv;          // ...or as soon as this queue has an item
+    SimQueue* waitSend;          // ...or has room
+    bool dead;
+};
+
+static SimTask* simTasks[SIM_MAX_TASKS];
+static int simTaskCount = 0;
+static SimTask* simCurrent = nullptr;
+static ucontext_t simSchedCtx;
+
+static void taskEntry() {
+    simCurrent->fn(simCurrent->arg);
+    simCurrent->dead = true;   // returning from a task function is a bug on target; just stop it
+    swapcontext(&simCurrent->ctx, &simSchedCtx);
+}
+
+// Gives control back to the scheduler until the wake condition holds
+static void block(unsigned long long wakeUs, SimQueue* recv, SimQueue* send) {
+    SimTask* t = simCurrent;
+    t->wakeUs = wakeUs; t->waitRecv = recv; t->waitSend = send;
+    swapcontext(&t->ctx, &simSchedCtx);
+    t->waitRecv = t->waitSend = nullptr;
+}
+
+static unsigned long long wakeTime(TickType_t ticks) {
+    if(ticks == portMAX_DELAY) return ~0ull;
+    return (unsigned long long)sim::nowMicros() + (unsigned long long)ticks * portTICK_PERIOD_MS * 1000;
+}
+
+namespace sim {
+bool inTask() { return simCurrent != nullptr; }
+
+void runTasks() {
+    if(simCurrent) return;
+    for(int i = 0; i < simTaskCount; i++) {
+        SimTask* t = simTasks[i];
+        if(t->dead) continue;
+        bool ready = sim::nowMicros() >= t->wakeUs
+                  || (t->waitRecv && t->waitRecv->count > 0)
+                  || (t->waitSend && t->waitSend->count < t->waitSend->length);
+        if(!ready) continue;
+        simCurrent = t;
+        swapcontext(&simSchedCtx, &t->ctx);
+        simCurrent = nullptr;
+    }
+}
+}
+
+/* ================== TASKS ================== */
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char* name, uint32_t stackDepth, void* arg,
+                                   UBaseType_t, TaskHandle_t* created, BaseType_t) {
+    if(simTaskCount >= SIM_MAX_TASKS) return pdFAIL;
+    SimTask* t = new SimTask();
+    t->fn = fn; t->arg = arg; t->name = name; t->stackDepth = stackDepth;
+    t->stack = (char*)malloc(SIM_TASK_STACK);
+    getcontext(&t->ctx);
+    t->ctx.uc_stack.ss_sp = t->stack;
+    t->ctx.uc_stack.ss_size = SIM_TASK_STACK;
+    t->ctx.uc_link = nullptr;
+    makecontext(&t->ctx, taskEntry, 0);
+    t->wakeUs = 0;   // first run on the next tick
+    simTasks[simTaskCount++] = t;
+    if(created) *created = t;
+    return pdPASS;
+}
+
+void vTaskDelay(TickType_t ticks) {
+    if(!simCurrent) { sim::advance(ticks * portTICK_PERIOD_MS); return; }
+    block(wakeTime(ticks), nullptr, nullptr);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+    if(task && task != simCurrent) { task->dead = true; return; }
+    if(!simCurrent) return;
+    simCurrent->dead = true;
+    swapcontext(&simCurrent->ctx, &simSchedCtx);
+}
+
+TickType_t xTaskGetTickCount() { return (TickType_t)(sim::nowMicros() / 1000 / portTICK_PERIOD_MS); }
+TaskHandle_t xTaskGetCurrentTaskHandle() { return simCurrent; }
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) { return task ? task->stackDepth : 0; }
+
+/* ================== QUEUES ================== */
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+    if(!length || !itemSize) return nullptr;
+    SimQueue* q = new SimQueue{length, itemSize, (uint8_t*)malloc((size_t)length * itemSize), 0, 0};
+    return q;
+}
+
+// Waits on the clock; from loop() (not a task) that means running the sim forward
+template <class Cond>
+static bool waitFor(Cond ready, TickType_t wait, SimQueue* recv, SimQueue* send) {
+    unsigned long long until = wakeTime(wait);
+    while(!ready()) {
+        if(wait == 0 || sim::nowMicros() >= until) return false;
+        if(simCurrent) block(until, recv, send);
+        else sim::advance(1);
+    }
+    return true;
+}
+
+BaseType_t xQueueSend(QueueHandle_t q, const void* item, TickType_t wait) {
+    if(!waitFor([q] { return q->count < q->length; }, wait, nullptr, q)) return errQUEUE_FULL;
+    memcpy(q->storage + ((q->head + q->count) % q->length) * q->itemSize, item, q->itemSize);
+    q->count++;
+    return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t q, void* item, TickType_t wait) {
+    if(!waitFor([q] { return q->count > 0; }, wait, q, nullptr)) return pdFALSE;
+    memcpy(item, q->storage + q->head * q->itemSize, q->itemSize);
+    q->head = (q->head + 1) % q->length;
+    q->count--;
+    return pdTRUE;
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t q, const void* item) {
+    memcpy(q->storage + q->head * q->itemSize, item, q->itemSize);
+    q->count = 1;
+    return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q) { return q->count; }
@@ -0,0 +1,22 @@
+// Host stand-in for the FreeRTOS kernel as shipped with ESP-IDF. Tasks are
+// cooperative coroutines on the virtual clock: one runs until it blocks
+// (vTaskDelay, or a queue call that has to wait), and sim::advance() resumes
+// whichever are due. Core affinity and priorities are accepted and ignored.
+#pragma once
+#include <cstdint>
+
+typedef uint32_t TickType_t;
+typedef int BaseType_t;
+typedef unsigned UBaseType_t;
+
+#define pdFALSE 0
+#define pdTRUE  1
+#define pdPASS  pdTRUE
+#define pdFAIL  pdFALSE
+#define errQUEUE_FULL 0
+
+#define configTICK_RATE_HZ 1000
+#define portTICK_PERIOD_MS (1000 / configTICK_RATE_HZ)
+#define portMAX_DELAY ((TickType_t)0xFFFFFFFF)
+#define pdMS_TO_TICKS(ms) ((TickType_t)(ms) / portTICK_PERIOD_MS)
+#define tskNO_AFFINITY 0x7FFFFFFF
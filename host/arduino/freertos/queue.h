@@ -0,0 +1,11 @@
+#pragma once
+#include "FreeRTOS.h"
+
+typedef struct SimQueue* QueueHandle_t;
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize);
+BaseType_t xQueueSend(QueueHandle_t q, const void* item, TickType_t wait);
+BaseType_t xQueueReceive(QueueHandle_t q, void* item, TickType_t wait);
+BaseType_t xQueueOverwrite(QueueHandle_t q, const void* item);   // length-1 queues only
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t q);
+#define xQueueSendToBack xQueueSend
@@ -0,0 +1,221 @@
+// File-backed LittleFS and Preferences stand-ins. Everything lives under one
+// host directory: --fs DIR keeps it between runs, otherwise a fresh temp
+// directory is used and removed at exit so runs stay reproducible.
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <ftw.h>
+#include <map>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "FS.h"
+#include "LittleFS.h"
+#include "Preferences.h"
+#include "sim.h"
+
+fs::LittleFSFS LittleFS;
+
+/* ================== ROOT DIRECTORY ================== */
+static std::string fsRootDir;
+static bool fsRootIsTemp = false;
+
+static int removeEntry(const char* path, const struct stat*, int, struct FTW*) { return ::remove(path); }
+static void removeTempRoot() {
+    if(fsRootIsTemp) nftw(fsRootDir.c_str(), removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+}
+
+namespace sim {
+void fsRoot(const char* dir) {
+    fsRootDir = dir;
+    fsRootIsTemp = false;
+    ::mkdir(dir, 0755);
+}
+}
+
+static const std::string& rootDir() {
+    if(fsRootDir.empty()) {
+        char tmpl[] = "/tmp/thinga_fs_XXXXXX";
+        if(!mkdtemp(tmpl)) { perror("mkdtemp"); abort(); }
+        fsRootDir = tmpl;
+        fsRootIsTemp = true;
+        atexit(removeTempRoot);
+    }
+    return fsRootDir;
+}
+
+static std::string hostPath(const char* path) { return rootDir() + (path[0] == '/' ? "" : "/") + path; }
+
+/* ================== FILE ================== */
+namespace fs {
+
+struct FileImpl {
+    std::string path;       // as the firmware named it
+    FILE* fp = nullptr;
+    DIR* dir = nullptr;
+    ~FileImpl() { if(fp) fclose(fp); if(dir) closedir(dir); }
+};
+
+size_t File::write(uint8_t c) { return write(&c, 1); }
+size_t File::write(const uint8_t* buf, size_t size) { return impl && impl->fp ? fwrite(buf, 1, size, impl->fp) : 0; }
+
+int File::available() {
+    if(!impl || !impl->fp) return 0;
+    return (int)(size() - position());
+}
+
+int File::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::peek() {
+    if(!impl || !impl->fp) return -1;
+    int c = fgetc(impl->fp);
+    if(c != EOF) ungetc(c, impl->fp);
+    return c == EOF ? -1 : c;
+}
+
+size_t File::read(uint8_t* buf, size_t size) { return impl && impl->fp ? fread(buf, 1, size, impl->fp) : 0; }
+
+bool File::seek(uint32_t pos, SeekMode mode) {
+    static const int whence[] = { SEEK_SET, SEEK_CUR, SEEK_END };
+    return impl && impl->fp && fseek(impl->fp, (long)pos, whence[mode]) == 0;
+}
+
+size_t File::position() const { return impl && impl->fp ? (size_t)ftell(impl->fp) : 0; }
+
+size_t File::size() const {
+    if(!impl || !impl->fp) return 0;
+    fflush(impl->fp);
+    struct stat st;
+    return fstat(fileno(impl->fp), &st) == 0 ? (size_t)st.st_size : 0;
+}
+
+void File::flush() { if(impl && impl->fp) fflush(impl->fp); }
+void File::close() { impl.reset(); }
+bool File::isDirectory() const { return impl && impl->dir; }
+const char* File::path() const { return impl ? impl->path.c_str() : nullptr; }
+const char* File::name() const {
+    if(!impl) return nullptr;
+    size_t slash = impl->path.rfind('/');
+    return impl->path.c_str() + (slash == std::string::npos ? 0 : slash + 1);
+}
+File::operator bool() const { return impl && (impl->fp || impl->dir); }
+
+File File::openNextFile(const char* mode) {
+    if(!impl || !impl->dir) return File();
+    while(struct dirent* e = readdir(impl->dir)) {
+        if(!strcmp(e->d_name, ".") || !strcmp(e->d_name, "..")) continue;
+        std::string child = impl->path + (impl->path == "/" ? "" : "/") + e->d_name;
+        return LittleFS.open(child.c_str(), mode);
+    }
+    return File();
+}
+
+File FS::open(const char* path, const char* mode, const bool create) {
+    std::string host = hostPath(path);
+    FileImplPtr impl = std::make_shared<FileImpl>();
+    impl->path = path;
+    struct stat st;
+    if(stat(host.c_str(), &st) == 0 && S_ISDIR(st.st_mode)) {
+        impl->dir = opendir(host.c_str());
+        return impl->dir ? File(impl) : File();
+    }
+    const char* m = mode[0] == 'w' ? "wb+" : (mode[0] == 'a' ? "ab+" : "rb");
+    impl->fp = fopen(host.c_str(), m);
+    if(!impl->fp && mode[0] == 'r' && create) impl->fp = fopen(host.c_str(), "wb+");
+    return impl->fp ? File(impl) : File();
+}
+
+bool FS::exists(const char* path) { struct stat st; return stat(hostPath(path).c_str(), &st) == 0; }
+bool FS::remove(const char* path) { return ::unlink(hostPath(path).c_str()) == 0; }
+bool FS::rename(const char* from, const char* to) { return ::rename(hostPath(from).c_str(), hostPath(to).c_str()) == 0; }
+bool FS::mkdir(const char* path) { return ::mkdir(hostPath(path).c_str(), 0755) == 0 || errno == EEXIST; }
+bool FS::rmdir(const char* path) { return ::rmdir(hostPath(path).c_str()) == 0; }
+
+/* ================== LITTLEFS ================== */
+#define SIM_FS_PARTITION_BYTES 0x160000
+
+bool LittleFSFS::begin(bool, const char*, uint8_t, const char*) { rootDir(); return true; }
+void LittleFSFS::end() {}
+
+bool LittleFSFS::format() {
+    nftw(rootDir().c_str(), removeEntry, 16, FTW_DEPTH | FTW_PHYS);
+    return ::mkdir(rootDir().c_str(), 0755) == 0;
+}
+
+size_t LittleFSFS::totalBytes() { return SIM_FS_PARTITION_BYTES; }
+
+static size_t usedTotal = 0;
+static int addUsed(const char*, const struct stat* st, int type, struct FTW*) {
+    if(type == FTW_F) usedTotal += ((size_t)st->st_size + 4095) / 4096 * 4096;   // whole 4 KB blocks
+    return 0;
+}
+size_t LittleFSFS::usedBytes() {
+    usedTotal = 0;
+    nftw(rootDir().c_str(), addUsed, 16, FTW_PHYS);
+    return usedTotal;
+}
+
+}  // namespace fs
+
+/* ================== PREFERENCES ================== */
+static std::string prefsPath(const char* ns) { return hostPath("/.nvs/") + ns; }
+
+static std::map<std::string, uint32_t> prefsLoad(const char* ns) {
+    std::map<std::string, uint32_t> kv;
+    FILE* f = fopen(prefsPath(ns).c_str(), "r");
+    if(!f) return kv;
+    char key[32];
+    unsigned long value;
+    while(fscanf(f, "%31[^=]=%lu\n", key, &value) == 2) kv[key] = (uint32_t)value;
+    fclose(f);
+    return kv;
+}
+
+static bool prefsSave(const char* ns, const std::map<std::string, uint32_t>& kv) {
+    ::mkdir(hostPath("/.nvs").c_str(), 0755);
+    FILE* f = fopen(prefsPath(ns).c_str(), "w");
+    if(!f) return false;
+    for(const auto& e : kv) fprintf(f, "%s=%lu\n", e.first.c_str(), (unsigned long)e.second);
+    fclose(f);
+    return true;
+}
+
+bool Preferences::begin(const char* name, bool ro, const char*) {
+    if(strlen(name) >= sizeof(ns)) return false;   // NVS namespaces are at most 15 chars
+    strcpy(ns, name);
+    readOnly = ro;
+    open = true;
+    return true;
+}
+
+void Preferences::end() { open = false; }
+
+bool Preferences::clear() { return open && !readOnly && prefsSave(ns, {}); }
+
+bool Preferences::remove(const char* key) {
+    if(!open || readOnly) return false;
+    auto kv = prefsLoad(ns);
+    if(!kv.erase(key)) return false;
+    return prefsSave(ns, kv);
+}
+
+bool Preferences::isKey(const char* key) { return open && prefsLoad(ns).count(key); }
+
+size_t Preferences::putUInt(const char* key, uint32_t value) {
+    if(!open || readOnly) return 0;
+    auto kv = prefsLoad(ns);
+    kv[key] = value;
+    return prefsSave(ns, kv) ? 4 : 0;
+}
+
+uint32_t Preferences::getUInt(const char* key, uint32_t defaultValue) {
+    if(!open) return defaultValue;
+    auto kv = prefsLoad(ns);
+    auto it = kv.find(key);
+    return it == kv.end() ? defaultValue : it->second;
+}
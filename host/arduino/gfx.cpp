@@ -0,0 +1,284 @@
+// Adafruit_GFX stand-in: the library's generic primitives and text path.
+#include "Adafruit_GFX.h"
+#include "sim_internal.h"
+
+// Classic 5x7 GFX font, printable ASCII only (0x20..0x7E). Column-major,
+// LSB at the top; anything outside the range renders blank.
+static const uint8_t font5x7[95][5] = {
+    {0x00,0x00,0x00,0x00,0x00}, {0x00,0x00,0x5F,0x00,0x00}, {0x00,0x07,0x00,0x07,0x00}, {0x14,0x7F,0x14,0x7F,0x14},
+    {0x24,0x2A,0x7F,0x2A,0x12}, {0x23,0x13,0x08,0x64,0x62}, {0x36,0x49,0x56,0x20,0x50}, {0x00,0x08,0x07,0x03,0x00},
+    {0x00,0x1C,0x22,0x41,0x00}, {0x00,0x41,0x22,0x1C,0x00}, {0x2A,0x1C,0x7F,0x1C,0x2A}, {0x08,0x08,0x3E,0x08,0x08},
+    {0x00,0x80,0x70,0x30,0x00}, {0x08,0x08,0x08,0x08,0x08}, {0x00,0x00,0x60,0x60,0x00}, {0x20,0x10,0x08,0x04,0x02},
+    {0x3E,0x51,0x49,0x45,0x3E}, {0x00,0x42,0x7F,0x40,0x00}, {0x72,0x49,0x49,0x49,0x46}, {0x21,0x41,0x49,0x4D,0x33},
+    {0x18,0x14,0x12,0x7F,0x10}, {0x27,0x45,0x45,0x45,0x39}, {0x3C,0x4A,0x49,0x49,0x31}, {0x41,0x21,0x11,0x09,0x07},
+    {0x36,0x49,0x49,0x49,0x36}, {0x46,0x49,0x49,0x29,0x1E}, {0x00,0x00,0x14,0x00,0x00}, {0x00,0x40,0x34,0x00,0x00},
+    {0x00,0x08,0x14,0x22,0x41}, {0x14,0x14,0x14,0x14,0x14}, {0x00,0x41,0x22,0x14,0x08}, {0x02,0x01,0x59,0x09,0x06},
+    {0x3E,0x41,0x5D,0x59,0x4E}, {0x7C,0x12,0x11,0x12,0x7C}, {0x7F,0x49,0x49,0x49,0x36}, {0x3E,0x41,0x41,0x41,0x22},
+    {0x7F,0x41,0x41,0x41,0x3E}, {0x7F,0x49,0x49,0x49,0x41}, {0x7F,0x09,0x09,0x09,0x01}, {0x3E,0x41,0x41,0x51,0x73},
+    {0x7F,0x08,0x08,0x08,0x7F}, {0x00,0x41,0x7F,0x41,0x00}, {0x20,0x40,0x41,0x3F,0x01}, {0x7F,0x08,0x14,0x22,0x41},
+    {0x7F,0x40,0x40,0x40,0x40}, {0x7F,0x02,0x1C,0x02,0x7F}, {0x7F,0x04,0x08,0x10,0x7F}, {0x3E,0x41,0x41,0x41,0x3E},
+    {0x7F,0x09,0x09,0x09,0x06}, {0x3E,0x41,0x51,0x21,0x5E}, {0x7F,0x09,0x19,0x29,0x46}, {0x26,0x49,0x49,0x49,0x32},
+    {0x03,0x01,0x7F,0x01,0x03}, {0x3F,0x40,0x40,0x40,0x3F}, {0x1F,0x20,0x40,0x20,0x1F}, {0x3F,0x40,0x38,0x40,0x3F},
+    {0x63,0x14,0x08,0x14,0x63}, {0x03,0x04,0x78,0x04,0x03}, {0x61,0x59,0x49,0x4D,0x43}, {0x00,0x7F,0x41,0x41,0x41},
+    {0x02,0x04,0x08,0x10,0x20}, {0x00,0x41,0x41,0x41,0x7F}, {0x04,0x02,0x01,0x02,0x04}, {0x40,0x40,0x40,0x40,0x40},
+    {0x00,0x03,0x07,0x08,0x00}, {0x20,0x54,0x54,0x78,0x40}, {0x7F,0x28,0x44,0x44,0x38}, {0x38,0x44,0x44,0x44,0x28},
+    {0x38,0x44,0x44,0x28,0x7F}, {0x38,0x54,0x54,0x54,0x18}, {0x00,0x08,0x7E,0x09,0x02}, {0x18,0xA4,0xA4,0x9C,0x78},
+    {0x7F,0x08,0x04,0x04,0x78}, {0x00,0x44,0x7D,0x40,0x00}, {0x20,0x40,0x40,0x3D,0x00}, {0x7F,0x10,0x28,0x44,0x00},
+    {0x00,0x41,0x7F,0x40,0x00}, {0x7C,0x04,0x78,0x04,0x78}, {0x7C,0x08,0x04,0x04,0x78}, {0x38,0x44,0x44,0x44,0x38},
+    {0xFC,0x18,0x24,0x24,0x18}, {0x18,0x24,0x24,0x18,0xFC}, {0x7C,0x08,0x04,0x04,0x08}, {0x48,0x54,0x54,0x54,0x24},
+    {0x04,0x04,0x3F,0x44,0x24}, {0x3C,0x40,0x40,0x20,0x7C}, {0x1C,0x20,0x40,0x20,0x1C}, {0x3C,0x40,0x30,0x40,0x3C},
+    {0x44,0x28,0x10,0x28,0x44}, {0x4C,0x90,0x90,0x90,0x7C}, {0x44,0x64,0x54,0x4C,0x44}, {0x00,0x08,0x36,0x41,0x00},
+    {0x00,0x00,0x77,0x00,0x00}, {0x00,0x41,0x36,0x08,0x00}, {0x02,0x01,0x02,0x04,0x02},
+};
+
+template <typename T> static void swapv(T& a, T& b) { T t = a; a = b; b = t; }
+
+Adafruit_GFX::Adafruit_GFX(int16_t w, int16_t h) : WIDTH(w), HEIGHT(h), _width(w), _height(h) {}
+
+void Adafruit_GFX::setRotation(uint8_t r) {
+    rotation = r & 3;
+    if(rotation & 1) { _width = HEIGHT; _height = WIDTH; }
+    else { _width = WIDTH; _height = HEIGHT; }
+}
+
+void Adafruit_GFX::writeLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    bool steep = abs(y1 - y0) > abs(x1 - x0);
+    if(steep) { swapv(x0, y0); swapv(x1, y1); }
+    if(x0 > x1) { swapv(x0, x1); swapv(y0, y1); }
+    int16_t dx = x1 - x0, dy = abs(y1 - y0);
+    int16_t err = dx / 2;
+    int16_t ystep = (y0 < y1) ? 1 : -1;
+    for(; x0 <= x1; x0++) {
+        if(steep) writePixel(y0, x0, color); else writePixel(x0, y0, color);
+        err -= dy;
+        if(err < 0) { y0 += ystep; err += dx; }
+    }
+}
+
+void Adafruit_GFX::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    sim::CallScope s("drawFastVLine", x, y, 1, h);
+    startWrite(); writeLine(x, y, x, y + h - 1, color); endWrite();
+}
+
+void Adafruit_GFX::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    sim::CallScope s("drawFastHLine", x, y, w, 1);
+    startWrite(); writeLine(x, y, x + w - 1, y, color); endWrite();
+}
+
+void Adafruit_GFX::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    sim::CallScope s("fillRect", x, y, w, h);
+    startWrite();
+    for(int16_t i = x; i < x + w; i++) writeFastVLine(i, y, h, color);
+    endWrite();
+}
+
+void Adafruit_GFX::fillScreen(uint16_t color) {
+    sim::CallScope s("fillScreen", 0, 0, _width, _height);
+    fillRect(0, 0, _width, _height, color);
+}
+
+void Adafruit_GFX::drawLine(int16_t x0, int16_t y0, int16_t x1, int16_t y1, uint16_t color) {
+    sim::CallScope s("drawLine", x0, y0, x1 - x0, y1 - y0);
+    if(x0 == x1) {
+        if(y0 > y1) swapv(y0, y1);
+        drawFastVLine(x0, y0, y1 - y0 + 1, color);
+    } else if(y0 == y1) {
+        if(x0 > x1) swapv(x0, x1);
+        drawFastHLine(x0, y0, x1 - x0 + 1, color);
+    } else {
+        startWrite(); writeLine(x0, y0, x1, y1, color); endWrite();
+    }
+}
+
+void Adafruit_GFX::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    sim::CallScope s("drawRect", x, y, w, h);
+    startWrite();
+    writeFastHLine(x, y, w, color);
+    writeFastHLine(x, y + h - 1, w, color);
+    writeFastVLine(x, y, h, color);
+    writeFastVLine(x + w - 1, y, h, color);
+    endWrite();
+}
+
+void Adafruit_GFX::drawCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    sim::CallScope s("drawCircle", x0 - r, y0 - r, 2 * r + 1, 2 * r + 1);
+    int16_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r;
+    startWrite();
+    writePixel(x0, y0 + r, color); writePixel(x0, y0 - r, color);
+    writePixel(x0 + r, y0, color); writePixel(x0 - r, y0, color);
+    while(x < y) {
+        if(f >= 0) { y--; ddF_y += 2; f += ddF_y; }
+        x++; ddF_x += 2; f += ddF_x;
+        writePixel(x0 + x, y0 + y, color); writePixel(x0 - x, y0 + y, color);
+        writePixel(x0 + x, y0 - y, color); writePixel(x0 - x, y0 - y, color);
+        writePixel(x0 + y, y0 + x, color); writePixel(x0 - y, y0 + x, color);
+        writePixel(x0 + y, y0 - x, color); writePixel(x0 - y, y0 - x, color);
+    }
+    endWrite();
+}
+
+void Adafruit_GFX::drawCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t cornername, uint16_t color) {
+    int16_t f = 1 - r, ddF_x = 1, ddF_y = -2 * r, x = 0, y = r;
+    while(x < y) {
+        if(f >= 0) { y--; ddF_y += 2; f += ddF_y; }
+        x++; ddF_x += 2; f += ddF_x;
+        if(cornername & 0x4) { writePixel(x0 + x, y0 + y, color); writePixel(x0 + y, y0 + x, color); }
+        if(cornername & 0x2) { writePixel(x0 + x, y0 - y, color); writePixel(x0 + y, y0 - x, color); }
+        if(cornername & 0x8) { writePixel(x0 - y, y0 + x, color); writePixel(x0 - x, y0 + y, color); }
+        if(cornername & 0x1) { writePixel(x0 - y, y0 - x, color); writePixel(x0 - x, y0 - y, color); }
+    }
+}
+
+void Adafruit_GFX::fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+    sim::CallScope s("fillCircle", x0 - r, y0 - r, 2 * r + 1, 2 * r + 1);
+    startWrite();
+    writeFastVLine(x0, y0 - r, 2 * r + 1, color);
+    fillCircleHelper(x0, y0, r, 3, 0, color);
+    endWrite();
+}
+
+void Adafruit_GFX::fillCircleHelper(int16_t x0, int16_t y0, int16_t r, uint8_t corners, int16_t delta, uint16_t color) {
+    int16_t f = 1 - r, ddF_x = 1, ddF_y = -r - r, x = 0, y = r, px = x, py = y;
+    delta++;
+    while(x < y) {
+        if(f >= 0) { y--; ddF_y += 2; f += ddF_y; }
+        x++; ddF_x += 2; f += ddF_x;
+        if(x < (y + 1)) {
+            if(corners & 1) writeFastVLine(x0 + x, y0 - y, 2 * y + delta, color);
+            if(corners & 2) writeFastVLine(x0 - x, y0 - y, 2 * y + delta, color);
+        }
+        if(y != py) {
+            if(corners & 1) writeFastVLine(x0 + py, y0 - px, 2 * px + delta, color);
+            if(corners & 2) writeFastVLine(x0 - py, y0 - px, 2 * px + delta, color);
+            py = y;
+        }
+        px = x;
+    }
+}
+
+void Adafruit_GFX::drawTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color) {
+    sim::CallScope s("drawTriangle", x0, y0, 0, 0);
+    drawLine(x0, y0, x1, y1, color);
+    drawLine(x1, y1, x2, y2, color);
+    drawLine(x2, y2, x0, y0, color);
+}
+
+void Adafruit_GFX::fillTriangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint16_t color) {
+    sim::CallScope s("fillTriangle", x0, y0, 0, 0);
+    int16_t a, b, y, last;
+    if(y0 > y1) { swapv(y0, y1); swapv(x0, x1); }
+    if(y1 > y2) { swapv(y2, y1); swapv(x2, x1); }
+    if(y0 > y1) { swapv(y0, y1); swapv(x0, x1); }
+
+    startWrite();
+    if(y0 == y2) {
+        a = b = x0;
+        if(x1 < a) a = x1; else if(x1 > b) b = x1;
+        if(x2 < a) a = x2; else if(x2 > b) b = x2;
+        writeFastHLine(a, y0, b - a + 1, color);
+        endWrite();
+        return;
+    }
+
+    int16_t dx01 = x1 - x0, dy01 = y1 - y0, dx02 = x2 - x0, dy02 = y2 - y0, dx12 = x2 - x1, dy12 = y2 - y1;
+    int32_t sa = 0, sb = 0;
+    last = (y1 == y2) ? y1 : y1 - 1;
+    for(y = y0; y <= last; y++) {
+        a = x0 + sa / dy01; b = x0 + sb / dy02;
+        sa += dx01; sb += dx02;
+        if(a > b) swapv(a, b);
+        writeFastHLine(a, y, b - a + 1, color);
+    }
+    sa = (int32_t)dx12 * (y - y1);
+    sb = (int32_t)dx02 * (y - y0);
+    for(; y <= y2; y++) {
+        a = x1 + sa / dy12; b = x0 + sb / dy02;
+        sa += dx12; sb += dx02;
+        if(a > b) swapv(a, b);
+        writeFastHLine(a, y, b - a + 1, color);
+    }
+    endWrite();
+}
+
+void Adafruit_GFX::drawRoundRect(int16_t x, int16_t y, int16_t w, int16_t h, int16_t r, uint16_t color) {
+    sim::CallScope s("drawRoundRect", x, y, w, h);
+    int16_t max_radius = ((w < h) ? w : h) / 2;
+    if(r > max_radius) r = max_radius;
+    startWrite();
+    writeFastHLine(x + r, y, w - 2 * r, color);
+    writeFastHLine(x + r, y + h - 1, w - 2 * r, color);
+    writeFastVLine(x, y + r, h - 2 * r, color);
+    writeFastVLine(x + w - 1, y + r, h - 2 * r, color);
+    drawCircleHelper(x + r, y + r, r, 1, color);
+    drawCircleHelper(x + w - r - 1, y + r, r, 2, color);
+    drawCircleHelper(x + w - r - 1, y + h - r - 1, r, 4, color);
+    drawCircleHelper(x + r, y + h - r - 1, r, 8, color);
+    endWrite();
+}
+
+void Adafruit_GFX::drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap, int16_t w, int16_t h, uint16_t color, uint16_t bg) {
+    sim::CallScope s("drawBitmap", x, y, w, h);
+    int16_t byteWidth = (w + 7) / 8;
+    uint8_t b = 0;
+    startWrite();
+    for(int16_t j = 0; j < h; j++, y++) {
+        for(int16_t i = 0; i < w; i++) {
+            if(i & 7) b <<= 1; else b = bitmap[j * byteWidth + i / 8];
+            writePixel(x + i, y, (b & 0x80) ? color : bg);
+        }
+    }
+    endWrite();
+}
+
+void Adafruit_GFX::drawRGBBitmap(int16_t x, int16_t y, const uint16_t bitmap[], int16_t w, int16_t h) {
+    sim::CallScope s("drawRGBBitmap", x, y, w, h);
+    startWrite();
+    for(int16_t j = 0; j < h; j++, y++)
+        for(int16_t i = 0; i < w; i++) writePixel(x + i, y, bitmap[j * w + i]);
+    endWrite();
+}
+
+void Adafruit_GFX::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size) {
+    if((x >= _width) || (y >= _height) || ((x + 6 * size - 1) < 0) || ((y + 8 * size - 1) < 0)) return;
+    const uint8_t* glyph = (c >= 0x20 && c <= 0x7E) ? font5x7[c - 0x20] : font5x7[0];
+    startWrite();
+    for(int8_t i = 0; i < 5; i++) {
+        uint8_t line = glyph[i];
+        for(int8_t j = 0; j < 8; j++, line >>= 1) {
+            if(line & 1) {
+                if(size == 1) writePixel(x + i, y + j, color);
+                else writeFillRect(x + i * size, y + j * size, size, size, color);
+            } else if(bg != color) {
+                if(size == 1) writePixel(x + i, y + j, bg);
+                else writeFillRect(x + i * size, y + j * size, size, size, bg);
+            }
+        }
+    }
+    if(bg != color) {
+        if(size == 1) writeFastVLine(x + 5, y, 8, bg);
+        else writeFillRect(x + 5 * size, y, size, 8 * size, bg);
+    }
+    endWrite();
+}
+
+size_t Adafruit_GFX::write(uint8_t c) {
+    sim::CallScope s("print", cursor_x, cursor_y, 6 * textsize_x, 8 * textsize_y);
+    if(c == '\n') {
+        cursor_x = 0;
+        cursor_y += textsize_y * 8;
+    } else if(c != '\r') {
+        if(wrap && ((cursor_x + textsize_x * 6) > _width)) {
+            cursor_x = 0;
+            cursor_y += textsize_y * 8;
+        }
+        drawChar(cursor_x, cursor_y, c, textcolor, textbgcolor, textsize_x);
+        cursor_x += textsize_x * 6;
+    }
+    return 1;
+}
+
+size_t Adafruit_GFX::write(const uint8_t* buffer, size_t size) {
+    sim::CallScope s("print", cursor_x, cursor_y, (int)size * 6 * textsize_x, 8 * textsize_y);
+    for(size_t i = 0; i < size; i++) write(buffer[i]);
+    return size;
+}
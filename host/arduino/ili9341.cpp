@@ -0,0 +1,277 @@
+// Adafruit_ILI9341 stand-in and the panel RAM model behind it.
+#include <cstdio>
+#include <deque>
+#include <vector>
+#include "Adafruit_ILI9341.h"
+#include "driver/spi_master.h"
+#include "sim_internal.h"
+
+SPIClass SPI(VSPI);
+
+/* ================== PANEL MODEL ================== */
+namespace {
+struct Panel {
+    int w = ILI9341_TFTWIDTH, h = ILI9341_TFTHEIGHT;
+    std::vector<uint16_t> ram = std::vector<uint16_t>(ILI9341_TFTWIDTH * ILI9341_TFTHEIGHT, 0);
+    int wx = 0, wy = 0, ww = 0, wh = 0;  // current address window
+    int cx = 0, cy = 0;                  // write cursor inside it
+    sim::DrawStats stats;
+    int depth = 0;
+    sim::DrawStats callStart;
+    sim::DrawCall pending;
+    bool trace = false;
+    std::vector<sim::DrawCall> calls;
+    // spi_master transactions queued on the panel's bus and not yet
+    // reclaimed; their pixels go into RAM when they are
+    std::deque<spi_transaction_t*> queued;
+};
+Panel P;
+
+inline void store(uint16_t c) {
+    if(P.ww <= 0 || P.wh <= 0) return;
+    int x = P.wx + P.cx, y = P.wy + P.cy;
+    if(x >= 0 && x < P.w && y >= 0 && y < P.h) P.ram[y * P.w + x] = c;
+    if(++P.cx >= P.ww) { P.cx = 0; if(++P.cy >= P.wh) P.cy = 0; }
+}
+
+// The library's own traffic can't share the bus with a queued transfer;
+// reaching here with one outstanding is a missing reclaim in the caller
+inline void busIdle(const char* by) {
+    if(P.queued.empty()) return;
+    fprintf(stderr, "[sim] %s while %zu spi_master transfer(s) are in flight\n", by, P.queued.size());
+    while(!P.queued.empty()) {
+        spi_transaction_t* t = nullptr;
+        spi_device_get_trans_result(nullptr, &t, 0);
+    }
+}
+}
+
+namespace sim {
+namespace panel {
+void setSize(int w, int h) {
+    if(w == P.w && h == P.h) return;
+    P.w = w; P.h = h;
+    P.ram.assign(w * h, 0);
+}
+
+void openWindow(int x, int y, int w, int h) {
+    busIdle("address window");
+    P.wx = x; P.wy = y; P.ww = w; P.wh = h; P.cx = P.cy = 0;
+    P.stats.windows++;
+    P.stats.spiBytes += 11;  // CASET + 4, RASET + 4, RAMWR
+}
+
+void pushColor(uint16_t color, uint32_t count) {
+    busIdle("fill");
+    P.stats.pixels += count;
+    P.stats.spiBytes += 2ull * count;
+    for(uint32_t i = 0; i < count; i++) store(color);
+}
+
+void pushPixels(const uint16_t* colors, uint32_t count, bool bigEndian) {
+    busIdle("pixels");
+    P.stats.pixels += count;
+    P.stats.spiBytes += 2ull * count;
+    for(uint32_t i = 0; i < count; i++) store(bigEndian ? (uint16_t)(colors[i] << 8 | colors[i] >> 8) : colors[i]);
+}
+
+void commandBytes(uint32_t n) { busIdle("command"); P.stats.spiBytes += n; }
+}
+
+CallScope::CallScope(const char* op, int x, int y, int w, int h) : outer(P.depth++ == 0) {
+    if(!outer) return;
+    P.callStart = P.stats;
+    P.pending = {op, (int16_t)x, (int16_t)y, (int16_t)w, (int16_t)h, 0, 0};
+}
+
+CallScope::~CallScope() {
+    P.depth--;
+    if(!outer) return;
+    P.stats.calls++;
+    if(P.trace) {
+        P.pending.pixels = (uint32_t)(P.stats.pixels - P.callStart.pixels);
+        P.pending.spiBytes = (uint32_t)(P.stats.spiBytes - P.callStart.spiBytes);
+        P.calls.push_back(P.pending);
+    }
+}
+
+DrawStats drawStats() { return P.stats; }
+
+DrawStats operator-(const DrawStats& a, const DrawStats& b) {
+    DrawStats d;
+    d.calls = a.calls - b.calls;
+    d.windows = a.windows - b.windows;
+    d.pixels = a.pixels - b.pixels;
+    d.spiBytes = a.spiBytes - b.spiBytes;
+    return d;
+}
+
+void traceDrawCalls(bool on) { P.trace = on; }
+const std::vector<DrawCall>& drawCalls() { return P.calls; }
+void clearDrawCalls() { P.calls.clear(); }
+
+int panelWidth() { return P.w; }
+int panelHeight() { return P.h; }
+uint16_t panelPixel(int x, int y) { return (x >= 0 && x < P.w && y >= 0 && y < P.h) ? P.ram[y * P.w + x] : 0; }
+
+uint32_t panelChecksum() {
+    uint32_t h = 2166136261u;
+    for(uint16_t c : P.ram) { h = (h ^ (c & 0xFF)) * 16777619u; h = (h ^ (c >> 8)) * 16777619u; }
+    return h;
+}
+
+bool savePanelPPM(const char* path) {
+    FILE* f = fopen(path, "wb");
+    if(!f) return false;
+    fprintf(f, "P6\n%d %d\n255\n", P.w, P.h);
+    for(uint16_t c : P.ram) {
+        uint8_t rgb[3] = {(uint8_t)((c >> 8) & 0xF8), (uint8_t)((c >> 3) & 0xFC), (uint8_t)((c << 3) & 0xF8)};
+        fwrite(rgb, 1, 3, f);
+    }
+    fclose(f);
+    return true;
+}
+}  // namespace sim
+
+/* ================== ADAFRUIT_ILI9341 ================== */
+Adafruit_ILI9341::Adafruit_ILI9341(int8_t, int8_t, int8_t) : Adafruit_GFX(ILI9341_TFTWIDTH, ILI9341_TFTHEIGHT) {}
+Adafruit_ILI9341::Adafruit_ILI9341(SPIClass*, int8_t, int8_t, int8_t) : Adafruit_GFX(ILI9341_TFTWIDTH, ILI9341_TFTHEIGHT) {}
+
+void Adafruit_ILI9341::begin(uint32_t) {
+    sim::panel::setSize(_width, _height);
+    sim::panel::commandBytes(78);  // initcmd sequence
+}
+
+void Adafruit_ILI9341::setRotation(uint8_t r) {
+    Adafruit_GFX::setRotation(r);
+    sim::panel::setSize(_width, _height);
+    sim::panel::commandBytes(2);  // MADCTL
+}
+
+void Adafruit_ILI9341::scrollTo(uint16_t) { sim::panel::commandBytes(3); }
+void Adafruit_ILI9341::setScrollMargins(uint16_t, uint16_t) { sim::panel::commandBytes(7); }
+
+bool Adafruit_ILI9341::clip(int16_t& x, int16_t& y, int16_t& w, int16_t& h) const {
+    if(w < 0) { x += w + 1; w = -w; }
+    if(h < 0) { y += h + 1; h = -h; }
+    if(x >= _width || y >= _height) return false;
+    int16_t x2 = x + w - 1, y2 = y + h - 1;
+    if(x2 < 0 || y2 < 0) return false;
+    if(x < 0) { x = 0; w = x2 + 1; }
+    if(y < 0) { y = 0; h = y2 + 1; }
+    if(x2 >= _width) w = _width - x;
+    if(y2 >= _height) h = _height - y;
+    return w > 0 && h > 0;
+}
+
+void Adafruit_ILI9341::drawPixel(int16_t x, int16_t y, uint16_t color) {
+    sim::CallScope s("drawPixel", x, y, 1, 1);
+    writePixel(x, y, color);
+}
+
+void Adafruit_ILI9341::writePixel(int16_t x, int16_t y, uint16_t color) {
+    if(x < 0 || x >= _width || y < 0 || y >= _height) return;
+    sim::panel::openWindow(x, y, 1, 1);
+    sim::panel::pushColor(color, 1);
+}
+
+void Adafruit_ILI9341::writeFillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    if(!clip(x, y, w, h)) return;
+    sim::panel::openWindow(x, y, w, h);
+    sim::panel::pushColor(color, (uint32_t)w * h);
+}
+
+void Adafruit_ILI9341::writeFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) { writeFillRect(x, y, 1, h, color); }
+void Adafruit_ILI9341::writeFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) { writeFillRect(x, y, w, 1, color); }
+
+void Adafruit_ILI9341::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+    sim::CallScope s("drawFastVLine", x, y, 1, h);
+    writeFillRect(x, y, 1, h, color);
+}
+
+void Adafruit_ILI9341::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+    sim::CallScope s("drawFastHLine", x, y, w, 1);
+    writeFillRect(x, y, w, 1, color);
+}
+
+void Adafruit_ILI9341::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+    sim::CallScope s("fillRect", x, y, w, h);
+    writeFillRect(x, y, w, h, color);
+}
+
+void Adafruit_ILI9341::fillScreen(uint16_t color) {
+    sim::CallScope s("fillScreen", 0, 0, _width, _height);
+    writeFillRect(0, 0, _width, _height, color);
+}
+
+void Adafruit_ILI9341::drawRGBBitmap(int16_t x, int16_t y, uint16_t* bitmap, int16_t w, int16_t h) {
+    sim::CallScope s("drawRGBBitmap", x, y, w, h);
+    int16_t cx = x, cy = y, cw = w, ch = h;
+    if(!clip(cx, cy, cw, ch)) return;
+    sim::panel::openWindow(cx, cy, cw, ch);
+    for(int16_t j = 0; j < ch; j++) sim::panel::pushPixels(bitmap + (cy - y + j) * w + (cx - x), cw, false);
+}
+
+void Adafruit_ILI9341::setAddrWindow(uint16_t x, uint16_t y, uint16_t w, uint16_t h) {
+    sim::CallScope s("setAddrWindow", x, y, w, h);
+    sim::panel::openWindow(x, y, w, h);
+}
+
+// Synchronous whatever block says, as on the ESP32
+void Adafruit_ILI9341::writePixels(uint16_t* colors, uint32_t len, bool, bool bigEndian) {
+    sim::CallScope s("writePixels", 0, 0, (int)len, 1);
+    sim::panel::pushPixels(colors, len, bigEndian);
+}
+
+void Adafruit_ILI9341::writeColor(uint16_t color, uint32_t len) {
+    sim::CallScope s("writeColor", 0, 0, (int)len, 1);
+    sim::panel::pushColor(color, len);
+}
+
+void Adafruit_ILI9341::pushColor(uint16_t color) {
+    sim::CallScope s("pushColor", 0, 0, 1, 1);
+    sim::panel::pushColor(color, 1);
+}
+
+/* ================== SPI MASTER (panel bus) ================== */
+// Every device is taken to sit on the panel's bus and to write RAM data:
+// two bytes per pixel, high byte first, into the open address window.
+struct spi_device_t {
+    int queueSize;
+};
+
+namespace {
+int busMaxTransfer = 4092;   // the driver's default with DMA
+}
+
+esp_err_t spi_bus_initialize(spi_host_device_t, const spi_bus_config_t* bus, int) {
+    if(bus->max_transfer_sz > 0) busMaxTransfer = bus->max_transfer_sz;
+    return ESP_OK;
+}
+
+esp_err_t spi_bus_add_device(spi_host_device_t, const spi_device_interface_config_t* dev, spi_device_handle_t* handle) {
+    *handle = new spi_device_t{dev->queue_size};
+    return ESP_OK;
+}
+
+esp_err_t spi_device_queue_trans(spi_device_handle_t handle, spi_transaction_t* trans, TickType_t) {
+    if(trans->length > (size_t)busMaxTransfer * 8 || (trans->length & 15)) return ESP_ERR_INVALID_ARG;
+    if((int)P.queued.size() >= handle->queueSize) return ESP_ERR_TIMEOUT;
+    P.queued.push_back(trans);
+    return ESP_OK;
+}
+
+// Completes the oldest transfer: the pixels are read from its buffer now
+esp_err_t spi_device_get_trans_result(spi_device_handle_t, spi_transaction_t** trans, TickType_t) {
+    if(P.queued.empty()) return ESP_ERR_TIMEOUT;
+    spi_transaction_t* t = P.queued.front();
+    P.queued.pop_front();
+    uint32_t count = t->length / 16;
+    const uint16_t* colors = (const uint16_t*)t->tx_buffer;
+    sim::CallScope s("spiTrans", 0, 0, (int)count, 1);
+    P.stats.pixels += count;
+    P.stats.spiBytes += 2ull * count;
+    for(uint32_t i = 0; i < count; i++) store((uint16_t)(colors[i] << 8 | colors[i] >> 8));
+    *trans = t;
+    return ESP_OK;
+}
@@ -0,0 +1,442 @@
+// Radio stand-ins: WiFi, esp_wifi and BLE over a small synthetic world of
+// access points, stations and BLE advertisers. Frames are generated per
+// channel from fixed rates with their own PRNG so firmware calls to
+// random() never perturb the traffic.
+#include <algorithm>
+#include <vector>
+#include "WiFi.h"
+#include "esp_timer.h"
+#include "sim_ble.h"
+#include "sim_internal.h"
+
+WiFiClass WiFi;
+
+/* ================== WORLD ================== */
+namespace {
+struct SimAP {
+    const char* ssid;
+    uint8_t bssid[6];
+    uint8_t channel;
+    int8_t rssi;
+    wifi_auth_mode_t auth;
+};
+
+const SimAP worldAPs[] = {
+    {"ctOS_Backbone",     {0x02, 0x11, 0x22, 0x33, 0x44, 0x01},  1, -48, WIFI_AUTH_WPA2_PSK},
+    {"Blume_Guest",       {0x02, 0x11, 0x22, 0x33, 0x44, 0x02},  1, -67, WIFI_AUTH_OPEN},
+    {"DIRECT-7F-Printer", {0x02, 0x11, 0x22, 0x33, 0x44, 0x03},  1, -81, WIFI_AUTH_WPA2_PSK},
+    {"Nudle_Corp",        {0x02, 0x11, 0x22, 0x33, 0x44, 0x04},  3, -74, WIFI_AUTH_WPA2_ENTERPRISE},
+    {"Tidis_Office",      {0x02, 0x11, 0x22, 0x33, 0x44, 0x05},  6, -52, WIFI_AUTH_WPA2_WPA3_PSK},
+    {"Tidis_Office_IoT",  {0x02, 0x11, 0x22, 0x33, 0x44, 0x06},  6, -58, WIFI_AUTH_WPA_WPA2_PSK},
+    {"",                  {0x02, 0x11, 0x22, 0x33, 0x44, 0x07},  6, -71, WIFI_AUTH_WPA2_PSK},
+    {"CafeCoffeeFree",    {0x02, 0x11, 0x22, 0x33, 0x44, 0x08},  6, -77, WIFI_AUTH_OPEN},
+    {"SF_Muni_Public",    {0x02, 0x11, 0x22, 0x33, 0x44, 0x09},  6, -88, WIFI_AUTH_OPEN},
+    {"Invite_Labs",       {0x02, 0x11, 0x22, 0x33, 0x44, 0x0A},  8, -63, WIFI_AUTH_WPA3_PSK},
+    {"HomeNet_5521",      {0x02, 0x11, 0x22, 0x33, 0x44, 0x0B}, 11, -55, WIFI_AUTH_WPA2_PSK},
+    {"HomeNet_5521_EXT",  {0x02, 0x11, 0x22, 0x33, 0x44, 0x0C}, 11, -69, WIFI_AUTH_WPA2_PSK},
+    {"LegacyCam",         {0x02, 0x11, 0x22, 0x33, 0x44, 0x0D}, 11, -84, WIFI_AUTH_WEP},
+    {"Umeni_Eco_Mesh",    {0x02, 0x11, 0x22, 0x33, 0x44, 0x0E}, 13, -79, WIFI_AUTH_WPA2_PSK},
+};
+const int worldAPCount = sizeof(worldAPs) / sizeof(worldAPs[0]);
+
+// Background (non-beacon) frames per second on each channel 1..13.
+const float channelRate[14] = {0, 420, 60, 90, 40, 30, 610, 50, 120, 35, 25, 330, 20, 70};
+
+struct SimBLE {
+    const char* name;
+    uint8_t addr[6];
+    int8_t rssi;
+    uint16_t intervalMs;
+};
+
+const SimBLE worldBLE[] = {
+    {"Pixel 8",        {0xC0, 0x01, 0x02, 0x03, 0x04, 0x01}, -54, 160},
+    {"JBL Flip 6",     {0xC0, 0x01, 0x02, 0x03, 0x04, 0x02}, -61, 100},
+    {"",               {0xC0, 0x01, 0x02, 0x03, 0x04, 0x03}, -72, 320},
+    {"Mi Band 7",      {0xC0, 0x01, 0x02, 0x03, 0x04, 0x04}, -66, 500},
+    {"",               {0xC0, 0x01, 0x02, 0x03, 0x04, 0x05}, -83, 1000},
+    {"Tile",           {0xC0, 0x01, 0x02, 0x03, 0x04, 0x06}, -77, 2000},
+    {"LE-Bose QC45",   {0xC0, 0x01, 0x02, 0x03, 0x04, 0x07}, -58, 100},
+    {"",               {0xC0, 0x01, 0x02, 0x03, 0x04, 0x08}, -90, 640},
+    {"Galaxy Watch5",  {0xC0, 0x01, 0x02, 0x03, 0x04, 0x09}, -69, 250},
+    {"ELK-BLEDOM",     {0xC0, 0x01, 0x02, 0x03, 0x04, 0x0A}, -80, 200},
+    {"",               {0xC0, 0x01, 0x02, 0x03, 0x04, 0x0B}, -74, 180},
+    {"Nordic_UART",    {0xC0, 0x01, 0x02, 0x03, 0x04, 0x0C}, -86, 1000},
+};
+const int worldBLECount = sizeof(worldBLE) / sizeof(worldBLE[0]);
+
+uint32_t trafficRand = 0xC0FFEE;
+uint32_t nextTraffic() { trafficRand ^= trafficRand << 13; trafficRand ^= trafficRand >> 17; trafficRand ^= trafficRand << 5; return trafficRand; }
+int jitter(int span) { return (int)(nextTraffic() % (2 * span + 1)) - span; }
+
+struct RadioState {
+    wifi_mode_t mode = WIFI_MODE_NULL;
+    bool driverInit = false;
+    bool promiscuous = false;
+    wifi_promiscuous_cb_t rxCb = nullptr;
+    uint32_t filterMask = WIFI_PROMIS_FILTER_MASK_MGMT | WIFI_PROMIS_FILTER_MASK_DATA;
+    uint32_t ctrlFilterMask = WIFI_PROMIS_CTRL_FILTER_MASK_ALL;
+    uint8_t channel = 1;
+    float scale = 1.0f;
+    float backlog = 0;
+    unsigned long long nextBeaconUs[worldAPCount] = {};
+
+    std::vector<wifi_ap_record_t> scanResults;
+    bool scanRunning = false;
+    unsigned long long scanDoneUs = 0;
+    uint8_t scanChannel = 0;
+
+    sim::RadioStats stats;
+} R;
+}
+
+namespace sim {
+RadioStats radioStats() { return R.stats; }
+void setTrafficScale(float scale) { R.scale = scale; }
+}
+
+int64_t esp_timer_get_time(void) { return (int64_t)sim::nowMicros(); }
+
+/* ================== FRAME GENERATION ================== */
+namespace {
+uint8_t frameBuf[sizeof(wifi_promiscuous_pkt_t) + 1600];
+
+uint8_t* beginFrame(int8_t rssi, uint16_t len) {
+    wifi_promiscuous_pkt_t* pkt = (wifi_promiscuous_pkt_t*)frameBuf;
+    memset(&pkt->rx_ctrl, 0, sizeof(pkt->rx_ctrl));
+    pkt->rx_ctrl.rssi = rssi;
+    pkt->rx_ctrl.channel = R.channel;
+    pkt->rx_ctrl.noise_floor = -95;
+    pkt->rx_ctrl.timestamp = (unsigned)sim::nowMicros();
+    pkt->rx_ctrl.sig_len = len;
+    return pkt->payload;
+}
+
+void deliver(wifi_promiscuous_pkt_type_t type) {
+    static const uint32_t typeMask[] = {WIFI_PROMIS_FILTER_MASK_MGMT, WIFI_PROMIS_FILTER_MASK_CTRL, WIFI_PROMIS_FILTER_MASK_DATA, WIFI_PROMIS_FILTER_MASK_MISC};
+    if(!(R.filterMask & typeMask[type])) return;
+    R.stats.framesDelivered++;
+    R.rxCb(frameBuf, type);
+}
+
+uint16_t putBeaconBody(uint8_t* f, const SimAP& ap, uint8_t subtype) {
+    f[0] = subtype << 4; f[1] = 0;
+    f[2] = 0; f[3] = 0;
+    if(subtype == 8) memset(f + 4, 0xFF, 6); else { f[4] = 0x02; f[5] = 0x5A; memset(f + 6, 0x10, 4); }
+    memcpy(f + 10, ap.bssid, 6);
+    memcpy(f + 16, ap.bssid, 6);
+    f[22] = 0; f[23] = 0;
+    memset(f + 24, 0, 8);                         // timestamp
+    f[32] = 0x64; f[33] = 0x00;                   // beacon interval 100 TU
+    uint16_t cap = 0x0401 | (ap.auth != WIFI_AUTH_OPEN ? 0x0010 : 0);
+    f[34] = cap & 0xFF; f[35] = cap >> 8;
+    uint8_t* p = f + 36;
+    size_t sl = strlen(ap.ssid);
+    *p++ = 0; *p++ = (uint8_t)sl; memcpy(p, ap.ssid, sl); p += sl;
+    static const uint8_t rates[] = {1, 8, 0x82, 0x84, 0x8B, 0x96, 0x0C, 0x12, 0x18, 0x24};
+    memcpy(p, rates, sizeof(rates)); p += sizeof(rates);
+    *p++ = 3; *p++ = 1; *p++ = ap.channel;
+    if(ap.auth >= WIFI_AUTH_WPA2_PSK && ap.auth != WIFI_AUTH_WEP) {
+        uint8_t akm = (ap.auth == WIFI_AUTH_WPA3_PSK) ? 8 : (ap.auth == WIFI_AUTH_WPA2_ENTERPRISE ? 1 : 2);
+        const uint8_t rsn[] = {48, 20, 1, 0, 0x00, 0x0F, 0xAC, 4, 1, 0, 0x00, 0x0F, 0xAC, 4, 1, 0, 0x00, 0x0F, 0xAC, akm, 0, 0};
+        memcpy(p, rsn, sizeof(rsn)); p += sizeof(rsn);
+    }
+    if(ap.auth == WIFI_AUTH_WPA_PSK || ap.auth == WIFI_AUTH_WPA_WPA2_PSK) {
+        const uint8_t wpa[] = {221, 22, 0x00, 0x50, 0xF2, 1, 1, 0, 0x00, 0x50, 0xF2, 2, 1, 0, 0x00, 0x50, 0xF2, 2, 1, 0, 0x00, 0x50, 0xF2, 2};
+        memcpy(p, wpa, sizeof(wpa)); p += sizeof(wpa);
+    }
+    const uint8_t vendor[] = {221, 9, 0x00, 0x10, 0x18, 2, 0, 0, 0x1C, 0, 0};
+    memcpy(p, vendor, sizeof(vendor)); p += sizeof(vendor);
+    return (uint16_t)(p - f) + 4;  // + FCS
+}
+
+void emitBeacon(const SimAP& ap, uint8_t subtype) {
+    uint8_t* f = beginFrame((int8_t)(ap.rssi + jitter(3)), 0);
+    uint16_t len = putBeaconBody(f, ap, subtype);
+    ((wifi_promiscuous_pkt_t*)frameBuf)->rx_ctrl.sig_len = len;
+    deliver(WIFI_PKT_MGMT);
+}
+
+void emitBackground() {
+    uint32_t r = nextTraffic() % 100;
+    int8_t rssi = (int8_t)(-85 + (int)(nextTraffic() % 45));
+    if(r < 62) {                                      // data / QoS data / null
+        uint8_t subtype = r < 24 ? 0 : (r < 58 ? 8 : 4);
+        uint16_t len = subtype == 4 ? 28 : (uint16_t)(60 + nextTraffic() % 1440);
+        uint8_t* f = beginFrame(rssi, len);
+        memset(f, 0, 32);
+        f[0] = (subtype << 4) | (2 << 2);
+        f[1] = (r & 1) ? 0x01 : 0x02;
+        f[4] = 0x02; f[5] = 0x5A; f[9] = (uint8_t)(r & 7);
+        memcpy(f + 10, worldAPs[nextTraffic() % worldAPCount].bssid, 6);
+        memcpy(f + 16, f + 10, 6);
+        deliver(WIFI_PKT_DATA);
+    } else if(r < 88) {                               // ACK / RTS / CTS / BlockAck
+        uint8_t subtype = r < 76 ? 13 : (r < 80 ? 11 : (r < 85 ? 12 : 9));
+        if(!(R.ctrlFilterMask & (1u << (16 + subtype)))) return;
+        uint16_t len = (subtype == 11 || subtype == 9) ? 20 : 14;
+        uint8_t* f = beginFrame(rssi, len);
+        memset(f, 0, 16);
+        f[0] = (subtype << 4) | (1 << 2);
+        f[4] = 0x02; f[5] = 0x5A; f[9] = (uint8_t)r;
+        deliver(WIFI_PKT_CTRL);
+    } else {                                          // probe req, auth, assoc, action
+        static const uint8_t mgmt[] = {4, 4, 4, 4, 11, 0, 1, 13, 13, 12, 10, 4};
+        uint8_t subtype = mgmt[(r - 88) % sizeof(mgmt)];
+        uint8_t* f = beginFrame(rssi, 0);
+        memset(f, 0, 40);
+        f[0] = subtype << 4;
+        memset(f + 4, 0xFF, 6);
+        f[10] = 0x02; f[11] = 0x5A; f[15] = (uint8_t)r;
+        memset(f + 16, 0xFF, 6);
+        uint16_t len = 24;
+        if(subtype == 4) { f[24] = 0; f[25] = 0; f[26] = 1; f[27] = 4; f[28] = 0x82; f[29] = 0x84; f[30] = 0x8B; f[31] = 0x96; len = 32; }
+        ((wifi_promiscuous_pkt_t*)frameBuf)->rx_ctrl.sig_len = len + 4;
+        deliver(WIFI_PKT_MGMT);
+    }
+}
+}
+
+/* ================== BLE WORLD ================== */
+namespace {
+BLEAdvertising bleAdvertising;
+BLEServer bleServer;
+BLEScan bleScan;
+bool bleLinked = false;
+std::vector<sim::HidReport> hidLog;
+
+struct BleScanState {
+    bool scanning = false;
+    unsigned long long endUs = 0;  // 0 = until stopped
+    void (*onComplete)(BLEScanResults) = nullptr;
+    BLEAdvertisedDeviceCallbacks* cb = nullptr;
+    bool wantDuplicates = false;
+    unsigned long long nextAdvUs[worldBLECount] = {};
+    std::vector<BLEAdvertisedDevice> seen;
+} S;
+
+BLEAdvertisedDevice makeAdvert(const SimBLE& d) {
+    BLEAdvertisedDevice dev;
+    dev.name = d.name;
+    dev.address = BLEAddress(d.addr);
+    dev.rssi = d.rssi + jitter(6);
+    dev.txPower = d.name[0] ? -8 : 0;
+    return dev;
+}
+
+void deliverBle(unsigned long long toUs) {
+    if(!S.scanning) return;
+    for(int i = 0; i < worldBLECount; i++) {
+        if(S.nextAdvUs[i] > toUs) continue;
+        S.nextAdvUs[i] = toUs + worldBLE[i].intervalMs * 1000ull + (nextTraffic() % 10000);
+        BLEAdvertisedDevice dev = makeAdvert(worldBLE[i]);
+        bool fresh = true;
+        for(auto& s : S.seen) if(s.getAddress().equals(dev.getAddress())) { s = dev; fresh = false; break; }
+        if(fresh) S.seen.push_back(dev);
+        if(S.cb && (fresh || S.wantDuplicates)) { R.stats.bleAdverts++; S.cb->onResult(dev); }
+    }
+    if(S.endUs && toUs >= S.endUs) {
+        S.scanning = false;
+        if(S.onComplete) { BLEScanResults res; res.devices = S.seen; S.onComplete(res); }
+    }
+}
+}
+
+namespace sim {
+void deliverRadio(unsigned long long fromUs, unsigned long long toUs) {
+    deliverBle(toUs);
+    if(!(R.promiscuous && R.rxCb)) return;
+    for(int i = 0; i < worldAPCount; i++) {
+        if(worldAPs[i].channel != R.channel) continue;
+        if(R.nextBeaconUs[i] > toUs) continue;
+        R.nextBeaconUs[i] = toUs + 102400;
+        emitBeacon(worldAPs[i], 8);
+    }
+    R.backlog += channelRate[R.channel] * R.scale * (float)(toUs - fromUs) / 1e6f;
+    while(R.backlog >= 1.0f) { R.backlog -= 1.0f; emitBackground(); }
+}
+
+void bleConnect(bool connected) {
+    if(connected == bleLinked) return;
+    bleLinked = connected;
+    if(!bleServer.callbacks) return;
+    if(connected) { bleAdvertising.advertising = false; bleServer.callbacks->onConnect(&bleServer); }
+    else bleServer.callbacks->onDisconnect(&bleServer);
+}
+
+const std::vector<HidReport>& hidReports() { return hidLog; }
+}
+
+/* ================== ESP_WIFI ================== */
+esp_err_t esp_wifi_init(const wifi_init_config_t*) {
+    if(R.driverInit) return ESP_OK;
+    R.driverInit = true;
+    R.stats.wifiDriverInits++;
+    sim::advance(30);
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_deinit(void) {
+    R.driverInit = false;
+    R.promiscuous = false;
+    R.mode = WIFI_MODE_NULL;
+    sim::advance(10);
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_storage(wifi_storage_t) { return ESP_OK; }
+
+esp_err_t esp_wifi_set_mode(wifi_mode_t mode) {
+    if(!R.driverInit) return ESP_ERR_INVALID_STATE;
+    if(mode != R.mode) R.stats.wifiModeChanges++;
+    R.mode = mode;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_get_mode(wifi_mode_t* mode) { *mode = R.mode; return R.driverInit ? ESP_OK : ESP_ERR_INVALID_STATE; }
+esp_err_t esp_wifi_start(void) { sim::advance(15); return R.driverInit ? ESP_OK : ESP_ERR_INVALID_STATE; }
+esp_err_t esp_wifi_stop(void) { R.promiscuous = false; return ESP_OK; }
+esp_err_t esp_wifi_set_promiscuous(bool en) { R.promiscuous = en; return ESP_OK; }
+esp_err_t esp_wifi_set_promiscuous_rx_cb(wifi_promiscuous_cb_t cb) { R.rxCb = cb; return ESP_OK; }
+esp_err_t esp_wifi_set_promiscuous_filter(const wifi_promiscuous_filter_t* f) { R.filterMask = f->filter_mask; return ESP_OK; }
+esp_err_t esp_wifi_set_promiscuous_ctrl_filter(const wifi_promiscuous_filter_t* f) { R.ctrlFilterMask = f->filter_mask; return ESP_OK; }
+
+esp_err_t esp_wifi_set_channel(uint8_t primary, wifi_second_chan_t) {
+    if(primary < 1 || primary > 13) return ESP_ERR_INVALID_ARG;
+    if(primary != R.channel) R.stats.channelSwitches++;
+    R.channel = primary;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_get_channel(uint8_t* primary, wifi_second_chan_t* second) {
+    *primary = R.channel;
+    if(second) *second = WIFI_SECOND_CHAN_NONE;
+    return ESP_OK;
+}
+
+esp_err_t esp_wifi_80211_tx(wifi_interface_t, const void*, int, bool) {
+    R.stats.framesInjected++;
+    return ESP_OK;
+}
+
+/* ================== WIFI CLASS ================== */
+bool WiFiClass::mode(wifi_mode_t m) {
+    if(m == R.mode && (R.driverInit || m == WIFI_MODE_NULL)) return true;
+    if(m != WIFI_MODE_NULL && !R.driverInit) { wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT(); esp_wifi_init(&cfg); esp_wifi_start(); }
+    R.stats.wifiModeChanges++;
+    R.mode = m;
+    return true;
+}
+
+wifi_mode_t WiFiClass::getMode() { return R.mode; }
+bool WiFiClass::disconnect(bool wifioff, bool) { if(wifioff) mode(WIFI_MODE_NULL); return true; }
+
+static void collectScan(uint8_t channel) {
+    for(int i = 0; i < worldAPCount; i++) {
+        const SimAP& ap = worldAPs[i];
+        if(channel && ap.channel != channel) continue;
+        wifi_ap_record_t rec = {};
+        memcpy(rec.bssid, ap.bssid, 6);
+        strncpy((char*)rec.ssid, ap.ssid, 32);
+        rec.primary = ap.channel;
+        rec.rssi = (int8_t)(ap.rssi + jitter(4));
+        rec.authmode = ap.auth;
+        R.scanResults.push_back(rec);
+    }
+    std::stable_sort(R.scanResults.begin(), R.scanResults.end(),
+                     [](const wifi_ap_record_t& a, const wifi_ap_record_t& b) { return a.rssi > b.rssi; });
+}
+
+int16_t WiFiClass::scanNetworks(bool async, bool, bool, uint32_t max_ms_per_chan, uint8_t channel, const char*, const uint8_t*) {
+    if(R.mode == WIFI_MODE_NULL) mode(WIFI_MODE_STA);
+    if(R.scanRunning) return WIFI_SCAN_RUNNING;
+    R.stats.wifiScans++;
+    R.scanResults.clear();
+    uint32_t dwell = max_ms_per_chan < 120 ? max_ms_per_chan : 120;
+    unsigned long duration = dwell * (channel ? 1 : 13);
+    R.scanChannel = channel;
+    if(async) {
+        R.scanRunning = true;
+        R.scanDoneUs = sim::nowMicros() + duration * 1000ull;
+        return WIFI_SCAN_RUNNING;
+    }
+    sim::advance(duration);
+    collectScan(channel);
+    return (int16_t)R.scanResults.size();
+}
+
+int16_t WiFiClass::scanComplete() {
+    if(R.scanRunning) {
+        if(sim::nowMicros() < R.scanDoneUs) return WIFI_SCAN_RUNNING;
+        R.scanRunning = false;
+        collectScan(R.scanChannel);
+    }
+    return (int16_t)R.scanResults.size();
+}
+
+void WiFiClass::scanDelete() { R.scanResults.clear(); }
+
+String WiFiClass::SSID(uint8_t i) { return i < R.scanResults.size() ? String((const char*)R.scanResults[i].ssid) : String(); }
+int32_t WiFiClass::RSSI(uint8_t i) { return i < R.scanResults.size() ? R.scanResults[i].rssi : 0; }
+uint8_t* WiFiClass::BSSID(uint8_t i) { return i < R.scanResults.size() ? R.scanResults[i].bssid : nullptr; }
+int32_t WiFiClass::channel(uint8_t i) { return i < R.scanResults.size() ? R.scanResults[i].primary : 0; }
+wifi_auth_mode_t WiFiClass::encryptionType(uint8_t i) { return i < R.scanResults.size() ? R.scanResults[i].authmode : WIFI_AUTH_OPEN; }
+void* WiFiClass::getScanInfoByIndex(int i) { return i >= 0 && i < (int)R.scanResults.size() ? &R.scanResults[i] : nullptr; }
+String WiFiClass::macAddress() { return String("24:0A:C4:5E:1D:90"); }
+uint8_t* WiFiClass::macAddress(uint8_t* mac) {
+    static const uint8_t sta[6] = {0x24, 0x0A, 0xC4, 0x5E, 0x1D, 0x90};
+    memcpy(mac, sta, 6);
+    return mac;
+}
+
+/* ================== BLE ================== */
+std::string BLEUUID::toString() const {
+    char buf[40];
+    snprintf(buf, sizeof(buf), "0000%04x-0000-1000-8000-00805f9b34fb", uuid);
+    return buf;
+}
+
+std::string BLEAddress::toString() const {
+    char buf[18];
+    snprintf(buf, sizeof(buf), "%02x:%02x:%02x:%02x:%02x:%02x", addr[0], addr[1], addr[2], addr[3], addr[4], addr[5]);
+    return buf;
+}
+
+void BLECharacteristic::notify() { hidLog.push_back({millis(), value}); }
+void BLEAdvertising::start() { advertising = true; }
+void BLEAdvertising::stop() { advertising = false; }
+BLEAdvertising* BLEServer::getAdvertising() { return &bleAdvertising; }
+uint32_t BLEServer::getConnectedCount() { return bleLinked ? 1 : 0; }
+
+BLEServer* BLEDevice::createServer() { return &bleServer; }
+BLEAdvertising* BLEDevice::getAdvertising() { return &bleAdvertising; }
+BLEScan* BLEDevice::getScan() { return &bleScan; }
+
+void BLEScan::setAdvertisedDeviceCallbacks(BLEAdvertisedDeviceCallbacks* cb, bool wantDuplicates, bool) {
+    S.cb = cb;
+    S.wantDuplicates = wantDuplicates;
+}
+
+BLEScanResults* BLEScan::start(uint32_t duration, bool is_continue) {
+    R.stats.bleScans++;
+    if(!is_continue) S.seen.clear();
+    S.scanning = true;
+    S.endUs = 0;
+    S.onComplete = nullptr;
+    sim::advance(duration * 1000);
+    S.scanning = false;
+    results.devices = S.seen;
+    return &results;
+}
+
+bool BLEScan::start(uint32_t duration, void (*scanCompleteCB)(BLEScanResults), bool is_continue) {
+    R.stats.bleScans++;
+    if(!is_continue) S.seen.clear();
+    S.scanning = true;
+    S.endUs = duration ? sim::nowMicros() + duration * 1000000ull : 0;
+    S.onComplete = scanCompleteCB;
+    return true;
+}
+
+void BLEScan::stop() { S.scanning = false; }
+bool BLEScan::isScanning() const { return S.scanning; }
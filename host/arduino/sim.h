@@ -0,0 +1,85 @@
+// Simulator control surface. The stand-in libraries in this directory feed
+// a shared panel/radio model; drivers (sim_main.cpp) use these calls to push
+// touches, move the virtual clock and read back per-frame draw costs.
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sim {
+
+// Cost of everything sent to the ILI9341, counted the way Adafruit_SPITFT
+// would clock it out: every address window is CASET+RASET+RAMWR (11 bytes)
+// and every pixel is two bytes of RGB565.
+struct DrawStats {
+    uint32_t calls = 0;      // top-level draw API calls
+    uint32_t windows = 0;    // address windows opened
+    uint64_t pixels = 0;     // pixels written to panel RAM
+    uint64_t spiBytes = 0;   // bytes on the display bus
+};
+
+struct DrawCall {
+    const char* op;
+    int16_t x, y, w, h;
+    uint32_t pixels;
+    uint32_t spiBytes;
+};
+
+DrawStats drawStats();
+DrawStats operator-(const DrawStats& a, const DrawStats& b);
+void traceDrawCalls(bool on);
+const std::vector<DrawCall>& drawCalls();
+void clearDrawCalls();
+
+int panelWidth();
+int panelHeight();
+uint16_t panelPixel(int x, int y);
+uint32_t panelChecksum();
+bool savePanelPPM(const char* path);
+
+// Virtual clock. advance() also delivers any radio traffic due in the
+// interval to the registered promiscuous callback.
+void advance(unsigned long ms);
+
+// Touch in screen coordinates (after rotation), converted to raw XPT2046
+// readings with the same calibration main.cpp uses. press() while already
+// pressed moves the contact (drags).
+void press(int x, int y);
+void release();
+
+// Radio model.
+struct RadioStats {
+    uint64_t framesDelivered = 0;
+    uint64_t framesInjected = 0;   // esp_wifi_80211_tx calls
+    uint64_t bleAdverts = 0;       // advertisements reported to scan callbacks
+    uint32_t wifiScans = 0;
+    uint32_t bleScans = 0;
+    uint32_t wifiModeChanges = 0;
+    uint32_t wifiDriverInits = 0;
+    uint32_t channelSwitches = 0;
+};
+RadioStats radioStats();
+void setTrafficScale(float scale);  // multiplies the per-channel frame rates
+
+// BLE HID link. bleConnect() fires the server callbacks the firmware
+// registered; every notify() on a characteristic is logged.
+void bleConnect(bool connected);
+struct HidReport {
+    unsigned long atMs;
+    std::vector<uint8_t> data;
+};
+const std::vector<HidReport>& hidReports();
+
+// Serial. Output is dropped unless echoed to stderr or captured to a file.
+void serialEcho(bool on);
+bool serialCapture(const char* path);
+void serialInput(const uint8_t* data, size_t len);
+
+// Host directory behind LittleFS and Preferences. Without it each run gets
+// an empty temp directory.
+void fsRoot(const char* dir);
+
+// Heap churn seen through the String stand-in.
+unsigned long stringAllocs();
+
+}  // namespace sim
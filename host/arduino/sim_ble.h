@@ -0,0 +1,139 @@
+// Host stand-in for the ESP32 BLE library (server/HID/advertising/scan).
+// The scan side reports devices from the simulator's synthetic world.
+#pragma once
+#include <string>
+#include <vector>
+#include "Arduino.h"
+
+#define HID_KEYBOARD 0x03C1
+
+typedef uint8_t esp_bd_addr_t[6];
+
+class BLEUUID {
+public:
+    BLEUUID(uint16_t uuid16 = 0) : uuid(uuid16) {}
+    std::string toString() const;
+    uint16_t uuid;
+};
+
+class BLEAddress {
+public:
+    BLEAddress() { memset(addr, 0, sizeof(addr)); }
+    explicit BLEAddress(const uint8_t* native) { memcpy(addr, native, sizeof(addr)); }
+    std::string toString() const;
+    esp_bd_addr_t* getNative() { return &addr; }
+    bool equals(const BLEAddress& o) const { return memcmp(addr, o.addr, sizeof(addr)) == 0; }
+private:
+    esp_bd_addr_t addr;
+};
+
+class BLECharacteristic {
+public:
+    void setValue(const uint8_t* data, size_t len) { value.assign(data, data + len); }
+    void setValue(const std::string& s) { value.assign(s.begin(), s.end()); }
+    void setValue(const char* s) { setValue(std::string(s)); }
+    void notify();
+    std::vector<uint8_t> value;
+};
+
+class BLEService {
+public:
+    explicit BLEService(uint16_t uuid) : uuid(uuid) {}
+    BLEUUID getUUID() { return uuid; }
+private:
+    BLEUUID uuid;
+};
+
+class BLEAdvertising {
+public:
+    void setAppearance(uint16_t appearance) {}
+    void addServiceUUID(BLEUUID uuid) {}
+    void start();
+    void stop();
+    bool advertising = false;
+};
+
+class BLEServer;
+class BLEServerCallbacks {
+public:
+    virtual ~BLEServerCallbacks() {}
+    virtual void onConnect(BLEServer* pServer) {}
+    virtual void onDisconnect(BLEServer* pServer) {}
+};
+
+class BLEServer {
+public:
+    void setCallbacks(BLEServerCallbacks* cb) { callbacks = cb; }
+    BLEAdvertising* getAdvertising();
+    uint32_t getConnectedCount();
+    BLEServerCallbacks* callbacks = nullptr;
+};
+
+class BLEHIDDevice {
+public:
+    explicit BLEHIDDevice(BLEServer* server) : hid(0x1812) {}
+    BLECharacteristic* inputReport(uint8_t reportID) { return &input; }
+    BLECharacteristic* manufacturer() { return &manufacturerChr; }
+    void pnp(uint8_t sig, uint16_t vid, uint16_t pid, uint16_t version) {}
+    void hidInfo(uint8_t country, uint8_t flags) {}
+    void reportMap(uint8_t* map, uint16_t size) {}
+    void startServices() {}
+    BLEService* hidService() { return &hid; }
+private:
+    BLEService hid;
+    BLECharacteristic input, manufacturerChr;
+};
+
+class BLEAdvertisedDevice {
+public:
+    bool haveName() const { return !name.empty(); }
+    std::string getName() const { return name; }
+    BLEAddress getAddress() const { return address; }
+    int getRSSI() const { return rssi; }
+    bool haveRSSI() const { return true; }
+    int8_t getTXPower() const { return txPower; }
+    bool haveTXPower() const { return txPower != 0; }
+    std::string toString() const { return name; }
+
+    std::string name;
+    BLEAddress address;
+    int rssi = 0;
+    int8_t txPower = 0;
+};
+
+class BLEAdvertisedDeviceCallbacks {
+public:
+    virtual ~BLEAdvertisedDeviceCallbacks() {}
+    virtual void onResult(BLEAdvertisedDevice advertisedDevice) = 0;
+};
+
+class BLEScanResults {
+public:
+    int getCount() { return (int)devices.size(); }
+    BLEAdvertisedDevice getDevice(uint32_t i) { return devices[i]; }
+    std::vector<BLEAdvertisedDevice> devices;
+};
+
+class BLEScan {
+public:
+    void setActiveScan(bool active) {}
+    void setInterval(uint16_t intervalMSecs) {}
+    void setWindow(uint16_t windowMSecs) {}
+    void setAdvertisedDeviceCallbacks(BLEAdvertisedDeviceCallbacks* cb, bool wantDuplicates = false, bool shouldParse = true);
+    BLEScanResults* start(uint32_t duration, bool is_continue = false);
+    bool start(uint32_t duration, void (*scanCompleteCB)(BLEScanResults), bool is_continue = false);
+    void stop();
+    void clearResults() { results.devices.clear(); }
+    bool isScanning() const;
+private:
+    BLEScanResults results;
+};
+
+class BLEDevice {
+public:
+    static void init(const std::string& deviceName) {}
+    static BLEServer* createServer();
+    static BLEAdvertising* getAdvertising();
+    static BLEScan* getScan();
+    static void deinit(bool release_memory = false) {}
+};
@@ -0,0 +1,37 @@
+// Shared state behind the stand-in libraries. Not for use by firmware code.
+#pragma once
+#include <cstdint>
+#include "sim.h"
+
+namespace sim {
+
+// Records one entry per top-level draw call; nested calls made by the
+// library itself (drawRect -> drawFastHLine ...) are folded into the caller.
+class CallScope {
+public:
+    CallScope(const char* op, int x = 0, int y = 0, int w = 0, int h = 0);
+    ~CallScope();
+private:
+    bool outer;
+};
+
+// Model of the ILI9341 graphics RAM, addressed in rotated (logical) space as
+// Adafruit_ILI9341 does after programming MADCTL.
+namespace panel {
+void setSize(int w, int h);
+void openWindow(int x, int y, int w, int h);
+void pushColor(uint16_t color, uint32_t count);
+void pushPixels(const uint16_t* colors, uint32_t count, bool bigEndian);
+void commandBytes(uint32_t n);
+}
+
+unsigned long nowMicros();
+bool inTask();        // running inside a FreeRTOS task rather than loop()
+void runTasks();      // resume every task that is due
+void setPin(uint8_t pin, int level);   // drives an input line, firing its interrupt on a matching edge
+void touchRaw(bool* down, int16_t* x, int16_t* y, int16_t* z);
+void serialWrite(const uint8_t* data, size_t len);
+int serialRead(bool consume);
+int serialAvailable();
+
+}  // namespace sim
@@ -0,0 +1,61 @@
+// XPT2046 stand-in. sim::press() takes screen coordinates and inverts the
+// raw->screen map main.cpp applies (x: 3700..200 -> 0..320, y: 3700..200 ->
+// 0..240), searching for a raw value that maps back exactly. PENIRQ is
+// modelled on TOUCH_IRQ_PIN (T_IRQ in main.cpp): low while pressed.
+#include "XPT2046_Touchscreen.h"
+#include "sim_internal.h"
+
+#define RAW_MIN 200
+#define RAW_MAX 3700
+#define Z_PRESSED 600
+#define TOUCH_IRQ_PIN 36
+
+static bool touchDown = false;
+static int16_t rawX = 0, rawY = 0;
+static bool touchEdge = false;
+
+static int16_t rawFor(int screen, int span) {
+    long guess = RAW_MAX - (long)screen * (RAW_MAX - RAW_MIN) / span;
+    for(long d = 0; d < 64; d++) {
+        if(map(guess - d, RAW_MAX, RAW_MIN, 0, span) == screen) return (int16_t)(guess - d);
+        if(map(guess + d, RAW_MAX, RAW_MIN, 0, span) == screen) return (int16_t)(guess + d);
+    }
+    return (int16_t)guess;
+}
+
+namespace sim {
+void press(int x, int y) {
+    rawX = rawFor(x, 320);
+    rawY = rawFor(y, 240);
+    if(!touchDown) touchEdge = true;
+    touchDown = true;
+    setPin(TOUCH_IRQ_PIN, LOW);
+}
+
+void release() {
+    touchDown = false;
+    setPin(TOUCH_IRQ_PIN, HIGH);
+}
+
+void touchRaw(bool* down, int16_t* x, int16_t* y, int16_t* z) {
+    *down = touchDown;
+    *x = rawX; *y = rawY; *z = touchDown ? Z_PRESSED : 0;
+}
+}
+
+TS_Point XPT2046_Touchscreen::getPoint() {
+    if(!touchDown) return TS_Point(0, 0, 0);
+    return TS_Point(rawX, rawY, Z_PRESSED);
+}
+
+bool XPT2046_Touchscreen::tirqTouched() {
+    if(touchEdge) { touchEdge = false; isrWake = true; }
+    return isrWake || touchDown;
+}
+
+bool XPT2046_Touchscreen::touched() { return touchDown; }
+
+void XPT2046_Touchscreen::readData(uint16_t* x, uint16_t* y, uint8_t* z) {
+    TS_Point p = getPoint();
+    *x = p.x; *y = p.y; *z = (uint8_t)(p.z > 255 ? 255 : p.z);
+}
@@ -0,0 +1,361 @@
+// Host microbenchmarks for the firmware's hot paths. main.cpp is compiled
+// into this file, so the benches call the same parser, renderers, graphs
+// and ingestion loops the device runs, against the stand-in libraries.
+//
+//   thinga_bench [--filter TEXT] [--baseline FILE] [--write FILE]
+//
+// Display benches report what one operation costs on the panel bus, counted
+// the way thinga_sim counts it: pixels, SPI bytes and address windows per
+// op, flush included. Those are exact and the same on every machine, so any
+// increase over the baseline is a regression and the exit status is 1.
+//
+// Throughput (ops/s) is host CPU time, only comparable with a baseline
+// recorded on the same machine: record one before a change (--write), run
+// again after it (--baseline). A drop of more than BENCH_SLOWER_PCT is
+// flagged but doesn't fail the run. host/bench_baseline.txt is the
+// committed reference.
+#include "main.cpp"
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "sim.h"
+
+#define BENCH_MIN_MS      150    // per timing repetition
+#define BENCH_REPS        3      // best of
+#define BENCH_DRAW_ITERS  64
+#define BENCH_APS         256    // distinct BSSIDs in the synthetic frame set
+#define BENCH_SLOWER_PCT  20
+
+struct Metric {
+    std::string bench, name;
+    double value;
+    bool exact;          // machine-independent; lower is better
+};
+static std::vector<Metric> results;
+static const char* filter = nullptr;
+
+static bool selected(const char* bench) { return !filter || strstr(bench, filter); }
+
+// Best of BENCH_REPS runs of `op` (which does opsPerCall operations), in ops/s
+template <class Op>
+static void timeOps(const char* bench, const char* unit, uint32_t opsPerCall, Op op) {
+    using clock = std::chrono::steady_clock;
+    double best = 0;
+    for(int rep = 0; rep < BENCH_REPS; rep++) {
+        uint64_t calls = 0;
+        clock::time_point start = clock::now();
+        double secs;
+        do {
+            op();
+            calls++;
+            secs = std::chrono::duration<double>(clock::now() - start).count();
+        } while(secs * 1000 < BENCH_MIN_MS);
+        double rate = calls * opsPerCall / secs;
+        if(rate > best) best = rate;
+    }
+    results.push_back({ bench, unit, best, false });
+}
+
+// Bus cost and speed of `op` followed by a flush. prep(i) sets up iteration
+// i and is neither counted nor timed. Iterations run in whole blocks of
+// BENCH_DRAW_ITERS with i repeating, so however many blocks the timing
+// needs, the bench leaves the display in the same state.
+template <class Prep, class Op>
+static void drawCost(const char* bench, Prep prep, Op op) {
+    using clock = std::chrono::steady_clock;
+    uint64_t pixels = 0, spi = 0, windows = 0;
+    double secs = 0;
+    uint32_t iters = 0;
+    for(; iters % BENCH_DRAW_ITERS || secs * 1000 < BENCH_MIN_MS; iters++) {
+        uint32_t i = iters % BENCH_DRAW_ITERS;
+        prep(i);
+        flushDisplay();
+        sim::DrawStats before = sim::drawStats();
+        clock::time_point start = clock::now();
+        op(i);
+        flushDisplay();
+        secs += std::chrono::duration<double>(clock::now() - start).count();
+        if(iters < BENCH_DRAW_ITERS) {   // the counted window is fixed, so the figures are exact
+            sim::DrawStats d = sim::drawStats() - before;
+            pixels += d.pixels; spi += d.spiBytes; windows += d.windows;
+        }
+    }
+    results.push_back({ bench, "px/op", (double)pixels / BENCH_DRAW_ITERS, true });
+    results.push_back({ bench, "spi_bytes/op", (double)spi / BENCH_DRAW_ITERS, true });
+    results.push_back({ bench, "windows/op", (double)windows / BENCH_DRAW_ITERS, true });
+    results.push_back({ bench, "ops/s", iters / secs, false });
+}
+
+/* ================== SYNTHETIC INPUT ================== */
+// Beacons and probe responses for BENCH_APS networks with the mix of
+// elements seen in the wild: SSID (some hidden), rates, DS params, RSN or
+// WPA, HT operation, WPS and other vendor elements.
+struct BenchFrame {
+    alignas(4) uint8_t buf[sizeof(wifi_promiscuous_pkt_t) + 320];
+    wifi_promiscuous_pkt_t* pkt() { return (wifi_promiscuous_pkt_t*)buf; }
+};
+static BenchFrame frames[BENCH_APS];
+
+static void buildFrames() {
+    for(int i = 0; i < BENCH_APS; i++) {
+        BenchFrame& bf = frames[i];
+        memset(bf.buf, 0, sizeof(bf.buf));
+        wifi_promiscuous_pkt_t* pkt = bf.pkt();
+        uint8_t* f = pkt->payload;
+        uint8_t bssid[6] = { 0x02, 0x11, 0x22, (uint8_t)(i >> 8), (uint8_t)i, (uint8_t)(i * 7) };
+        f[0] = (i % 5 == 4) ? 0x50 : 0x80;              // every fifth a probe response
+        memset(f + 4, 0xFF, 6);
+        memcpy(f + 10, bssid, 6);
+        memcpy(f + 16, bssid, 6);
+        f[32] = 0x64;                                   // beacon interval 100 TU
+        f[34] = 0x11; f[35] = 0x04;
+        uint8_t* p = f + 36;
+        char ssid[33];
+        int sl = (i % 11 == 0) ? 0 : snprintf(ssid, sizeof(ssid), "bench-net-%03d%s", i, (i & 3) ? "" : "-guest-5g");
+        *p++ = 0; *p++ = (uint8_t)sl; memcpy(p, ssid, sl); p += sl;
+        static const uint8_t rates[] = { 1, 8, 0x82, 0x84, 0x8B, 0x96, 0x0C, 0x12, 0x18, 0x24 };
+        memcpy(p, rates, sizeof(rates)); p += sizeof(rates);
+        uint8_t ch = 1 + i % 13;
+        *p++ = 3; *p++ = 1; *p++ = ch;
+        if(i % 4 != 3) {
+            uint8_t akm = (i % 4 == 2) ? 8 : 2;
+            const uint8_t rsn[] = { 48, 20, 1, 0, 0x00, 0x0F, 0xAC, 4, 1, 0, 0x00, 0x0F, 0xAC, 4, 1, 0, 0x00, 0x0F, 0xAC, akm, 0, 0 };
+            memcpy(p, rsn, sizeof(rsn)); p += sizeof(rsn);
+        } else if(i % 8 == 7) {
+            const uint8_t wpa[] = { 221, 22, 0x00, 0x50, 0xF2, 1, 1, 0, 0x00, 0x50, 0xF2, 2, 1, 0, 0x00, 0x50, 0xF2, 2, 1, 0, 0x00, 0x50, 0xF2, 2 };
+            memcpy(p, wpa, sizeof(wpa)); p += sizeof(wpa);
+        }
+        uint8_t ht[24] = { 61, 22, ch };
+        memcpy(p, ht, sizeof(ht)); p += sizeof(ht);
+        const uint8_t wps[] = { 221, 9, 0x00, 0x50, 0xF2, 4, 0x10, 0x4A, 0, 1, 0x10 };
+        if(i % 3 == 0) { memcpy(p, wps, sizeof(wps)); p += sizeof(wps); }
+        const uint8_t vendor[] = { 221, 9, 0x00, 0x10, 0x18, 2, 0, 0, 0x1C, 0, 0 };
+        memcpy(p, vendor, sizeof(vendor)); p += sizeof(vendor);
+        pkt->rx_ctrl.rssi = -40 - (i * 13) % 50;
+        pkt->rx_ctrl.channel = ch;
+        pkt->rx_ctrl.sig_len = (uint16_t)(p - f) + 4;   // + FCS
+    }
+}
+
+static void fillList(int variant) {
+    listCount = listWindowCount = LIST_WINDOW;
+    listFirst = 0;
+    for(int i = 0; i < listCount; i++) {
+        snprintf(listWindow[i].label, sizeof(listWindow[i].label), "%s-%02d", variant ? "office" : "home", i);
+        snprintf(listWindow[i].detail, sizeof(listWindow[i].detail), "%2d WPA2", 1 + i % 13);
+        listWindow[i].value = -40 - (i * 7 + variant * 3) % 50;
+    }
+}
+
+/* ================== BENCHES ================== */
+static volatile uint32_t sink;
+
+static void benchParser() {
+    if(selected("parse/beacon")) timeOps("parse/beacon", "frames/s", BENCH_APS, [] {
+        BeaconInfo info;
+        for(int i = 0; i < BENCH_APS; i++) {
+            const wifi_promiscuous_pkt_t* pkt = frames[i].pkt();
+            sink += parseBeacon(pkt->payload, pkt->rx_ctrl.sig_len - 4, info) + info.security;
+        }
+    });
+    if(selected("callback/sniffer")) {
+        apCount = 0;
+        timeOps("callback/sniffer", "frames/s", BENCH_APS, [] {
+            for(int i = 0; i < BENCH_APS; i++) sniffer_callback(frames[i].buf, WIFI_PKT_MGMT);
+        });
+    }
+    if(selected("callback/survey")) timeOps("callback/survey", "frames/s", BENCH_APS, [] {
+        for(int i = 0; i < BENCH_APS; i++) {
+            if(i % 32 == 0) surveyRing.clear();
+            survey_callback(frames[i].buf, WIFI_PKT_MGMT);
+        }
+    });
+}
+
+static void benchIngest() {
+    static SurveyRecord records[BENCH_APS];
+    for(int i = 0; i < BENCH_APS; i++) {
+        const wifi_promiscuous_pkt_t* pkt = frames[i].pkt();
+        parseBeacon(pkt->payload, pkt->rx_ctrl.sig_len - 4, records[i].info);
+        memcpy(records[i].bssid, pkt->payload + 16, 6);
+        records[i].rssi = pkt->rx_ctrl.rssi;
+        records[i].rxChannel = pkt->rx_ctrl.channel;
+    }
+    if(selected("ingest/survey")) {
+        surveyAPs.clear();
+        surveyRing.clear();
+        timeOps("ingest/survey", "records/s", 32, [] {
+            static int next = 0;
+            for(int i = 0; i < 32; i++, next = (next + 1) % BENCH_APS) surveyRing.push(records[next]);
+            drainSurveyRing();
+        });
+    }
+    if(selected("ingest/wifi_merge")) {
+        int n = WiFi.scanNetworks(false, false, false, WIFI_SCAN_DWELL_MS, 0);
+        wifiNets.clear(); wifiSsids.clear();
+        timeOps("ingest/wifi_merge", "results/s", n > 0 ? n : 1, [n] { mergeWiFiResults(n); });
+        WiFi.scanDelete();
+    }
+    if(selected("ingest/ble")) {
+        bleDevices.clear(); bleNames.clear();
+        timeOps("ingest/ble", "adverts/s", 32, [] {
+            static int next = 0;
+            for(int i = 0; i < 32; i++, next = (next + 1) % 100) {
+                BleAdvRecord rec = { { 0xC0, 0xFF, 0xEE, 0x00, (uint8_t)(next >> 8), (uint8_t)next }, (int8_t)(-50 - next % 40), 0, "" };
+                if(next % 3 == 0) snprintf(rec.name, sizeof(rec.name), "tag-%d", next);
+                bleAdvRing.push(rec);
+            }
+            updateBleTracker();
+        });
+    }
+    if(selected("snapshot/survey")) {
+        surveyAPs.clear();
+        for(int i = 0; i < BENCH_APS; i++) { surveyRing.push(records[i]); if(i % 32 == 31) drainSurveyRing(); }
+        listSortBy = SORT_RSSI;
+        if(selected("snapshot/survey_list")) timeOps("snapshot/survey_list", "builds/s", 1, [] { rebuildSurveyList(listOut); });
+        listSortBy = SORT_NAME;
+        if(selected("snapshot/survey_name")) timeOps("snapshot/survey_name", "builds/s", 1, [] { rebuildSurveyList(listOut); });
+        listSortBy = SORT_FOUND;
+    }
+    if(selected("snapshot/ble_list")) timeOps("snapshot/ble_list", "builds/s", 1, [] { rebuildBLEList(listOut); });
+}
+
+static void benchDraw() {
+    if(selected("draw/home")) {
+        homePageIndex = 0;
+        drawCost("draw/home", [](uint32_t) { drawSettings(); }, [](uint32_t) { drawHome(); });
+    }
+    if(selected("draw/list")) {
+        currentPage = PAGE_WIFI;
+        fillList(0);
+        drawWiFiPage();
+        flushDisplay();
+        scrollOffset = 0;
+        if(selected("draw/list_replace"))
+            drawCost("draw/list_replace", [](uint32_t i) { fillList(i & 1); }, [](uint32_t) { drawListItems(); });
+        fillList(0);
+        drawListItems();
+        if(selected("draw/list_scroll"))
+            drawCost("draw/list_scroll", [](uint32_t i) { scrollOffset = i & 1; }, [](uint32_t) { drawListItems(); });
+        scrollOffset = 0;
+        drawListItems();
+        if(selected("draw/list_steady"))
+            drawCost("draw/list_steady", [](uint32_t) {}, [](uint32_t) { drawListItems(); });
+    }
+}
+
+static void benchGraphs() {
+    if(selected("graph/pkt_tick")) {
+        currentPage = PAGE_PACKET;
+        pktRateHistory.clear();
+        drawPacketUI();
+        drawCost("graph/pkt_tick", [](uint32_t) {}, [](uint32_t i) {
+            PacketTick t = {};
+            t.rate = 300 + (uint32_t)(250 * sin(i * 0.3)) + (i % 7) * 20;
+            t.total = 1000 + i * t.rate / 4;
+            t.dropped = i / 16;
+            t.channel = wifiChannel;
+            t.breakdown = (i % 4) == 3;
+            t.windowTotal = t.rate;
+            for(int c = 0; c < FCAT_COUNT; c++) t.cat[c] = t.rate * (c + 1 + i % 3) / (FCAT_COUNT * 3);
+            showPacketTick(t);
+        });
+    }
+    if(selected("graph/heap")) {
+        currentPage = PAGE_SYSTEM;
+        heapHistory.clear();
+        drawSystemStatic();
+        drawCost("graph/heap", [](uint32_t) {}, [](uint32_t i) {
+            heapHistory.push(180000 + (uint32_t)(12000 * sin(i * 0.2)) + (i % 5) * 900);
+            if(heapGraph.show(tft, heapHistory, false)) drawGraphRange(52, 95, "", heapHistory, "KB");
+        });
+    }
+}
+
+/* ================== BASELINE ================== */
+static std::string key(const Metric& m) { return m.bench + " " + m.name; }
+
+static std::map<std::string, double> loadBaseline(const char* path) {
+    std::map<std::string, double> base;
+    std::ifstream in(path);
+    std::string line;
+    while(std::getline(in, line)) {
+        if(line.empty() || line[0] == '#') continue;
+        std::istringstream ls(line);
+        std::string bench, name;
+        double v;
+        if(ls >> bench >> name >> v) base[bench + " " + name] = v;
+    }
+    return base;
+}
+
+static bool writeBaseline(const char* path) {
+    FILE* f = fopen(path, "w");
+    if(!f) return false;
+    fprintf(f, "# thinga_bench baseline: bench metric value\n");
+    fprintf(f, "# px/spi_bytes/windows are exact; rates are host CPU time and machine-specific\n");
+    for(const Metric& m : results) fprintf(f, "%s %s %.6g\n", m.bench.c_str(), m.name.c_str(), m.value);
+    fclose(f);
+    return true;
+}
+
+static std::string human(double v, bool exact) {
+    char buf[32];
+    if(exact) snprintf(buf, sizeof(buf), "%.1f", v);
+    else if(v >= 1e6) snprintf(buf, sizeof(buf), "%.2fM", v / 1e6);
+    else if(v >= 1e3) snprintf(buf, sizeof(buf), "%.1fk", v / 1e3);
+    else snprintf(buf, sizeof(buf), "%.0f", v);
+    return buf;
+}
+
+int main(int argc, char** argv) {
+    const char* baselinePath = nullptr;
+    const char* writePath = nullptr;
+    for(int i = 1; i < argc; i++) {
+        if(!strcmp(argv[i], "--filter") && i + 1 < argc) filter = argv[++i];
+        else if(!strcmp(argv[i], "--baseline") && i + 1 < argc) baselinePath = argv[++i];
+        else if(!strcmp(argv[i], "--write") && i + 1 < argc) writePath = argv[++i];
+        else {
+            fprintf(stderr, "usage: %s [--filter TEXT] [--baseline FILE] [--write FILE]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    setup();
+    buildFrames();
+    benchParser();
+    benchIngest();
+    benchDraw();
+    benchGraphs();
+
+    std::map<std::string, double> base;
+    if(baselinePath) base = loadBaseline(baselinePath);
+    int worse = 0;
+    printf("%-22s %-14s %12s %12s  %s\n", "bench", "metric", "value", "baseline", "change");
+    for(const Metric& m : results) {
+        std::string verdict, was;
+        auto it = base.find(key(m));
+        if(it != base.end()) {
+            double b = it->second;
+            was = human(b, m.exact);
+            if(m.exact) {
+                if(fabs(m.value - b) < 0.05) verdict = "=";
+                else { verdict = m.value < b ? "better" : "WORSE"; if(m.value > b) worse++; }
+            } else {
+                double pct = b > 0 ? (m.value - b) * 100 / b : 0;
+                char buf[32];
+                snprintf(buf, sizeof(buf), "%+.0f%%%s", pct, pct < -BENCH_SLOWER_PCT ? " SLOWER?" : "");
+                verdict = buf;
+            }
+        }
+        printf("%-22s %-14s %12s %12s  %s\n", m.bench.c_str(), m.name.c_str(), human(m.value, m.exact).c_str(),
+               was.c_str(), verdict.c_str());
+    }
+    if(writePath && !writeBaseline(writePath)) { fprintf(stderr, "cannot write %s\n", writePath); return 2; }
+    if(worse) printf("%d display cost(s) above the baseline\n", worse);
+    return worse ? 1 : 0;
+}
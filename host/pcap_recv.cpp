@@ -0,0 +1,118 @@
+// Receiver for the PKT_MON pcap stream: reads the device's Serial output
+// (a tty, a file captured with thinga_sim --serial-out, or stdin), skips
+// any debug text before the pcap header and writes a clean .pcap file.
+//
+//   pcap_recv [--baud N] [--count N] INPUT OUTPUT.pcap
+//
+// INPUT of "-" reads stdin. Stops at end of input, after --count frames,
+// or at the first record header that does not make sense (stream ended and
+// text resumed).
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <vector>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+
+static uint32_t getLE32(const uint8_t* p) { return p[0] | (p[1] << 8) | (p[2] << 16) | ((uint32_t)p[3] << 24); }
+
+static speed_t baudConstant(long baud) {
+    switch(baud) {
+        case 115200: return B115200;
+        case 230400: return B230400;
+        case 460800: return B460800;
+        case 921600: return B921600;
+        case 1000000: return B1000000;
+        case 2000000: return B2000000;
+        default: return 0;
+    }
+}
+
+static bool setRaw(int fd, long baud) {
+    struct termios tio;
+    if(tcgetattr(fd, &tio) != 0) return false;  // not a tty, nothing to do
+    cfmakeraw(&tio);
+    speed_t s = baudConstant(baud);
+    if(!s) { fprintf(stderr, "unsupported baud %ld\n", baud); exit(2); }
+    cfsetispeed(&tio, s);
+    cfsetospeed(&tio, s);
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    return tcsetattr(fd, TCSANOW, &tio) == 0;
+}
+
+static bool readExact(int fd, uint8_t* buf, size_t n) {
+    while(n) {
+        ssize_t r = read(fd, buf, n);
+        if(r <= 0) return false;
+        buf += r; n -= r;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    long baud = 921600;
+    long maxFrames = -1;
+    const char* inPath = nullptr;
+    const char* outPath = nullptr;
+    for(int i = 1; i < argc; i++) {
+        if(!strcmp(argv[i], "--baud") && i + 1 < argc) baud = atol(argv[++i]);
+        else if(!strcmp(argv[i], "--count") && i + 1 < argc) maxFrames = atol(argv[++i]);
+        else if(!inPath) inPath = argv[i];
+        else if(!outPath) outPath = argv[i];
+        else { fprintf(stderr, "unexpected argument %s\n", argv[i]); return 2; }
+    }
+    if(!inPath || !outPath) {
+        fprintf(stderr, "usage: pcap_recv [--baud N] [--count N] INPUT OUTPUT.pcap\n");
+        return 2;
+    }
+
+    int fd = strcmp(inPath, "-") ? open(inPath, O_RDONLY | O_NOCTTY) : 0;
+    if(fd < 0) { perror(inPath); return 1; }
+    if(isatty(fd) && !setRaw(fd, baud)) { perror("tcsetattr"); return 1; }
+    FILE* out = fopen(outPath, "wb");
+    if(!out) { perror(outPath); return 1; }
+
+    // --- sync on the pcap magic (d4 c3 b2 a1 on the wire) ---
+    uint8_t hdr[24] = {0};
+    size_t skipped = 0;
+    while(getLE32(hdr) != 0xA1B2C3D4) {
+        memmove(hdr, hdr + 1, 3);
+        if(!readExact(fd, hdr + 3, 1)) { fprintf(stderr, "no pcap header found (%zu bytes read)\n", skipped); return 1; }
+        skipped++;
+    }
+    skipped -= 4;
+    if(!readExact(fd, hdr + 4, 20)) { fprintf(stderr, "truncated pcap header\n"); return 1; }
+    uint32_t snaplen = getLE32(hdr + 16);
+    uint32_t linktype = getLE32(hdr + 20);
+    fwrite(hdr, 1, sizeof(hdr), out);
+    fprintf(stderr, "synced after %zu bytes: snaplen %u, linktype %u\n", skipped, snaplen, linktype);
+
+    // --- records ---
+    std::vector<uint8_t> frame(snaplen);
+    long frames = 0;
+    unsigned long long bytes = 0;
+    uint32_t firstSec = 0, lastSec = 0;
+    while(maxFrames < 0 || frames < maxFrames) {
+        uint8_t rec[16];
+        if(!readExact(fd, rec, sizeof(rec))) break;
+        uint32_t sec = getLE32(rec), usec = getLE32(rec + 4);
+        uint32_t incl = getLE32(rec + 8), orig = getLE32(rec + 12);
+        if(usec >= 1000000 || incl > snaplen || incl > orig || incl == 0) {
+            fprintf(stderr, "bad record header after %ld frames, stopping\n", frames);
+            break;
+        }
+        if(!readExact(fd, frame.data(), incl)) { fprintf(stderr, "truncated frame, dropped\n"); break; }
+        fwrite(rec, 1, sizeof(rec), out);
+        fwrite(frame.data(), 1, incl, out);
+        if(!frames) firstSec = sec;
+        lastSec = sec;
+        frames++;
+        bytes += incl;
+    }
+    fclose(out);
+    fprintf(stderr, "%ld frames, %llu bytes captured over ~%us\n", frames, bytes, lastSec - firstSec);
+    return 0;
+}
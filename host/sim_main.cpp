@@ -0,0 +1,222 @@
+// Host simulator driver: runs main.cpp's setup()/loop() against the
+// stand-in libraries and reports what each step cost on the display bus.
+//
+//   thinga_sim [--script FILE] [--trace] [--serial] [--serial-out FILE] [--fs DIR]
+//
+// Script lines (default scenario below when no script is given):
+//   tap X Y        press, hold for 40 ms of loop() passes, release
+//   press X Y      hold a touch until 'release' (moves it if already down)
+//   release
+//   drag X0 Y0 X1 Y1 MS   press, slide in a straight line over MS, release
+//   run MS         call loop() until MS of virtual time have passed
+//   connect | disconnect     BLE HID link up/down
+//   shot FILE      write the panel contents as a PPM
+//   checksum       print a hash of the panel contents
+//   allocs         operator new calls since the last 'allocs', and live heap blocks
+//   hid            HID reports sent since the last 'hid': time and usage (0 = release)
+//   serial TEXT    type TEXT and a newline into the serial port
+//   serialhex HEX  send raw bytes into the serial port (telem_recv --hex makes command frames)
+//   # ...          comment
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "Arduino.h"
+#include "sim.h"
+#include "alloc_stats.h"
+
+void setup();
+void loop();
+
+static const char* defaultScenario =
+    "# boot is measured as the first step\n"
+    "run 500\n"
+    "tap 55 85\n"      // MEDIA
+    "run 300\n"
+    "connect\n"
+    "tap 160 130\n"    // play/pause
+    "run 300\n"
+    "tap 20 40\n"      // back
+    "run 300\n"
+    "tap 160 85\n"     // WIFI
+    "run 300\n"
+    "tap 300 170\n"    // scroll down
+    "run 200\n"
+    "tap 300 100\n"    // scroll up
+    "run 200\n"
+    "tap 20 40\n"
+    "run 300\n"
+    "tap 265 85\n"     // CONF
+    "run 300\n"
+    "tap 125 120\n"    // green theme
+    "run 300\n"
+    "tap 50 120\n"     // back to cyan
+    "run 300\n"
+    "tap 20 40\n"
+    "run 300\n"
+    "tap 55 175\n"     // SYSTEM
+    "run 3000\n"
+    "tap 20 40\n"
+    "run 300\n"
+    "tap 160 175\n"    // BLE
+    "run 300\n"
+    "tap 20 40\n"
+    "run 300\n"
+    "tap 265 175\n"    // PKT_MON
+    "run 3000\n"
+    "tap 270 70\n"     // channel up
+    "run 2000\n"
+    "tap 20 40\n"
+    "run 300\n"
+    "tap 285 225\n"    // home page 2
+    "run 300\n"
+    "tap 35 225\n"     // home page 1
+    "run 300\n"
+    "checksum\n";
+
+static const unsigned long tapHoldMs = 40;   // a quick finger tap
+
+static sim::DrawStats lastStats;
+static unsigned long lastMs = 0;
+static bool traceCalls = false;
+
+static void report(const std::string& step) {
+    sim::DrawStats now = sim::drawStats();
+    sim::DrawStats d = now - lastStats;
+    unsigned long ms = millis();
+    printf("%-22s %8lu %7u %7u %9llu %10llu\n", step.c_str(), ms - lastMs, d.calls, d.windows,
+           (unsigned long long)d.pixels, (unsigned long long)d.spiBytes);
+    if(traceCalls) {
+        for(const sim::DrawCall& c : sim::drawCalls())
+            printf("    %-14s %4d %4d %4d %4d  px=%-6u spi=%u\n", c.op, c.x, c.y, c.w, c.h, c.pixels, c.spiBytes);
+        sim::clearDrawCalls();
+    }
+    lastStats = now;
+    lastMs = ms;
+}
+
+static void runFor(unsigned long ms) {
+    unsigned long start = millis();
+    while(millis() - start < ms) {
+        loop();
+        sim::advance(1);
+    }
+}
+
+static bool runScript(std::istream& in) {
+    std::string line;
+    int lineNo = 0;
+    while(std::getline(in, line)) {
+        lineNo++;
+        std::istringstream ls(line);
+        std::string cmd;
+        if(!(ls >> cmd) || cmd[0] == '#') continue;
+        if(cmd == "tap" || cmd == "press") {
+            int x, y;
+            if(!(ls >> x >> y)) { fprintf(stderr, "line %d: %s needs X Y\n", lineNo, cmd.c_str()); return false; }
+            sim::press(x, y);
+            if(cmd == "tap") { runFor(tapHoldMs); sim::release(); sim::advance(1); }
+            else loop();
+        } else if(cmd == "drag") {
+            int x0, y0, x1, y1;
+            unsigned long ms;
+            if(!(ls >> x0 >> y0 >> x1 >> y1 >> ms) || !ms) { fprintf(stderr, "line %d: drag needs X0 Y0 X1 Y1 MS\n", lineNo); return false; }
+            for(unsigned long t = 0; t <= ms; t++) {
+                sim::press(x0 + (long)(x1 - x0) * (long)t / (long)ms, y0 + (long)(y1 - y0) * (long)t / (long)ms);
+                loop();
+                sim::advance(1);
+            }
+            sim::release();
+        } else if(cmd == "release") {
+            sim::release();
+            loop();
+        } else if(cmd == "run") {
+            unsigned long ms;
+            if(!(ls >> ms)) { fprintf(stderr, "line %d: run needs MS\n", lineNo); return false; }
+            runFor(ms);
+        } else if(cmd == "connect" || cmd == "disconnect") {
+            sim::bleConnect(cmd == "connect");
+        } else if(cmd == "shot") {
+            std::string path;
+            ls >> path;
+            if(!sim::savePanelPPM(path.c_str())) { fprintf(stderr, "line %d: cannot write %s\n", lineNo, path.c_str()); return false; }
+        } else if(cmd == "allocs") {
+            static uint32_t lastNews = 0;
+            AllocStats a = allocStats();
+            printf("allocs: %u new since last, %u heap blocks\n", a.news - lastNews, a.heapBlocks);
+            lastNews = a.news;
+            continue;
+        } else if(cmd == "hid") {
+            static size_t lastReport = 0;
+            const std::vector<sim::HidReport>& log = sim::hidReports();
+            for(; lastReport < log.size(); lastReport++) {
+                const sim::HidReport& r = log[lastReport];
+                unsigned usage = r.data.size() >= 3 ? r.data[1] | r.data[2] << 8 : 0;
+                printf("hid %6lu ms  0x%03x\n", r.atMs, usage);
+            }
+            continue;
+        } else if(cmd == "serial") {
+            std::string text;
+            std::getline(ls >> std::ws, text);
+            text += '\n';
+            sim::serialInput((const uint8_t*)text.data(), text.size());
+            runFor(1);
+            continue;
+        } else if(cmd == "serialhex") {
+            std::string hex;
+            ls >> hex;
+            std::vector<uint8_t> bytes;
+            for(size_t i = 0; i + 1 < hex.size(); i += 2) bytes.push_back((uint8_t)strtoul(hex.substr(i, 2).c_str(), nullptr, 16));
+            sim::serialInput(bytes.data(), bytes.size());
+            runFor(1);
+            continue;
+        } else if(cmd == "checksum") {
+            printf("panel checksum %08x\n", sim::panelChecksum());
+            continue;
+        } else {
+            fprintf(stderr, "line %d: unknown command '%s'\n", lineNo, cmd.c_str());
+            return false;
+        }
+        report(line);
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* script = nullptr;
+    for(int i = 1; i < argc; i++) {
+        if(!strcmp(argv[i], "--script") && i + 1 < argc) script = argv[++i];
+        else if(!strcmp(argv[i], "--trace")) traceCalls = true;
+        else if(!strcmp(argv[i], "--serial")) sim::serialEcho(true);
+        else if(!strcmp(argv[i], "--serial-out") && i + 1 < argc) sim::serialCapture(argv[++i]);
+        else if(!strcmp(argv[i], "--fs") && i + 1 < argc) sim::fsRoot(argv[++i]);
+        else {
+            fprintf(stderr, "usage: %s [--script FILE] [--trace] [--serial] [--serial-out FILE] [--fs DIR]\n", argv[0]);
+            return 2;
+        }
+    }
+    sim::traceDrawCalls(traceCalls);
+
+    printf("%-22s %8s %7s %7s %9s %10s\n", "step", "ms", "calls", "windows", "pixels", "spi_bytes");
+    setup();
+    report("setup");
+
+    bool ok;
+    if(script) {
+        std::ifstream in(script);
+        if(!in) { fprintf(stderr, "cannot open %s\n", script); return 2; }
+        ok = runScript(in);
+    } else {
+        std::istringstream in(defaultScenario);
+        ok = runScript(in);
+    }
+
+    sim::RadioStats r = sim::radioStats();
+    printf("radio: %llu frames delivered, %u wifi scans, %u ble scans, %zu hid reports, %lu String allocs\n",
+           (unsigned long long)r.framesDelivered, r.wifiScans, r.bleScans, sim::hidReports().size(), sim::stringAllocs());
+    printf("radio: %u wifi driver inits, %u wifi mode changes, %u channel switches\n",
+           r.wifiDriverInits, r.wifiModeChanges, r.channelSwitches);
+    return ok ? 0 : 1;
+}
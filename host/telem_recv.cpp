@@ -0,0 +1,291 @@
+// Client for the telemetry stream (telemetry.h): decodes the device's frames
+// to CSV or JSON lines and sends it commands.
+//
+//   telem_recv [--baud N] [--start [PERIOD_MS]] [--cmd "CMD [ARG]"]... [--json] [--count N] INPUT [OUTPUT]
+//   telem_recv --hex "CMD [ARG]"
+//
+// CMD is ping, rate MS, channel N, scan, page N, list FIRST COUNT or stop. --start types
+// "telem PERIOD_MS" on the text console at 115200 baud first. A tty INPUT is
+// opened read/write so --start and --cmd can reach the device; INPUT of "-"
+// reads stdin, and a file captured with thinga_sim --serial-out works too.
+// Text before the first frame is skipped. --hex prints a command frame as
+// hex, for thinga_sim's serialhex.
+//
+// CSV has one line per message, first column the message type; LIST rows
+// follow their list line as "row" lines. Pages answering "list" have paged 1
+// and that command's seq; their rows are numbered from the page's first, so
+// concatenating them gives the whole list. The column names are printed as
+// "# type,..." comments up front. Ends at end of input or after --count
+// frames, with a summary on stderr.
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <termios.h>
+#include <unistd.h>
+#include "telemetry.h"
+#include "frame_stats.h"
+
+static speed_t baudConstant(long baud) {
+    switch(baud) {
+        case 115200: return B115200;
+        case 230400: return B230400;
+        case 460800: return B460800;
+        case 921600: return B921600;
+        case 1000000: return B1000000;
+        case 2000000: return B2000000;
+        default: return 0;
+    }
+}
+
+static bool setRaw(int fd, long baud) {
+    struct termios tio;
+    if(tcgetattr(fd, &tio) != 0) return false;
+    cfmakeraw(&tio);
+    speed_t s = baudConstant(baud);
+    if(!s) { fprintf(stderr, "unsupported baud %ld\n", baud); exit(2); }
+    cfsetispeed(&tio, s);
+    cfsetospeed(&tio, s);
+    tio.c_cc[VMIN] = 1;
+    tio.c_cc[VTIME] = 0;
+    return tcsetattr(fd, TCSADRAIN, &tio) == 0;
+}
+
+static bool writeAll(int fd, const uint8_t* p, size_t n) {
+    while(n) {
+        ssize_t w = write(fd, p, n);
+        if(w <= 0) return false;
+        p += w; n -= w;
+    }
+    return true;
+}
+
+// "channel 6" -> one frame; 0 if the command is not understood
+static size_t encodeCommand(const char* text, uint16_t seq, uint8_t* out) {
+    char name[16] = "";
+    long arg = 0, arg2 = 0;
+    int n = sscanf(text, "%15s %ld %ld", name, &arg, &arg2);
+    TelemWriter w;
+    uint8_t type;
+    if(!strcmp(name, "ping")) type = TC_PING;
+    else if(!strcmp(name, "scan")) type = TC_SCAN;
+    else if(!strcmp(name, "stop")) type = TC_STOP;
+    else if(!strcmp(name, "rate") && n == 2) { type = TC_RATE; w.u16(arg); }
+    else if(!strcmp(name, "channel") && n == 2) { type = TC_CHANNEL; w.u8(arg); }
+    else if(!strcmp(name, "page") && n == 2) { type = TC_PAGE; w.u8(arg); }
+    else if(!strcmp(name, "list") && n == 3) { type = TC_LIST; w.u16(arg); w.u16(arg2); }
+    else return 0;
+    return telemEncode(type, seq, 0, w.buf, w.len, out);
+}
+
+// --- output ---
+static bool json = false;
+static FILE* out = stdout;
+
+static std::string csvField(const char* s) {
+    if(!strpbrk(s, ",\"\n")) return s;
+    std::string q = "\"";
+    for(; *s; s++) { if(*s == '"') q += '"'; q += *s; }
+    return q + "\"";
+}
+
+static std::string jsonString(const char* s) {
+    std::string q = "\"";
+    for(; *s; s++) {
+        unsigned char c = *s;
+        if(c == '"' || c == '\\') { q += '\\'; q += c; }
+        else if(c < 0x20) { char e[8]; snprintf(e, sizeof(e), "\\u%04x", c); q += e; }
+        else q += c;
+    }
+    return q + "\"";
+}
+
+static const char* resultName(uint8_t r) {
+    static const char* const names[] = { "ok", "bad_arg", "refused", "unknown" };
+    return r < 4 ? names[r] : "?";
+}
+
+static void printColumns() {
+    if(json) return;
+    fprintf(out, "# hello,ms,seq,period_ms,page,firmware\n");
+    fprintf(out, "# status,ms,seq,free_heap,min_free_heap,loops,loop_avg_us,loop_max_us,page,tx_dropped\n");
+    fprintf(out, "# packets,ms,seq,rate,total,dropped,channel");
+    for(int i = 0; i < FCAT_COUNT; i++) fprintf(out, ",%s", FRAME_CATEGORY_LABELS[i]);
+    fprintf(out, "\n# list,ms,seq,mode,channel,live,rows,total,dropped,first,count,paged,command_seq\n");
+    fprintf(out, "# row,ms,seq,index,label,detail,value\n");
+    fprintf(out, "# ack,ms,seq,command,command_seq,result\n");
+}
+
+static void printFrame(const TelemFrame& f) {
+    TelemReader r(f.payload, f.len);
+    char a[256], b[256];
+    switch(f.type) {
+        case TM_HELLO: {
+            uint16_t period = r.u16(); uint8_t page = r.u8(); r.str(a, sizeof(a));
+            if(json) fprintf(out, "{\"type\":\"hello\",\"ms\":%u,\"seq\":%u,\"period_ms\":%u,\"page\":%u,\"firmware\":%s}\n",
+                             f.ms, f.seq, period, page, jsonString(a).c_str());
+            else fprintf(out, "hello,%u,%u,%u,%u,%s\n", f.ms, f.seq, period, page, csvField(a).c_str());
+            break;
+        }
+        case TM_STATUS: {
+            uint32_t heap = r.u32(), minHeap = r.u32(), loops = r.u32(), avg = r.u32(), mx = r.u32();
+            uint8_t page = r.u8(); uint32_t dropped = r.u32();
+            if(json) fprintf(out, "{\"type\":\"status\",\"ms\":%u,\"seq\":%u,\"free_heap\":%u,\"min_free_heap\":%u,\"loops\":%u,"
+                                  "\"loop_avg_us\":%u,\"loop_max_us\":%u,\"page\":%u,\"tx_dropped\":%u}\n",
+                             f.ms, f.seq, heap, minHeap, loops, avg, mx, page, dropped);
+            else fprintf(out, "status,%u,%u,%u,%u,%u,%u,%u,%u,%u\n", f.ms, f.seq, heap, minHeap, loops, avg, mx, page, dropped);
+            break;
+        }
+        case TM_PACKETS: {
+            uint32_t rate = r.u32(), total = r.u32(), dropped = r.u32();
+            uint8_t channel = r.u8(), n = r.u8();
+            std::vector<uint32_t> cat(FCAT_COUNT > n ? FCAT_COUNT : n);
+            for(int i = 0; i < n; i++) cat[i] = r.u32();
+            if(json) {
+                fprintf(out, "{\"type\":\"packets\",\"ms\":%u,\"seq\":%u,\"rate\":%u,\"total\":%u,\"dropped\":%u,\"channel\":%u,\"categories\":{",
+                        f.ms, f.seq, rate, total, dropped, channel);
+                for(int i = 0; i < n; i++) fprintf(out, "%s\"%s\":%u", i ? "," : "", i < FCAT_COUNT ? FRAME_CATEGORY_LABELS[i] : "?", cat[i]);
+                fprintf(out, "}}\n");
+            } else {
+                fprintf(out, "packets,%u,%u,%u,%u,%u,%u", f.ms, f.seq, rate, total, dropped, channel);
+                for(int i = 0; i < FCAT_COUNT; i++) fprintf(out, ",%u", cat[i]);
+                fprintf(out, "\n");
+            }
+            break;
+        }
+        case TM_LIST: {
+            uint8_t mode = r.u8(), channel = r.u8(), live = r.u8();
+            uint16_t rows = r.u16(), total = r.u16(); uint32_t dropped = r.u32(); uint16_t first = r.u16();
+            uint8_t n = r.u8();
+            // The paging fields come after the rows
+            struct Row { std::string label, detail; int16_t value; };
+            std::vector<Row> items;
+            for(int i = 0; i < n && r.ok; i++) {
+                r.str(a, sizeof(a)); r.str(b, sizeof(b));
+                int16_t value = (int16_t)r.u16();
+                items.push_back({ a, b, value });
+            }
+            uint8_t paged = r.u8(); uint16_t cmdSeq = r.u16();
+            if(json) {
+                fprintf(out, "{\"type\":\"list\",\"ms\":%u,\"seq\":%u,\"mode\":%u,\"channel\":%u,\"live\":%u,\"rows\":%u,"
+                             "\"total\":%u,\"dropped\":%u,\"first\":%u,\"paged\":%u,\"command_seq\":%u,\"items\":[",
+                        f.ms, f.seq, mode, channel, live, rows, total, dropped, first, paged, cmdSeq);
+                for(size_t i = 0; i < items.size(); i++)
+                    fprintf(out, "%s{\"label\":%s,\"detail\":%s,\"value\":%d}", i ? "," : "",
+                            jsonString(items[i].label.c_str()).c_str(), jsonString(items[i].detail.c_str()).c_str(), items[i].value);
+                fprintf(out, "]}\n");
+            } else {
+                fprintf(out, "list,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u\n", f.ms, f.seq, mode, channel, live, rows, total, dropped, first, n,
+                        paged, cmdSeq);
+                for(size_t i = 0; i < items.size(); i++)
+                    fprintf(out, "row,%u,%u,%u,%s,%s,%d\n", f.ms, f.seq, (unsigned)(first + i), csvField(items[i].label.c_str()).c_str(),
+                            csvField(items[i].detail.c_str()).c_str(), items[i].value);
+            }
+            break;
+        }
+        case TM_ACK: {
+            uint8_t cmd = r.u8(); uint16_t cmdSeq = r.u16(); uint8_t result = r.u8();
+            if(json) fprintf(out, "{\"type\":\"ack\",\"ms\":%u,\"seq\":%u,\"command\":%u,\"command_seq\":%u,\"result\":\"%s\"}\n",
+                             f.ms, f.seq, cmd, cmdSeq, resultName(result));
+            else fprintf(out, "ack,%u,%u,%u,%u,%s\n", f.ms, f.seq, cmd, cmdSeq, resultName(result));
+            break;
+        }
+        default:
+            if(json) fprintf(out, "{\"type\":\"unknown\",\"ms\":%u,\"seq\":%u,\"id\":%u,\"bytes\":%u}\n", f.ms, f.seq, f.type, f.len);
+            else fprintf(out, "unknown,%u,%u,%u,%u\n", f.ms, f.seq, f.type, f.len);
+            break;
+    }
+    if(!r.ok) fprintf(stderr, "seq %u: message type %u shorter than expected\n", f.seq, f.type);
+}
+
+int main(int argc, char** argv) {
+    long baud = 921600;
+    long maxFrames = -1;
+    long startPeriod = -1;
+    const char* inPath = nullptr;
+    const char* outPath = nullptr;
+    std::vector<const char*> commands;
+    for(int i = 1; i < argc; i++) {
+        if(!strcmp(argv[i], "--baud") && i + 1 < argc) baud = atol(argv[++i]);
+        else if(!strcmp(argv[i], "--count") && i + 1 < argc) maxFrames = atol(argv[++i]);
+        else if(!strcmp(argv[i], "--json")) json = true;
+        else if(!strcmp(argv[i], "--cmd") && i + 1 < argc) commands.push_back(argv[++i]);
+        else if(!strcmp(argv[i], "--start")) startPeriod = (i + 1 < argc && isdigit((unsigned char)argv[i + 1][0])) ? atol(argv[++i]) : 100;
+        else if(!strcmp(argv[i], "--hex") && i + 1 < argc) {
+            uint8_t frame[TELEM_MAX_WIRE];
+            size_t n = encodeCommand(argv[++i], 0, frame);
+            if(!n) { fprintf(stderr, "unknown command '%s'\n", argv[i]); return 2; }
+            for(size_t k = 0; k < n; k++) printf("%02x", frame[k]);
+            printf("\n");
+            return 0;
+        }
+        else if(!inPath) inPath = argv[i];
+        else if(!outPath) outPath = argv[i];
+        else { fprintf(stderr, "unexpected argument %s\n", argv[i]); return 2; }
+    }
+    if(!inPath) {
+        fprintf(stderr, "usage: telem_recv [--baud N] [--start [PERIOD_MS]] [--cmd \"CMD [ARG]\"]... [--json] [--count N] INPUT [OUTPUT]\n"
+                        "       telem_recv --hex \"CMD [ARG]\"\n"
+                        "CMD: ping | rate MS | channel N | scan | page N | list FIRST COUNT | stop\n");
+        return 2;
+    }
+
+    int fd = strcmp(inPath, "-") ? open(inPath, O_RDWR | O_NOCTTY) : 0;
+    if(fd < 0) fd = open(inPath, O_RDONLY);
+    if(fd < 0) { perror(inPath); return 1; }
+    bool tty = isatty(fd);
+    if(tty && !setRaw(fd, startPeriod >= 0 ? 115200 : baud)) { perror("tcsetattr"); return 1; }
+    if(outPath && !(out = fopen(outPath, "w"))) { perror(outPath); return 1; }
+    if((startPeriod >= 0 || !commands.empty()) && !tty) fprintf(stderr, "input is not a tty, --start/--cmd not sent\n");
+
+    if(tty && startPeriod >= 0) {
+        char line[32];
+        int n = snprintf(line, sizeof(line), "\ntelem %ld\n", startPeriod);
+        writeAll(fd, (const uint8_t*)line, n);
+        tcdrain(fd);
+        usleep(50000);   // the device switches baud after answering
+        if(!setRaw(fd, baud)) { perror("tcsetattr"); return 1; }
+    }
+    if(tty) {
+        uint16_t seq = 0;
+        for(const char* c : commands) {
+            uint8_t frame[TELEM_MAX_WIRE];
+            size_t n = encodeCommand(c, seq++, frame);
+            if(!n) { fprintf(stderr, "unknown command '%s'\n", c); return 2; }
+            writeAll(fd, frame, n);
+        }
+    }
+
+    printColumns();
+    TelemDecoder dec;
+    TelemFrame f;
+    long frames = 0;
+    unsigned long lost = 0;
+    bool haveSeq = false;
+    uint16_t nextSeq = 0;
+    uint8_t buf[4096];
+    while(maxFrames < 0 || frames < maxFrames) {
+        ssize_t r = read(fd, buf, sizeof(buf));
+        if(r <= 0) break;
+        for(ssize_t i = 0; i < r && (maxFrames < 0 || frames < maxFrames); i++) {
+            if(!dec.push(buf[i], f)) continue;
+            // HELLO starts a session and its seq over
+            if(haveSeq && f.type != TM_HELLO) lost += (uint16_t)(f.seq - nextSeq);
+            haveSeq = true;
+            nextSeq = f.seq + 1;
+            printFrame(f);
+            frames++;
+        }
+        fflush(out);
+    }
+    if(out != stdout) fclose(out);
+    const TelemDecoderStats& st = dec.stats();
+    // Text before the first frame counts as a bad frame (or an overrun)
+    fprintf(stderr, "%ld frames, %lu lost (seq gaps), %u bad, %u other version, %u overruns\n",
+            frames, lost, st.badFrames, st.otherVersion, st.overruns);
+    return 0;
+}
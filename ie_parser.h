@@ -0,0 +1,127 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+
+/* ================== 802.11 IE PARSER ================== */
+// One pass over the tagged parameters of a beacon or probe response. Every
+// element is checked against the end of the frame before it is read, so a
+// truncated or malformed frame stops the walk instead of running past the
+// buffer. Small and allocation-free enough to run in the promiscuous
+// callback.
+
+#define IE_SSID        0
+#define IE_DS_PARAMS   3
+#define IE_RSN         48
+#define IE_HT_OPER     61
+#define IE_VENDOR      221
+
+// BeaconInfo::security bits
+#define SEC_WEP   0x01
+#define SEC_WPA   0x02
+#define SEC_WPA2  0x04
+#define SEC_WPA3  0x08   // SAE
+#define SEC_ENT   0x10   // 802.1X key management
+
+struct BeaconInfo {
+    char ssid[33];
+    uint8_t ssidLen;
+    bool hidden;          // empty or zeroed SSID
+    uint8_t channel;      // from DS params / HT operation, 0 if absent
+    uint8_t security;
+    uint16_t beaconInterval;
+    bool wps;
+    uint8_t vendorIEs;    // vendor-specific elements seen
+    uint8_t vendorOui[3]; // first vendor OUI that isn't Microsoft's (WPA/WMM/WPS)
+};
+
+static inline const char* securityLabel(uint8_t sec) {
+    if((sec & SEC_WPA3) && (sec & SEC_WPA2)) return "WPA2/3";
+    if(sec & SEC_WPA3) return "WPA3";
+    if(sec & SEC_WPA2) return (sec & SEC_ENT) ? "WPA2-E" : "WPA2";
+    if(sec & SEC_WPA) return (sec & SEC_ENT) ? "WPA-E" : "WPA";
+    if(sec & SEC_WEP) return "WEP";
+    return "OPEN";
+}
+
+// Key management suites of an RSN or WPA element, as SEC_* bits:
+// PSK -> base, 802.1X -> base | SEC_ENT, SAE -> SEC_WPA3
+static inline uint8_t parseAkmSuites(const uint8_t* p, const uint8_t* end, const uint8_t* oui, uint8_t base) {
+    // group cipher (4), pairwise count + list, AKM count + list
+    if(p + 4 + 2 > end) return base;
+    p += 4;
+    uint16_t pairwise = p[0] | (p[1] << 8);
+    p += 2;
+    if(p + 4 * pairwise + 2 > end) return base;
+    p += 4 * pairwise;
+    uint16_t akms = p[0] | (p[1] << 8);
+    p += 2;
+    uint8_t sec = 0;
+    for(uint16_t i = 0; i < akms && p + 4 <= end; i++, p += 4) {
+        if(memcmp(p, oui, 3) != 0) continue;
+        if(p[3] == 1 || p[3] == 5) sec |= base | SEC_ENT;
+        else if(p[3] == 2 || p[3] == 6) sec |= base;
+        else if(p[3] == 8 || p[3] == 9) sec |= SEC_WPA3;
+    }
+    return sec ? sec : base;
+}
+
+// frame: 802.11 management frame starting at frame control, len without FCS.
+// Returns false if it isn't a beacon/probe response or is too short.
+static inline bool parseBeacon(const uint8_t* frame, uint16_t len, BeaconInfo& out) {
+    static const uint8_t OUI_IEEE[3] = {0x00, 0x0F, 0xAC};
+    static const uint8_t OUI_MS[3]   = {0x00, 0x50, 0xF2};
+    memset(&out, 0, sizeof(out));
+    if(len < 24 + 12) return false;
+    uint8_t subtype = frame[0] >> 4;
+    if((frame[0] & 0x0C) != 0 || (subtype != 8 && subtype != 5)) return false;
+
+    const uint8_t* fixed = frame + 24;
+    out.beaconInterval = fixed[8] | (fixed[9] << 8);
+    bool privacy = fixed[10] & 0x10;
+
+    const uint8_t* p = fixed + 12;
+    const uint8_t* end = frame + len;
+    uint8_t htChannel = 0;
+    while(p + 2 <= end) {
+        uint8_t id = p[0], n = p[1];
+        const uint8_t* body = p + 2;
+        if(body + n > end) break;   // truncated element: stop here
+        switch(id) {
+            case IE_SSID:
+                if(n <= 32) {
+                    memcpy(out.ssid, body, n);
+                    out.ssid[n] = 0;
+                    out.ssidLen = n;
+                    out.hidden = (n == 0 || body[0] == 0);
+                }
+                break;
+            case IE_DS_PARAMS:
+                if(n >= 1) out.channel = body[0];
+                break;
+            case IE_HT_OPER:
+                if(n >= 1) htChannel = body[0];
+                break;
+            case IE_RSN:
+                out.security |= (n >= 2) ? parseAkmSuites(body + 2, body + n, OUI_IEEE, SEC_WPA2) : SEC_WPA2;
+                break;
+            case IE_VENDOR:
+                if(n < 4) break;
+                out.vendorIEs++;
+                if(memcmp(body, OUI_MS, 3) == 0) {
+                    if(body[3] == 1) {   // WPA
+                        out.security |= (n >= 6) ? parseAkmSuites(body + 6, body + n, OUI_MS, SEC_WPA) : SEC_WPA;
+                    } else if(body[3] == 4) {
+                        out.wps = true;
+                    }
+                } else if(!out.vendorOui[0] && !out.vendorOui[1] && !out.vendorOui[2]) {
+                    memcpy(out.vendorOui, body, 3);
+                }
+                break;
+        }
+        p = body + n;
+    }
+    if(!out.channel) out.channel = htChannel;
+    if(out.ssidLen == 0) out.hidden = true;
+    if(privacy && !(out.security & (SEC_WPA | SEC_WPA2 | SEC_WPA3))) out.security |= SEC_WEP;
+    return true;
+}
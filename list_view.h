@@ -0,0 +1,90 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+
+/* ================== LIST VIEW ================== */
+// Sorted, filtered order over a table that keeps its entries in slots (a
+// MacTable): just the slot numbers, in display order. The table stays the
+// only copy of the data. Whoever shows the list formats the few rows around
+// the ones on screen from it, so a list can be as long as its table without
+// anything that holds list rows getting bigger.
+//
+// rebuild() takes a get(slot, ListKey&) callable that returns false for a
+// free slot and otherwise fills in what sorting and filtering look at. Each
+// entry is boiled down to a 32-bit key once, so the insertion sort compares
+// integers; only names that share their first four letters go back to get()
+// for a full compare. That is quick enough for the tables here (up to 256
+// slots). Entries that compare equal keep slot order.
+
+enum ListSort : uint8_t { SORT_FOUND, SORT_RSSI, SORT_NAME, SORT_AGE, SORT_COUNT };
+enum ListFilter : uint8_t { FILTER_ALL, FILTER_STRONG, FILTER_NAMED, FILTER_COUNT };
+#define LIST_STRONG_DBM  -70   // FILTER_STRONG keeps this and better
+
+struct ListKey {
+    int16_t rssi;           // dBm
+    uint32_t firstSeen;     // millis()
+    uint32_t lastSeen;
+    const char* name;       // "" when unnamed
+};
+
+template <uint16_t N>
+class ListView {
+public:
+    // now: millis(), the reference for the time-based sorts
+    template <class Get>
+    void rebuild(uint16_t slots, Get get, uint8_t sort, uint8_t filter, uint32_t now) {
+        count = 0;
+        ListKey k, o;
+        for(uint16_t s = 0; s < slots && count < N; s++) {
+            if(!get(s, k) || !keep(k, filter)) continue;
+            uint32_t key = sortKey(k, sort, now);
+            uint16_t j = count++;
+            while(j > 0 && (keys[j - 1] > key ||
+                            (keys[j - 1] == key && sort == SORT_NAME && key != UNNAMED && get(order[j - 1], o) &&
+                             strcasecmp(k.name, o.name) < 0))) {
+                order[j] = order[j - 1]; keys[j] = keys[j - 1]; j--;
+            }
+            order[j] = s;
+            keys[j] = key;
+        }
+    }
+
+    uint16_t size() const { return count; }
+    uint16_t slot(uint16_t row) const { return order[row]; }
+    static constexpr uint16_t capacity() { return N; }
+
+    static bool keep(const ListKey& k, uint8_t filter) {
+        switch(filter) {
+            case FILTER_STRONG: return k.rssi >= LIST_STRONG_DBM;
+            case FILTER_NAMED:  return k.name[0] != 0;
+            default:            return true;
+        }
+    }
+
+    // Ascending key = display order
+    static uint32_t sortKey(const ListKey& k, uint8_t sort, uint32_t now) {
+        switch(sort) {
+            case SORT_RSSI: return (uint32_t)(0x8000 - k.rssi);    // strongest first
+            case SORT_AGE:  return now - k.lastSeen;               // heard most recently first
+            case SORT_NAME: {
+                if(!k.name[0]) return UNNAMED;                     // unnamed last
+                uint32_t key = 0;
+                for(int i = 0, done = 0; i < 4; i++) {
+                    uint8_t c = done ? 0 : (uint8_t)k.name[i];
+                    if(!c) done = 1;
+                    if(c >= 'A' && c <= 'Z') c += 32;                // strcasecmp compares lower case
+                    key = (key << 8) | c;
+                }
+                return key >= UNNAMED ? UNNAMED - 1 : key;
+            }
+            default:        return ~(now - k.firstSeen);          // in the order found
+        }
+    }
+
+private:
+    static constexpr uint32_t UNNAMED = 0xFFFFFFFF;
+    uint16_t order[N];
+    uint32_t keys[N];      // sortKey() of order[i]
+    uint16_t count = 0;
+};
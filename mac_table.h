@@ -0,0 +1,144 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <type_traits>
+
+/* ================== MAC TABLE ================== */
+// Fixed-capacity table of up to N entries keyed by a 48-bit hardware address
+// (BLE device, BSSID). The entries are kept dense, in the order they were
+// added, so a table costs N entries and no empty slots; a separate index of
+// 2N-or-more 16-bit slots finds them by address with linear probing. Removal
+// closes the gap, so the entries after it move down one and the index is
+// renumbered in one pass. Nothing is allocated after construction.
+//
+// T must provide:
+//   uint8_t addr[6];    // the address
+//   lastSeen;           // any unsigned stamp that wraps (millis(), seconds
+//                       // in 16 bits ...), for eviction and expire()
+//
+// When the table is full, upsert() makes room by evicting the least recently
+// seen entry. upsert() and expire() take an optional gone(const T&), called
+// for each entry they drop just before it goes.
+
+template <typename T, uint16_t N>
+class MacTable {
+    using Stamp = decltype(T::lastSeen);
+    static_assert(std::is_unsigned<Stamp>::value, "lastSeen must be unsigned");
+
+    static constexpr uint16_t indexSize(uint16_t n = 4) { return n >= 2 * N ? n : indexSize(n * 2); }
+
+public:
+    static constexpr uint16_t LIMIT = N;
+    static constexpr uint16_t INDEX = indexSize();   // power of two, at most half full
+
+    MacTable() { clear(); }
+    void clear() { memset(index, 0, sizeof(index)); count = 0; evictions = 0; }
+
+    T* find(const uint8_t* addr) {
+        for(uint16_t i = home(addr); index[i]; i = (i + 1) & (INDEX - 1))
+            if(memcmp(slots[index[i] - 1].addr, addr, 6) == 0) return &slots[index[i] - 1];
+        return nullptr;
+    }
+
+    // Existing entry for addr, or a zeroed new one at the end (created = true)
+    template <class Gone>
+    T* upsert(const uint8_t* addr, bool& created, Gone gone) {
+        created = false;
+        if(T* e = find(addr)) return e;
+        if(count >= N) {
+            T* old = oldest();
+            gone(*old);
+            remove(old);
+            evictions++;
+        }
+        T* e = &slots[count++];
+        memset(e, 0, sizeof(T));
+        memcpy(e->addr, addr, 6);
+        link(count - 1);
+        created = true;
+        return e;
+    }
+    T* upsert(const uint8_t* addr, bool& created) { return upsert(addr, created, [](const T&) {}); }
+
+    void remove(T* e) {
+        if(!e) return;
+        uint16_t at = e - slots;
+        unlink(at);
+        memmove(&slots[at], &slots[at + 1], (count - at - 1) * sizeof(T));
+        count--;
+        for(uint16_t i = 0; i < INDEX; i++) if(index[i] > at + 1) index[i]--;
+    }
+
+    // Drops entries not seen for maxAge. Returns how many went.
+    template <class Gone>
+    uint16_t expire(Stamp now, Stamp maxAge, Gone gone) {
+        uint16_t kept = 0;
+        for(uint16_t i = 0; i < count; i++) {
+            if((Stamp)(now - slots[i].lastSeen) > maxAge) { gone(slots[i]); continue; }
+            if(kept != i) slots[kept] = slots[i];
+            kept++;
+        }
+        uint16_t removed = count - kept;
+        count = kept;
+        if(removed) reindex();
+        return removed;
+    }
+    uint16_t expire(Stamp now, Stamp maxAge) { return expire(now, maxAge, [](const T&) {}); }
+
+    // Iteration: for(i < capacity()) if(used(i)) ... at(i); entries in the
+    // order they were added
+    static constexpr uint16_t capacity() { return N; }
+    bool used(uint16_t i) const { return i < count; }
+    T& at(uint16_t i) { return slots[i]; }
+    const T& at(uint16_t i) const { return slots[i]; }
+    uint16_t size() const { return count; }
+    uint32_t evicted() const { return evictions; }
+
+private:
+    static uint16_t home(const uint8_t* addr) {
+        // Low address bytes vary most; a multiplicative hash spreads them
+        uint64_t k = 0;
+        for(int i = 0; i < 6; i++) k = (k << 8) | addr[i];
+        return (uint16_t)((k * 0x9E3779B97F4A7C15ull) >> 40) & (INDEX - 1);
+    }
+
+    void link(uint16_t slot) {
+        uint16_t i = home(slots[slot].addr);
+        while(index[i]) i = (i + 1) & (INDEX - 1);
+        index[i] = slot + 1;
+    }
+
+    // Empties slot's index entry, pulling later members of the cluster back
+    // into the hole if that doesn't move them in front of their home
+    void unlink(uint16_t slot) {
+        uint16_t hole = home(slots[slot].addr);
+        while(index[hole] != slot + 1) hole = (hole + 1) & (INDEX - 1);
+        index[hole] = 0;
+        for(uint16_t i = (hole + 1) & (INDEX - 1); index[i]; i = (i + 1) & (INDEX - 1)) {
+            uint16_t h = home(slots[index[i] - 1].addr);
+            bool movable = (hole <= i) ? (h <= hole || h > i) : (h <= hole && h > i);
+            if(!movable) continue;
+            index[hole] = index[i];
+            index[i] = 0;
+            hole = i;
+        }
+    }
+
+    void reindex() {
+        memset(index, 0, sizeof(index));
+        for(uint16_t s = 0; s < count; s++) link(s);
+    }
+
+    T* oldest() {
+        typedef typename std::make_signed<Stamp>::type Age;
+        T* best = nullptr;
+        for(uint16_t i = 0; i < count; i++)
+            if(!best || (Age)(slots[i].lastSeen - best->lastSeen) < 0) best = &slots[i];
+        return best;
+    }
+
+    T slots[N];
+    uint16_t index[INDEX];   // slot + 1, 0 = empty
+    uint16_t count;
+    uint32_t evictions;
+};
@@ -11,61 +11,374 @@
 #include <BLEAdvertisedDevice.h>
 #include <WiFi.h> 
 #include <esp_wifi.h> 
+#include <esp_timer.h>
+#include <LittleFS.h>
+#include <Preferences.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <freertos/queue.h>
+#include "framebuffer.h"
+#include "glyph_cache.h"
+#include "capture_ring.h"
+#include "frame_stats.h"
+#include "pcap_stream.h"
+#include "sparkline.h"
+#include "sweep_graph.h"
+#include "mac_table.h"
+#include "string_pool.h"
+#include "alloc_stats.h"
+#include "ie_parser.h"
+#include "touch_input.h"
+#include "channel_hopper.h"
+#include "hid_scheduler.h"
+#include "ts_log.h"
+#include "prof.h"
+#include "page_layout.h"
+#include "list_view.h"
+#include "rssi_filter.h"
+#include "telemetry.h"
 
 /* ================== PINS ================== */
 #define TFT_CS   5
 #define TFT_DC   2
 #define TFT_RST  4
 #define T_CS     15
+#define T_IRQ    36
 
 /* ================== CONFIG ================== */
-#define DEBOUNCE_DELAY   150 
 #define C_BLACK      0x0000
 #define C_DARK_BLUE  0x000F 
 #define C_CYAN       0x07FF 
 #define C_WHITE      0xFFFF 
 #define C_RED        0xF800 
 #define C_GREEN      0x07E0 
+#define USE_FRAMEBUFFER  1   // draw into RAM, push only changed regions (see framebuffer.h)
 
-Adafruit_ILI9341 tft = Adafruit_ILI9341(TFT_CS, TFT_DC, TFT_RST);
+Adafruit_ILI9341 panel = Adafruit_ILI9341(TFT_CS, TFT_DC, TFT_RST);
+#if USE_FRAMEBUFFER
+FrameBufferGFX tft(panel);
+#else
+Adafruit_ILI9341& tft = panel;
+#endif
+GlyphCache glyphs;
 SPIClass touchSPI(HSPI);
 XPT2046_Touchscreen ts(T_CS);
+// Raw XPT2046 readings at the screen edges in rotation 3
+TouchInput touch({ 3700, 200, 3700, 200, 320, 240 });
 
 /* ================== GLOBAL VARIABLES ================== */
-enum Page { PAGE_HOME, PAGE_MUSIC, PAGE_SETTINGS, PAGE_WIFI, PAGE_SYSTEM, PAGE_BLE, PAGE_PACKET, PAGE_NET_ANA };
+enum Page { PAGE_HOME, PAGE_MUSIC, PAGE_SETTINGS, PAGE_WIFI, PAGE_SYSTEM, PAGE_BLE, PAGE_PACKET, PAGE_NET_ANA, PAGE_SURVEY, PAGE_CHANMAP, PAGE_COUNT };
 Page currentPage = PAGE_HOME;
 
-// PAGINATION STATE
-int homePageIndex = 0; // 0 = First 6 apps, 1 = Next 6 apps
+// Header title of each page, in Page order
+const char* const pageTitles[] = { "ROOT_ACCESS", "MODULE: A/V", "SYSTEM_CONFIG", "NET_SNIFFER", "HARDWARE_MON",
+                                   "BLE_TRACKER", "TRAFFIC_ANALYSIS", "DEAUTH_BROADCAST", "AP_SURVEY", "CHANNEL_MAP" };
+static_assert(sizeof(pageTitles) / sizeof(pageTitles[0]) == PAGE_COUNT, "pageTitles must list every Page");
+
+// --- HOME SCREEN APPS ---
+// One row per app; tiles fill HOME_GRID page by page in table order.
+struct AppTile { const char* title; const char* sub; Page page; };
+constexpr AppTile homeApps[] = {
+    { "MEDIA",   "A/V_MOD",  PAGE_MUSIC },
+    { "WIFI",    "NET_SCN",  PAGE_WIFI },
+    { "CONF",    "SYS_SET",  PAGE_SETTINGS },
+    { "SYSTEM",  "HARDWARE", PAGE_SYSTEM },
+    { "BLE",     "TRACKER",  PAGE_BLE },
+    { "PKT_MON", "TRAFFIC",  PAGE_PACKET },
+    { "NET_ANA", "ANALYZER", PAGE_NET_ANA },
+    { "SURVEY",  "AP_MAP",   PAGE_SURVEY },
+    { "CH_MAP",  "HEATMAP",  PAGE_CHANMAP },
+};
+constexpr uint8_t HOME_APPS = sizeof(homeApps) / sizeof(homeApps[0]);
+constexpr TileGrid HOME_GRID = { 10, 50, 90, 70, 105, 90, 3, 2 };
+constexpr uint8_t HOME_PAGES = HOME_GRID.pages(HOME_APPS);
+constexpr Rect HOME_PREV = { 10, 210, 50, 30 }, HOME_NEXT = { 260, 210, 50, 30 };   // page arrows
+
+int homePageIndex = 0; // 0 .. HOME_PAGES - 1
 
 uint16_t THEME_MAIN = C_CYAN; 
-int graphHistory[20]; 
+// Heap trace on PAGE_SYSTEM, inside the LIVE_MEMORY_BUFFER box
+Sparkline<40, 1024> heapHistory;  // free heap, KB
+SweepGraph heapGraph = { 21, 106, 126, 78, 3, C_GREEN, C_BLACK, C_BLACK, false, 84, 145, C_DARK_BLUE };
 
 // --- SCROLLING LIST SYSTEM ---
-struct ListItem { String label; int value; };
-#define MAX_LIST_ITEMS 40
-ListItem scannedList[MAX_LIST_ITEMS];
-int listCount = 0;
+// The radio task keeps the results and their sorted, filtered order
+// (list_view.h); the UI only holds a window of formatted rows around the
+// ones on screen, so scrolling a step or two never waits for the radio.
+#define LIST_LABEL_LEN 14
+struct ListItem { char label[LIST_LABEL_LEN + 1]; char detail[10]; int value; };  // detail: optional middle column
+#define LIST_ROWS 5
+#define LIST_WINDOW (3 * LIST_ROWS)   // the screen and a screen either side
+ListItem listWindow[LIST_WINDOW];
+int listFirst = 0;                // list row of listWindow[0]
+int listWindowCount = 0;
+int listCount = 0;                // rows in the list, after filtering
 int scrollOffset = 0; 
+uint32_t listRowKey[LIST_ROWS];   // what each visible row shows, see drawListItems()
+int listCounterDrawn = -1;
+
+// --- TASKS ---
+// Radio work (capture rings, scans, channel hopping, BLE tracking, pcap and
+// HID output) runs in radioTask, pinned to core 0 next to the WiFi and BT
+// stacks. loop() is the UI task: Arduino runs it on core 1, and it only
+// draws and handles input. Commands go down radioCmdQueue; results come back
+// as PacketTicks and list snapshots. Each side owns its own state.
+#define RADIO_TASK_STACK 6144
+#define RADIO_TASK_PRIO  2
+#define RADIO_TICK_MS    10    // ring drain / scan step period
+enum RadioMode : uint8_t { RADIO_IDLE, RADIO_BLE_LIST, RADIO_WIFI_SCAN, RADIO_MONITOR, RADIO_SURVEY, RADIO_EXTERNAL, RADIO_MODE_COUNT };
+enum RadioCmdType : uint8_t { RC_MODE, RC_CLEAR, RC_WIFI_LOOP, RC_CHANNEL, RC_PCAP, RC_HOP, RC_DWELL, RC_ADAPT,
+                              RC_LIST_SORT, RC_LIST_FILTER, RC_LIST_TOP, RC_BLE_REF, RC_BLE_PATH, RC_PCAP_SNAPLEN,
+                              RC_SWEEP, RC_LIST_PAGE };
+struct RadioCmd { uint8_t type; int16_t arg; };
+// UI: sort and filter of each list page, by the mode that fills it
+uint8_t listSort[RADIO_MODE_COUNT] = { SORT_FOUND, SORT_FOUND, SORT_FOUND, SORT_FOUND, SORT_RSSI, SORT_FOUND };
+uint8_t listFilter[RADIO_MODE_COUNT] = {};
+
+RadioMode listModeFor(Page page) {
+    switch(page) {
+        case PAGE_WIFI:   return RADIO_WIFI_SCAN;
+        case PAGE_BLE:    return RADIO_BLE_LIST;
+        case PAGE_SURVEY: return RADIO_SURVEY;
+        default:          return RADIO_IDLE;
+    }
+}
+
+// Radio -> UI, four per second while PKT_MON is open
+struct PacketTick {
+    uint32_t rate;          // frames/s over the last tick
+    uint32_t total;
+    uint32_t dropped;
+    bool breakdown;         // cat/windowTotal filled (once a second)
+    uint32_t windowTotal;
+    uint32_t cat[FCAT_COUNT];
+    uint8_t channel;        // tuned to right now
+};
+
+// Radio -> UI once a second while monitoring; mailbox like the list
+struct ChannelMap {
+    uint8_t current;
+    bool hopping;
+    uint16_t dwell[HOP_CHANNELS];   // what each channel gets on its next visit
+    ChannelActivity ch[HOP_CHANNELS];
+};
+
+// Radio -> UI; the mailbox holds one and a newer snapshot replaces it.
+// items are rows first .. first + count - 1 of the sorted, filtered list,
+// around the top row the UI last asked for.
+struct ListSnapshot {
+    uint8_t mode;           // RadioMode that produced it
+    uint8_t count;
+    uint16_t first;
+    uint16_t rows;          // in the list, after filtering
+    uint8_t channel;        // channel being scanned, 0 = idle
+    bool live;              // BLE tracker running
+    uint16_t total;         // entries in the backing table
+    uint32_t dropped;       // records the callback ring had to drop
+    ListItem items[LIST_WINDOW];
+};
+
+TaskHandle_t radioTaskHandle;
+QueueHandle_t radioCmdQueue;   // UI -> radio
+QueueHandle_t pktTickQueue;    // radio -> UI
+QueueHandle_t listMailbox;     // radio -> UI
+QueueHandle_t chanMailbox;     // radio -> UI
+QueueHandle_t pageMailbox;     // radio -> UI, RC_LIST_PAGE answers
+ListSnapshot listIn;           // UI: last snapshot received
+
+void radioCommand(uint8_t type, int arg = 0) {
+    RadioCmd cmd = { type, (int16_t)arg };
+    xQueueSend(radioCmdQueue, &cmd, pdMS_TO_TICKS(20));
+}
+void setRadioMode(RadioMode mode) { radioCommand(RC_MODE, mode); }
+void publishList();
+
+// --- LIST ORDER (radio task) ---
+#define LIST_MAX_ROWS 256              // the largest table
+ListView<LIST_MAX_ROWS> listView;
+uint8_t listSortBy = SORT_FOUND;
+uint8_t listFilterBy = FILTER_ALL;
+uint16_t listTop = 0;                  // top row on the UI's screen
+int listPageFirst = -1;                // >= 0: fill rows from here instead (RC_LIST_PAGE)
+bool listRequested = false;            // publish once the command batch is done
+
+uint32_t listNow;                      // millis() of the rebuild in progress
+uint16_t listNowSec;                   // and as a secStamp()
+
+// The WiFi and BLE tables stamp entries in whole seconds, 16 bits: ages are
+// right up to 18 hours, far past when an entry expires
+static inline uint16_t secStamp() { return millis() / 1000; }
+// A stamp as millis() for ListKey, against listNow
+static inline uint32_t stampMs(uint16_t sec) { return listNow - (uint16_t)(listNowSec - sec) * 1000UL; }
+
+// Sorts and filters a table, then formats the window of rows around listTop,
+// or from listPageFirst on for a page.
+// get(slot, ListKey&) as in ListView; format(slot, ListItem&) writes one row.
+template <class Get, class Format>
+void fillListWindow(ListSnapshot& out, uint16_t slots, Get get, Format format) {
+    listNow = millis();
+    listNowSec = listNow / 1000;
+    listView.rebuild(slots, get, listSortBy, listFilterBy, listNow);
+    int rows = listView.size();
+    int first = listPageFirst >= 0 ? min(listPageFirst, rows) : constrain((int)listTop - LIST_ROWS, 0, max(0, rows - LIST_WINDOW));
+    out.rows = rows;
+    out.first = first;
+    out.count = min(LIST_WINDOW, rows - first);
+    for(int i = 0; i < out.count; i++) format(listView.slot(first + i), out.items[i]);
+}
+
+// --- WIFI SCAN STATE ---
+// NET_SCN scans one channel at a time with async scans and merges each
+// channel's results by BSSID, so the list fills in while the radio task
+// keeps running. In LOOP mode passes repeat and networks not heard from for
+// WIFI_NET_AGE_MS drop out.
+#define WIFI_SCAN_DWELL_MS 120
+#define WIFI_NET_AGE_MS    30000
+#define WIFI_TABLE_SIZE    256    // networks; past that the least recently seen goes
+#define WIFI_SSID_BYTES    4096   // pooled SSIDs, shared by APs that broadcast the same one
+struct ScanNet {             // 14 bytes
+    uint8_t addr[6];         // BSSID
+    uint16_t lastSeen;       // secStamp()
+    uint16_t firstSeen;
+    uint16_t ssid;           // wifiSsids handle, 0 = hidden
+    int8_t rssi;
+    uint8_t channel;
+};
+MacTable<ScanNet, WIFI_TABLE_SIZE> wifiNets;
+StringPool<WIFI_SSID_BYTES, WIFI_TABLE_SIZE> wifiSsids;
+int wifiScanChannel = 0;          // channel being scanned, 0 = idle
+bool wifiContinuous = false;    // UI: LOOP button
+bool wifiScanLoop = false;      // radio task's copy
+unsigned long wifiPassDone = 0;
 
 // --- PACKET MONITOR STATE ---
+// Written only by the WiFi task (producer) and drained only by the radio task
+#define CAPTURE_RING_SIZE 512
+SpscRing<CaptureRecord, CAPTURE_RING_SIZE> captureRing;
 unsigned long packetRate = 0;     
 unsigned long lastPacketCheck = 0;
 unsigned long totalPackets = 0;
 int wifiChannel = 1;
-int pktGraph[26]; 
+Sparkline<28> pktRateHistory;  // frames per second
+SweepGraph pktGraph = { 21, 111, 168, 98, 6, C_GREEN, C_DARK_BLUE, C_BLACK, true, 105, 160, C_DARK_BLUE };
+FrameStats pktWindowStats;   // since the last breakdown refresh
+FrameStats pktSessionStats;  // since the monitor was opened
+unsigned long lastBreakdownUpdate = 0;
+PacketTick pktShown;         // UI: totals and breakdown as last drawn
+bool pcapOn = false;         // UI: PCAP button state
+uint8_t breakdownBarDrawn[FCAT_COUNT];
+// Channel hopping: the radio task owns the hopper; the UI keeps the settings
+// it last sent and the map it last received.
+ChannelHopper hopper;
+bool hopping = false;          // radio task
+uint8_t monitorChannel = 1;    // radio task: fixed channel when not hopping
+bool pktHopping = false;       // UI: PKT_MON channel box state
+uint16_t hopDwellMs = HOP_DWELL_MS;
+bool hopAdaptive = true;
+uint8_t pktChannelDrawn = 0;
+ChannelMap chanIn;
+uint8_t breakdownPctDrawn[FCAT_COUNT];
+
+// --- AP SURVEY STATE ---
+// Receive-only: the promiscuous callback parses beacons/probe responses
+// (ie_parser.h) and queues one record per frame; the radio task merges them
+// into a BSSID-keyed table and hops channels on a timer.
+#define SURVEY_TABLE_SIZE 256
+#define SURVEY_AGE_MS     120000
+#define SURVEY_DWELL_MS   250
+struct SurveyRecord { uint8_t bssid[6]; int8_t rssi; uint8_t rxChannel; BeaconInfo info; };
+struct SurveyAP {
+    uint8_t addr[6];         // BSSID
+    uint32_t lastSeen;
+    uint32_t firstSeen;
+    uint32_t beacons;
+    int16_t rssiQ4;          // smoothed RSSI in 1/16 dBm
+    uint8_t channel;
+    uint8_t security;        // SEC_* bits
+    bool hidden;
+    bool wps;
+    uint8_t vendorOui[3];
+    char ssid[33];
+};
+SpscRing<SurveyRecord, 64> surveyRing;
+MacTable<SurveyAP, SURVEY_TABLE_SIZE> surveyAPs;
+int surveyChannel = 1;
+unsigned long lastSurveyHop = 0;
+unsigned long lastSurveyRefresh = 0;
+
+// --- PCAP EXPORT ---
+#define PCAP_BAUD 921600
+PcapStream pcapStream;
+uint16_t pcapSnaplen = PCAP_DEFAULT_SNAPLEN;  // radio task: bytes of each frame kept; from NVS at boot, then RC_PCAP_SNAPLEN
+
+// --- TELEMETRY ---
+// "telem" on the console turns Serial into a stream of binary frames
+// (telemetry.h) until the host sends TC_STOP. UI task only.
+#define TELEM_BAUD        921600
+#define TELEM_DEFAULT_MS  100     // STATUS/PACKETS/LIST at most this often
+#define TELEM_MIN_MS      10
+bool telemOn = false;
+PacketTick telemTick;                        // latest tick, for TM_PACKETS
+uint32_t telemCat[FCAT_COUNT];               // latest breakdown
+bool telemTickFresh = false, telemListFresh = false;   // arrived since the last frame
+
+// Debug text would corrupt a binary stream on the same UART
+bool serialIsText() { return !pcapStream.active() && !telemOn; }
+
+// --- HISTORY LOG ---
+// What the UI receives is also sampled into a ring log on flash (ts_log.h)
+// every LOG_SAMPLE_MS, so a unit left running overnight can be read back
+// later with "log dump" on the Serial console. The UI task owns the log:
+// flash writes and dumps never hold up the radio task's ring draining.
+// Settings go to NVS through Preferences.
+#define LOG_SAMPLE_MS  10000
+#define LOG_DUMP_LINES 16      // per loop() pass
+enum LogSeries : uint8_t { LOG_BOOT = TSLOG_SERIES_BOOT, LOG_HEAP_KB, LOG_PKT_RATE, LOG_PKT_DROPPED, LOG_WIFI_NETS,
+                           LOG_BLE_DEVS, LOG_SURVEY_APS, LOG_SURVEY_DROPPED, LOG_THEME, LOG_SERIES_COUNT };
+const char* const logSeriesNames[LOG_SERIES_COUNT] = { "boot", "heap_kb", "pkt_rate", "pkt_dropped", "wifi_nets",
+                                                       "ble_devs", "survey_aps", "survey_dropped", "theme" };
+// Scan results are also logged one entry at a time, when a network, device
+// or AP joins its table and when it expires or is evicted. The radio task
+// queues them on logEntryRing; the UI task writes them out.
+enum LogEntryTable : uint8_t { LOG_TABLE_WIFI, LOG_TABLE_BLE, LOG_TABLE_SURVEY, LOG_TABLE_COUNT };
+enum LogEntryEvent : uint8_t { LOG_ENTRY_ADDED = 0x00, LOG_ENTRY_EXPIRED = 0x10, LOG_ENTRY_EVICTED = 0x20 };
+const char* const logTableNames[LOG_TABLE_COUNT] = { "wifi", "ble", "survey" };
+#define LOG_EVENT_COUNT 3
+const char* const logEventNames[LOG_EVENT_COUNT] = { "added", "expired", "evicted" };
+SpscRing<TsLogEntry, 64> logEntryRing;
+TsLog history;
+TsLogReader historyDump;
+bool historyDumping = false;
+uint32_t historyDumped = 0;
+unsigned long lastHistorySample = 0;
+
+// Radio task; ages in seconds
+void logEntry(uint8_t kind, const uint8_t* addr, uint8_t channel, int rssi, uint32_t firstAgo, uint32_t lastAgo) {
+    TsLogEntry e = { kind, {}, channel, (int8_t)rssi, (uint16_t)min(firstAgo, 0xFFFFu), (uint16_t)min(lastAgo, 0xFFFFu) };
+    memcpy(e.addr, addr, 6);
+    logEntryRing.push(e);
+}
+uint32_t histPktRateSum = 0, histPktTicks = 0;   // PacketTicks since the last sample
+uint32_t histPktDropped = 0;
+bool histListFresh = false;                      // listIn arrived since the last sample
+Preferences prefs;
 
 // --- DEAUTHER STATE ---
 bool isDeauthRunning = false;
 unsigned long lastDeauthTime = 0;
 unsigned long lastScanTime = 0;
+// The 13-channel sweep runs in the radio task (RC_SWEEP); it clears this
+// when done, and no deauth frames go out meanwhile
+volatile bool deauthSweeping = false;
+int sweepChannel = 0;             // radio task: channel being swept, 0 = none
+unsigned long sweepStepAt = 0;
 int currentDeauthChannel = 1;
 int deauthPacketCount = 0;
 
 #define MAX_APS 20
 
 struct AccessPoint {
-    String essid;
+    char essid[33];
     int8_t rssi;
     uint8_t bssid[6];
     int channel;
@@ -82,16 +395,81 @@ BLEScan* pBLEScan;
 bool connected = false;
 bool isPlaying = false;
 
+// --- BLE TRACKER ---
+// A continuous scan reports every advertisement to the callback (BT task),
+// which queues a compact record; the radio task folds them into a device
+// table keyed by address. Devices not heard from for BLE_STALE_MS are dropped.
+// Each advertisement's RSSI goes through the device's RssiFilter, and the list
+// shows the filtered RSSI with a range and trend estimated from it.
+#define BLE_TABLE_SIZE 256     // devices; past that the least recently seen goes
+#define BLE_NAME_BYTES 1536    // pooled names; most devices advertise none
+#define BLE_STALE_MS   60000
+#define BLE_NAME_LEN   16
+#define BLE_REF_1M_DBM -59     // RSSI at 1 m, for devices that don't advertise their TX power
+#define BLE_PATH_N10   25      // path-loss exponent x10
+#define BLE_TX_LOSS_1M 41      // dB lost over the first metre at 2.4 GHz
+struct BleAdvRecord { uint8_t addr[6]; int8_t rssi; int8_t txPower; char name[BLE_NAME_LEN + 1]; };
+struct BleDevice {           // 32 bytes
+    RssiFilter rssi;         // smoothed RSSI and trend
+    uint8_t addr[6];
+    uint16_t lastSeen;       // secStamp()
+    uint16_t firstSeen;
+    uint16_t lastMs;         // low bits of millis(), for the filter's dt (expired long before it wraps)
+    uint16_t advCount;       // stops at 0xFFFF
+    uint16_t name;           // bleNames handle, 0 = none
+    int8_t lastRssi;
+    int8_t txPower;
+};
+SpscRing<BleAdvRecord, 64> bleAdvRing;
+MacTable<BleDevice, BLE_TABLE_SIZE> bleDevices;
+StringPool<BLE_NAME_BYTES, BLE_TABLE_SIZE> bleNames;
+bool bleTrackerOn = false;
+int8_t bleRef1m = BLE_REF_1M_DBM;      // radio task; from NVS at boot, then RC_BLE_REF
+uint8_t blePathN10 = BLE_PATH_N10;     // RC_BLE_PATH
+unsigned long lastBleExpire = 0;
+unsigned long lastBleListUpdate = 0;
+
+class BleTrackerCallbacks: public BLEAdvertisedDeviceCallbacks {
+    void onResult(BLEAdvertisedDevice device) {
+        PROF_SCOPE("cbBleAdv");
+        BleAdvRecord rec;
+        memcpy(rec.addr, device.getAddress().getNative(), 6);
+        rec.rssi = device.getRSSI();
+        rec.txPower = device.haveTXPower() ? device.getTXPower() : 0;
+        rec.name[0] = 0;
+        if(device.haveName()) {
+            strncpy(rec.name, device.getName().c_str(), BLE_NAME_LEN);
+            rec.name[BLE_NAME_LEN] = 0;
+        }
+        bleAdvRing.push(rec);
+    }
+};
+BleTrackerCallbacks bleTrackerCallbacks;
+
+void startBleTracker() {
+    if(bleTrackerOn) return;
+    PROF_SCOPE("bleStart");
+    pBLEScan->setAdvertisedDeviceCallbacks(&bleTrackerCallbacks, true);  // duplicates keep RSSI live
+    pBLEScan->start(0, nullptr, false);
+    bleTrackerOn = true;
+}
+
+void stopBleTracker() {
+    if(!bleTrackerOn) return;
+    pBLEScan->stop();
+    bleTrackerOn = false;
+}
+
 // BLE Server Callback
 class MyBLEServerCallbacks: public BLEServerCallbacks {
     void onConnect(BLEServer* pServer) {
         connected = true;
-        Serial.println("[BLE] Device connected!");
+        if(serialIsText()) Serial.println("[BLE] Device connected!");
     }
     
     void onDisconnect(BLEServer* pServer) {
         connected = false;
-        Serial.println("[BLE] Device disconnected!");
+        if(serialIsText()) Serial.println("[BLE] Device disconnected!");
         pServer->getAdvertising()->start();
     }
 }; 
@@ -112,52 +490,93 @@ const uint8_t reportMap[] = {
 };
 
 /* ================== HELPER FUNCTIONS ================== */
+// Push everything drawn since the last call (no-op when drawing direct)
+void flushDisplay() {
+    PROF_SCOPE("flush");
+#if USE_FRAMEBUFFER
+    tft.flush();
+#endif
+}
+
+// Opaque text in one bitmap write (glyph_cache.h), padded with bg out to
+// minW px so it can stand in for the fillRect that used to clear behind it.
+// Returns the x just past the text.
+int16_t drawText(int16_t x, int16_t y, const char* s, uint16_t fg, uint8_t size = 1, int16_t minW = 0, uint16_t bg = C_BLACK) {
+    PROF_SCOPE("text");
+    return glyphs.draw(tft, x, y, s, fg, bg, size, minW);
+}
+
+// Runs in the WiFi task: summarise the frame and hand it to loop()
 void wifi_promiscuous_cb(void* buf, wifi_promiscuous_pkt_type_t type) {
-    packetRate++;
-    totalPackets++;
+    PROF_SCOPE("cbMonitor");
+    const wifi_promiscuous_pkt_t *ppkt = (const wifi_promiscuous_pkt_t *)buf;
+    const wifi_pkt_rx_ctrl_t &rx = ppkt->rx_ctrl;
+    CaptureRecord rec;
+    rec.timestampUs = rx.timestamp;
+    rec.length = rx.sig_len;
+    rec.rssi = rx.rssi;
+    rec.channel = rx.channel;
+    uint8_t fc0 = (rx.sig_len >= 2) ? ppkt->payload[0] : 0;
+    rec.frameType = (fc0 >> 2) & 0x03;
+    rec.frameSubtype = fc0 >> 4;
+    rec.flags = (rx.sig_len >= 2) ? ppkt->payload[1] : 0;
+    rec.reserved = 0;
+    captureRing.push(rec);
+    pcapStream.capture(ppkt);
 }
 
-void sendMediaKey(uint8_t keyMask) {
-  if (!connected) {
-    Serial.println("[BLE] Not connected, cannot send key");
-    return;
+// --- HID media keys ---
+// Presses are queued and played out by hidTimer (hid_scheduler.h), so a tap
+// costs the UI nothing and rapid taps or a held key never block loop().
+HidScheduler hidKeys;
+esp_timer_handle_t hidTimer;
+
+// Report ID 1 + 16-bit usage code (little endian); 0 releases
+void sendConsumerReport(uint16_t usage) {
+  if(usage && serialIsText()) {
+    Serial.print("[BLE] Sending media key: 0x");
+    Serial.println(usage, HEX);
   }
-  
-  // Consumer control usage codes
-  uint16_t consumerCode = 0;
-  if(keyMask == 1) consumerCode = 0xB6;      // Scan Previous Track
-  else if(keyMask == 2) consumerCode = 0xB5; // Scan Next Track  
-  else if(keyMask == 8) consumerCode = 0xCD; // Play/Pause
-  
-  Serial.print("[BLE] Sending media key: 0x");
-  Serial.println(consumerCode, HEX);
-  
-  // Send consumer control code - report ID 1 + 16-bit usage code (little endian)
-  uint8_t report[3] = {0x01, (uint8_t)(consumerCode & 0xFF), (uint8_t)((consumerCode >> 8) & 0xFF)};
+  uint8_t report[3] = {0x01, (uint8_t)(usage & 0xFF), (uint8_t)(usage >> 8)};
   inputMedia->setValue(report, 3);
   inputMedia->notify();
-  delay(100); 
-  
-  // Release (send 0x00)
-  uint8_t releaseReport[3] = {0x01, 0x00, 0x00};
-  inputMedia->setValue(releaseReport, 3);
-  inputMedia->notify();
-  delay(50);
 }
 
-String getUptime() {
+void hidTimerTick(void*) {
+  int32_t wait = hidKeys.service(millis(), sendConsumerReport);
+  if(wait >= 0) esp_timer_start_once(hidTimer, (uint64_t)(wait ? wait : 1) * 1000);
+}
+
+void hidTap(uint16_t usage) {
+  if (!connected) {
+    if(serialIsText()) Serial.println("[BLE] Not connected, cannot send key");
+    return;
+  }
+  // Wakes an idle scheduler; if the timer is already armed this fails
+  // harmlessly and the request is picked up at the next deadline.
+  if(hidKeys.tap(usage)) esp_timer_start_once(hidTimer, 0);
+}
+
+void startHid() {
+  esp_timer_create_args_t args = {};
+  args.callback = hidTimerTick;
+  args.name = "hid";
+  esp_timer_create(&args, &hidTimer);
+}
+
+// Writes "[hh:mm:ss]" into buffer (at least 11 bytes)
+void formatUptime(char* buffer) {
   unsigned long ms = millis();
   int sec = (ms / 1000) % 60;
   int min = (ms / (1000 * 60)) % 60;
   int hr  = (ms / (1000 * 60 * 60)) % 24;
-  char buffer[12];
   sprintf(buffer, "[%02d:%02d:%02d]", hr, min, sec);
-  return String(buffer);
 }
 
 /* ================== UI DRAWING ================== */
 
 void drawDedSecBackground() {
+    PROF_SCOPE("backgrnd");
     tft.fillScreen(C_BLACK);
     for(int y=0; y<240; y+=4) tft.drawFastHLine(0, y, 320, C_DARK_BLUE);
 
@@ -173,16 +592,8 @@ void drawDedSecBackground() {
     tft.setTextColor(THEME_MAIN); tft.setTextSize(1); tft.setCursor(25, 10);
     tft.print("ctOS_MOBILE // ");
     
-    if(currentPage == PAGE_HOME) {
-        tft.print("ROOT_ACCESS [PG "); tft.print(homePageIndex + 1); tft.print("]");
-    }
-    else if(currentPage == PAGE_MUSIC) tft.print("MODULE: A/V");
-    else if(currentPage == PAGE_SETTINGS) tft.print("SYSTEM_CONFIG");
-    else if(currentPage == PAGE_WIFI) tft.print("NET_SNIFFER");
-    else if(currentPage == PAGE_SYSTEM) tft.print("HARDWARE_MON");
-    else if(currentPage == PAGE_BLE) tft.print("BLE_TRACKER");
-    else if(currentPage == PAGE_PACKET) tft.print("TRAFFIC_ANALYSIS");
-    else if(currentPage == PAGE_NET_ANA) tft.print("DEAUTH_BROADCAST");
+    tft.print(pageTitles[currentPage]);
+    if(currentPage == PAGE_HOME) { tft.print(" [PG "); tft.print(homePageIndex + 1); tft.print("]"); }
 
     tft.setCursor(250, 10);
     if(connected && currentPage != PAGE_PACKET) { tft.setTextColor(C_GREEN); tft.print("[LINK_OK]"); } 
@@ -190,6 +601,7 @@ void drawDedSecBackground() {
 }
 
 void drawHackerBtn(int x, int y, int w, int h, const char* title, const char* sub) {
+    PROF_SCOPE("hackBtn");
     tft.drawRect(x, y, w, h, THEME_MAIN);
     tft.drawFastHLine(x, y, 10, C_BLACK); tft.drawFastVLine(x, y, 10, C_BLACK);
     tft.drawLine(x, y+10, x+10, y, THEME_MAIN);
@@ -203,90 +615,163 @@ void drawHackerBtn(int x, int y, int w, int h, const char* title, const char* su
 }
 
 void drawBackButton() {
+    PROF_SCOPE("backBtn");
     tft.drawRect(0, 30, 45, 25, THEME_MAIN);
     tft.setCursor(5, 36); tft.setTextColor(THEME_MAIN); tft.setTextSize(1); tft.print("[RET]");
 }
 
+// Current auto-scaled range of a graph, e.g. "PKT/S 0-500" or "150-200KB"
+template <class Line>
+void drawGraphRange(int x, int y, const char* label, const Line& line, const char* unit) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%s%s%u-%u%s", label, *label ? " " : "", line.rangeLo(), line.rangeHi(), unit);
+    drawText(x, y, buf, C_WHITE, 1, 100);
+}
+
 // === GENERIC LIST RENDERER ===
+// Rows are only repainted when their label or value changed, so results
+// can be fed in while a scan is still running.
+void resetListRows() {
+    for(int i = 0; i < LIST_ROWS; i++) listRowKey[i] = 0xFFFFFFFF;
+    listCounterDrawn = -1;
+}
+
+// List row `index` from the window, or nullptr if the window doesn't cover it
+const ListItem* listItemAt(int index) {
+    if(index < listFirst || index >= listFirst + listWindowCount) return nullptr;
+    return &listWindow[index - listFirst];
+}
+
+uint32_t listRowKeyOf(const ListItem* item) {
+    if(!item) return 0;
+    uint32_t h = 2166136261u;
+    for(const char* c = item->label; *c; c++) h = (h ^ (uint8_t)*c) * 16777619u;
+    for(const char* c = item->detail; *c; c++) h = (h ^ (uint8_t)*c) * 16777619u;
+    h = (h ^ (uint32_t)item->value) * 16777619u;
+    return (h == 0 || h == 0xFFFFFFFF) ? 1 : h;
+}
+
 void drawListItems() {
-    tft.fillRect(10, 70, 260, 130, C_BLACK);
-    for (int i = 0; i < 5; i++) {
+    PROF_SCOPE("list");
+    for (int i = 0; i < LIST_ROWS; i++) {
         int index = scrollOffset + i;
-        if(index >= listCount) break;
+        const ListItem* item = index < listCount ? listItemAt(index) : nullptr;
+        if(index < listCount && !item) continue;   // still on its way from the radio task: keep the old row
+        uint32_t key = listRowKeyOf(item);
+        if(key == listRowKey[i]) continue;
+        listRowKey[i] = key;
+        tft.fillRect(10, 70 + (i * 25), 278, 25, C_BLACK);
+        if(!item) continue;
         int y = 75 + (i * 25);
-        tft.setCursor(25, y); tft.setTextSize(1); tft.setTextColor(C_WHITE);
-        tft.print(scannedList[index].label);
-        int rssi = scannedList[index].value;
+        drawText(25, y, item->label, C_WHITE);
+        if(item->detail[0]) drawText(118, y, item->detail, THEME_MAIN);
+        int rssi = item->value;
         int barWidth = map(rssi, -100, -40, 5, 60);
         if(barWidth < 5) barWidth = 5; if(barWidth > 60) barWidth = 60;
         uint16_t barColor = (rssi > -70) ? C_GREEN : C_RED;
         tft.drawRect(200, y, 62, 10, THEME_MAIN); 
         tft.fillRect(201, y+1, barWidth, 8, barColor); 
-        tft.setCursor(270, y); tft.setTextColor(THEME_MAIN); tft.print(rssi);
+        char val[8];
+        snprintf(val, sizeof(val), "%d", rssi);
+        drawText(270, y, val, THEME_MAIN);
+    }
+    int counter = (scrollOffset + 1) * 1000 + listCount;
+    if(counter == listCounterDrawn) return;
+    if(listCounterDrawn < 0) {
+        tft.drawRect(290, 70, 25, 60, THEME_MAIN); 
+        tft.setCursor(297, 90); tft.setTextColor(C_WHITE); tft.setTextSize(2); tft.print("^");
+        tft.drawRect(290, 140, 25, 60, THEME_MAIN); 
+        tft.setCursor(297, 160); tft.print("v");
     }
-    tft.drawRect(290, 70, 25, 60, THEME_MAIN); 
-    tft.setCursor(297, 90); tft.setTextColor(C_WHITE); tft.setTextSize(2); tft.print("^");
-    tft.drawRect(290, 140, 25, 60, THEME_MAIN); 
-    tft.setCursor(297, 160); tft.print("v");
-    tft.setCursor(285, 210); tft.setTextSize(1); tft.setTextColor(THEME_MAIN);
-    tft.print(scrollOffset + 1); tft.print("/"); tft.print(listCount);
+    listCounterDrawn = counter;
+    char buf[12];
+    snprintf(buf, sizeof(buf), "%d/%d", scrollOffset + 1, listCount);
+    drawText(278, 210, buf, THEME_MAIN, 1, 42);
+}
+
+// SORT and SHOW chips above the column headers
+void drawListControls() {
+    PROF_SCOPE("listCtl");
+    static const char* const sortNames[SORT_COUNT] = { "FOUND", "RSSI", "NAME", "AGE" };
+    static const char* const filterNames[FILTER_COUNT] = { "ALL", ">-70", "NAMED" };
+    RadioMode m = listModeFor(currentPage);
+    char buf[12];
+    tft.drawRect(150, 28, 78, 16, THEME_MAIN);
+    snprintf(buf, sizeof(buf), "SORT %s", sortNames[listSort[m]]);
+    drawText(154, 32, buf, C_WHITE, 1, 71);
+    tft.drawRect(234, 28, 80, 16, THEME_MAIN);
+    snprintf(buf, sizeof(buf), "SHOW %s", filterNames[listFilter[m]]);
+    drawText(238, 32, buf, C_WHITE, 1, 73);
 }
 
 /* ================== PAGE: HOME ================== */
 void drawHome() {
+    PROF_SCOPE("home");
     drawDedSecBackground();
     tft.drawCircle(160, 120, 15, THEME_MAIN); tft.drawCircle(160, 120, 5, C_WHITE);
     tft.drawLine(160, 30, 160, 210, C_DARK_BLUE); 
 
-    // === PAGINATION LOGIC ===
-    if (homePageIndex == 0) {
-        // PAGE 1 APPS
-        drawHackerBtn(10, 50, 90, 70, "MEDIA", "A/V_MOD");
-        drawHackerBtn(115, 50, 90, 70, "WIFI", "NET_SCN");
-        drawHackerBtn(220, 50, 90, 70, "CONF", "SYS_SET");
-
-        drawHackerBtn(10, 140, 90, 70, "SYSTEM", "HARDWARE");
-        drawHackerBtn(115, 140, 90, 70, "BLE", "TRACKER");
-        drawHackerBtn(220, 140, 90, 70, "PKT_MON", "TRAFFIC");
-    } 
-    else if (homePageIndex == 1) {
-        // PAGE 2 APPS (Placeholders for now)
-        drawHackerBtn(10, 50, 90, 70, "NET_ANA", "ANALYZER"); 
-        // Add more apps here later...
+    // This page's slice of homeApps
+    uint8_t first = homePageIndex * HOME_GRID.perPage();
+    for(uint8_t slot = 0; slot < HOME_GRID.perPage() && first + slot < HOME_APPS; slot++) {
+        const AppTile& app = homeApps[first + slot];
+        Rect r = HOME_GRID.cell(slot);
+        drawHackerBtn(r.x, r.y, r.w, r.h, app.title, app.sub);
     }
 
     // DRAW NAV ARROWS
     if (homePageIndex > 0) {
-        tft.drawRect(10, 210, 50, 30, THEME_MAIN);
-        tft.setCursor(25, 218); tft.setTextColor(C_WHITE); tft.print("<");
+        tft.drawRect(HOME_PREV.x, HOME_PREV.y, HOME_PREV.w, HOME_PREV.h, THEME_MAIN);
+        tft.setCursor(HOME_PREV.x + 15, HOME_PREV.y + 8); tft.setTextColor(C_WHITE); tft.print("<");
     }
-    
-    // Assuming max 2 pages (Index 0 and 1)
-    if (homePageIndex < 1) {
-        tft.drawRect(260, 210, 50, 30, THEME_MAIN);
-        tft.setCursor(280, 218); tft.setTextColor(C_WHITE); tft.print(">");
+    if (homePageIndex < HOME_PAGES - 1) {
+        tft.drawRect(HOME_NEXT.x, HOME_NEXT.y, HOME_NEXT.w, HOME_NEXT.h, THEME_MAIN);
+        tft.setCursor(HOME_NEXT.x + 20, HOME_NEXT.y + 8); tft.setTextColor(C_WHITE); tft.print(">");
     }
 }
 
+// App tile under a touch on the current home page
+const AppTile* homeAppAt(int16_t x, int16_t y) {
+    int8_t slot = HOME_GRID.slotAt(x, y);
+    if(slot < 0 || homePageIndex * HOME_GRID.perPage() + slot >= HOME_APPS) return nullptr;
+    return &homeApps[homePageIndex * HOME_GRID.perPage() + slot];
+}
+
 /* ================== PAGE: PACKET MONITOR ================== */
+// Radio task
 void startPacketMonitor() {
-    BLEDevice::getAdvertising()->stop();
-    WiFi.disconnect();
-    WiFi.mode(WIFI_STA);
-    esp_wifi_set_promiscuous(true);
-    esp_wifi_set_promiscuous_rx_cb(&wifi_promiscuous_cb);
-    for(int i=0; i<26; i++) pktGraph[i] = 0;
+    captureRing.clear();
+    packetRate = 0;
+    lastPacketCheck = lastBreakdownUpdate = millis();
+    pktWindowStats.reset();
+    pktSessionStats.reset();
+    hopping = false;
+    hopper.reset();
+    hopper.tuneTo(monitorChannel, millis());
+    esp_wifi_set_channel(monitorChannel, WIFI_SECOND_CHAN_NONE);
 }
 
 void stopPacketMonitor() {
-    esp_wifi_set_promiscuous(false);
-    BLEDevice::getAdvertising()->start();
+    if(pcapStream.active()) {
+        pcapStream.end(Serial);
+        Serial.updateBaudRate(115200);
+    }
+}
+
+// UI
+void drawPcapButton() {
+    PROF_SCOPE("pcapBtn");
+    bool on = pcapOn;
+    tft.fillRect(232, 213, 66, 24, C_BLACK);
+    tft.drawRect(232, 213, 66, 24, on ? C_RED : THEME_MAIN);
+    drawText(242, 218, on ? "REC" : "PCAP", on ? C_RED : C_WHITE, 2);
 }
 
 /* ================== DEAUTHER FUNCTIONS ================== */
 
 // Callback for sniffing beacons
 void sniffer_callback(void* buf, wifi_promiscuous_pkt_type_t type) {
+    PROF_SCOPE("cbDeauth");
     wifi_promiscuous_pkt_t *ppkt = (wifi_promiscuous_pkt_t *)buf;
     wifi_pkt_rx_ctrl_t *rx_ctrl = &ppkt->rx_ctrl;
     
@@ -336,12 +821,11 @@ void sniffer_callback(void* buf, wifi_promiscuous_pkt_type_t type) {
             memcpy(discoveredAPs[apCount].bssid, bssid, 6);
             
             if(ssid && ssid_len > 0) {
-                char ssid_str[33];
-                memset(ssid_str, 0, 33);
-                memcpy(ssid_str, ssid, (ssid_len < 32) ? ssid_len : 32);
-                discoveredAPs[apCount].essid = String(ssid_str);
+                int n = (ssid_len < 32) ? ssid_len : 32;
+                memcpy(discoveredAPs[apCount].essid, ssid, n);
+                discoveredAPs[apCount].essid[n] = 0;
             } else {
-                discoveredAPs[apCount].essid = "[Hidden]";
+                strcpy(discoveredAPs[apCount].essid, "[Hidden]");
             }
             
             apCount++;
@@ -381,21 +865,9 @@ void startDeauther() {
     apCount = 0;
     deauthPacketCount = 0;
     
-    BLEDevice::getAdvertising()->stop();
-    WiFi.disconnect(true);
-    WiFi.mode(WIFI_MODE_NULL);
-    delay(100);
-    
-    // Initialize WiFi for packet injection
-    wifi_init_config_t cfg = WIFI_INIT_CONFIG_DEFAULT();
-    esp_wifi_init(&cfg);
-    esp_wifi_set_storage(WIFI_STORAGE_RAM);
-    esp_wifi_set_mode(WIFI_MODE_NULL);
-    esp_wifi_start();
-    
-    // Enable promiscuous mode
-    esp_wifi_set_promiscuous(true);
-    esp_wifi_set_promiscuous_rx_cb(&sniffer_callback);
+    // The radio task brings up STA capture into sniffer_callback and pauses
+    // BLE, then leaves the driver to this page
+    setRadioMode(RADIO_EXTERNAL);
     
     lastScanTime = millis();
     lastDeauthTime = millis();
@@ -403,14 +875,19 @@ void startDeauther() {
 
 void stopDeauther() {
     isDeauthRunning = false;
-    esp_wifi_set_promiscuous(false);
-    esp_wifi_deinit();
-    delay(100);
-    
-    BLEDevice::getAdvertising()->start();
+    setRadioMode(RADIO_IDLE);
+}
+
+// Radio task: one step of the channel sweep
+void updateSweep() {
+    if(!sweepChannel || millis() - sweepStepAt < 100) return;
+    if(++sweepChannel > 13) { sweepChannel = 0; deauthSweeping = false; return; }
+    esp_wifi_set_channel(sweepChannel, WIFI_SECOND_CHAN_NONE);
+    sweepStepAt = millis();
 }
 
 void updateDeauther() {
+    PROF_SCOPE("deauthUpd");
     if(!isDeauthRunning) return;
     
     unsigned long now = millis();
@@ -422,12 +899,11 @@ void updateDeauther() {
         }
         lastScanTime = now;
         
-        // Scan through all channels
-        for(int ch = 1; ch <= 13; ch++) {
-            esp_wifi_set_channel(ch, WIFI_SECOND_CHAN_NONE);
-            delay(100);
-        }
+        // Scan through all channels, 100 ms each, in the radio task
+        deauthSweeping = true;
+        radioCommand(RC_SWEEP);
     }
+    if(deauthSweeping) return;
     
     // Send deauth packets
     if(now - lastDeauthTime > 50) { // Send every 50ms
@@ -438,151 +914,714 @@ void updateDeauther() {
     }
 }
 
+void drawPacketTotals() {
+    PROF_SCOPE("pktTotal");
+    char total[12], dropped[12];
+    snprintf(total, sizeof(total), "%lu", (unsigned long)pktShown.total);
+    snprintf(dropped, sizeof(dropped), "%lu", (unsigned long)pktShown.dropped);
+    int16_t x = drawText(30, 220, "TOTAL_PKTS: ", THEME_MAIN);
+    x = drawText(x, 220, total, C_WHITE);
+    x = drawText(x, 220, "  DROPPED: ", THEME_MAIN);
+    drawText(x, 220, dropped, C_WHITE, 1, 230 - x);
+}
+
+// Per-type share of the last window, one row per FrameCategory.
+// Only rows whose bar or percentage moved are repainted.
+void drawFrameBreakdown(bool force) {
+    PROF_SCOPE("breakdown");
+    const uint32_t* cat = pktShown.cat;
+    uint32_t peak = 1;
+    for(int i = 0; i < FCAT_COUNT; i++) if(cat[i] > peak) peak = cat[i];
+
+    tft.setTextSize(1);
+    for(int i = 0; i < FCAT_COUNT; i++) {
+        int y = 111 + i * 10;
+        uint8_t bar = (uint8_t)((cat[i] * 52 + peak - 1) / peak);
+        uint8_t pct = pktShown.windowTotal ? (uint8_t)((cat[i] * 100 + pktShown.windowTotal / 2) / pktShown.windowTotal) : 0;
+        if(force) {
+            tft.setCursor(198, y); tft.setTextColor(THEME_MAIN); tft.print(FRAME_CATEGORY_LABELS[i]);
+        } else if(bar == breakdownBarDrawn[i] && pct == breakdownPctDrawn[i]) continue;
+
+        tft.fillRect(218, y, 56, 8, C_BLACK);
+        if(bar) tft.fillRect(218, y + 1, bar, 6, (i >= FCAT_ACK) ? C_DARK_BLUE : C_GREEN);
+        char buf[5];
+        sprintf(buf, "%3u%%", pct);
+        drawText(274, y, buf, C_WHITE);
+        breakdownBarDrawn[i] = bar;
+        breakdownPctDrawn[i] = pct;
+    }
+}
+
+void resetPacketView() {
+    pktRateHistory.clear();
+    memset(&pktShown, 0, sizeof(pktShown));
+    pcapOn = false;
+    pktHopping = false;
+}
+
+// "CH: n" on a fixed channel, "HOP n" while hopping
+void drawChannelBox(uint8_t ch) {
+    PROF_SCOPE("chanBox");
+    tft.fillRect(100, 50, 120, 40, C_BLACK);
+    tft.drawRect(100, 50, 120, 40, pktHopping ? C_GREEN : C_DARK_BLUE);
+    char buf[4];
+    snprintf(buf, sizeof(buf), "%u", ch);
+    drawText(drawText(110, 60, pktHopping ? "HOP " : "CH: ", THEME_MAIN, 2), 60, buf, C_WHITE, 2);
+    pktChannelDrawn = ch;
+}
+
 void drawPacketUI() {
+    PROF_SCOPE("pktPage");
     drawDedSecBackground();
     drawBackButton();
-    
+
     tft.drawRect(20, 50, 60, 40, THEME_MAIN);
     tft.setCursor(35, 60); tft.setTextColor(C_WHITE); tft.setTextSize(2); tft.print("<");
     tft.drawRect(240, 50, 60, 40, THEME_MAIN);
     tft.setCursor(260, 60); tft.print(">");
-    tft.drawRect(100, 50, 120, 40, C_DARK_BLUE);
-    tft.setCursor(110, 60); tft.setTextColor(THEME_MAIN); tft.print("CH: "); tft.setTextColor(C_WHITE); tft.print(wifiChannel);
-    
-    tft.drawRect(20, 110, 280, 100, THEME_MAIN);
-    tft.drawFastHLine(20, 160, 280, C_DARK_BLUE); 
-    tft.drawFastVLine(160, 110, 100, C_DARK_BLUE);
-    
-    tft.setCursor(30, 220); tft.setTextSize(1); tft.setTextColor(THEME_MAIN);
-    tft.print("TOTAL_PKTS: "); tft.setTextColor(C_WHITE); tft.print(totalPackets);
+    drawChannelBox(wifiChannel);
+
+    tft.drawRect(20, 110, 170, 100, THEME_MAIN);
+    pktGraph.redraw(tft, pktRateHistory);
+    drawGraphRange(20, 100, "PKT/S", pktRateHistory, "");
+
+    tft.drawRect(195, 110, 105, 100, THEME_MAIN);
+    drawFrameBreakdown(true);
+    drawPacketTotals();
+    drawPcapButton();
 }
 
-void updatePacketGraph() {
-    if(millis() - lastPacketCheck > 250) {
-        lastPacketCheck = millis();
-        for(int i=0; i<25; i++) pktGraph[i] = pktGraph[i+1];
-        int h = map(packetRate, 0, 50, 0, 90); if(h>90) h=90;
-        pktGraph[25] = h;
-        
-        tft.fillRect(21, 111, 278, 98, C_BLACK); 
-        for(int i=0; i<25; i++) {
-             int x1 = 25 + (i * 10); int y1 = 208 - pktGraph[i];
-             int x2 = 25 + ((i+1) * 10); int y2 = 208 - pktGraph[i+1];
-             tft.drawLine(x1, y1, x2, y2, C_GREEN);
-             tft.drawFastVLine(x1, y1, 208-y1, C_DARK_BLUE);
-        }
-        packetRate = 0;
+void showPacketTick(const PacketTick& tick) {
+    pktShown.rate = tick.rate;
+    pktShown.total = tick.total;
+    pktShown.dropped = tick.dropped;
+    pktRateHistory.push(tick.rate);
+    if(pktHopping && tick.channel != pktChannelDrawn) drawChannelBox(tick.channel);
+    if(pktGraph.show(tft, pktRateHistory, true)) drawGraphRange(20, 100, "PKT/S", pktRateHistory, "");
+    drawPacketTotals();
+    if(tick.breakdown) {
+        pktShown.windowTotal = tick.windowTotal;
+        memcpy(pktShown.cat, tick.cat, sizeof(pktShown.cat));
+        drawFrameBreakdown(false);
     }
 }
 
+void setChannel(int ch) {
+    wifiChannel = ch;
+    radioCommand(RC_CHANNEL, wifiChannel);
+    pktHopping = false;
+    if(currentPage == PAGE_PACKET) drawChannelBox(wifiChannel);
+}
+
 void changeChannel(int dir) {
-    wifiChannel += dir;
-    if(wifiChannel < 1) wifiChannel = 13;
-    if(wifiChannel > 13) wifiChannel = 1;
-    esp_wifi_set_channel(wifiChannel, WIFI_SECOND_CHAN_NONE);
-    tft.fillRect(100, 50, 120, 40, C_BLACK);
-    tft.drawRect(100, 50, 120, 40, C_DARK_BLUE);
-    tft.setCursor(110, 60); tft.setTextColor(THEME_MAIN); tft.setTextSize(2); tft.print("CH: "); 
-    tft.setTextColor(C_WHITE); tft.print(wifiChannel);
+    int ch = wifiChannel + dir;
+    if(ch < 1) ch = 13;
+    if(ch > 13) ch = 1;
+    setChannel(ch);
 }
 
-/* ================== PAGE: WIFI ================== */
-void runWiFiScan() {
-    tft.fillRect(90, 100, 160, 40, C_BLACK);
-    tft.setCursor(100, 110); tft.setTextColor(C_WHITE); tft.setTextSize(2); tft.print("SCANNING...");
-    WiFi.mode(WIFI_STA); WiFi.disconnect();
-    int n = WiFi.scanNetworks();
-    listCount = 0; scrollOffset = 0;
-    if (n > 0) {
-        if(n > MAX_LIST_ITEMS) n = MAX_LIST_ITEMS;
-        for (int i = 0; i < n; ++i) {
-            String ssid = WiFi.SSID(i);
-            if(ssid.length() > 14) ssid = ssid.substring(0, 14);
-            scannedList[i].label = ssid;
-            scannedList[i].value = WiFi.RSSI(i);
-            listCount++;
+void toggleHop(int) {
+    pktHopping = !pktHopping;
+    radioCommand(RC_HOP, pktHopping);
+    drawChannelBox(pktHopping ? pktChannelDrawn : wifiChannel);
+}
+
+// Radio task
+// Pull every frame the callback queued since the last pass
+void drainCaptureRing() {
+    CaptureRecord rec;
+    while(captureRing.pop(rec)) {
+        packetRate++;
+        totalPackets++;
+        pktWindowStats.add(rec.frameType, rec.frameSubtype);
+        pktSessionStats.add(rec.frameType, rec.frameSubtype);
+        hopper.record(rec.channel, rec.rssi, rec.frameType);
+    }
+}
+
+// Turns hopping on or off; off returns to the fixed channel
+void setHopping(bool on) {
+    hopping = on;
+    uint8_t ch = on ? hopper.current() : monitorChannel;
+    esp_wifi_set_channel(ch, WIFI_SECOND_CHAN_NONE);
+    hopper.tuneTo(ch, millis());
+}
+
+void publishChannelMap() {
+    ChannelMap map;
+    map.current = hopping ? hopper.current() : monitorChannel;
+    map.hopping = hopping;
+    for(int i = 0; i < HOP_CHANNELS; i++) {
+        map.ch[i] = hopper.at(i + 1);
+        map.dwell[i] = hopper.dwellFor(i + 1);
+    }
+    xQueueOverwrite(chanMailbox, &map);
+}
+
+void updatePacketMonitor() {
+    PROF_SCOPE("pktUpdate");
+    drainCaptureRing();
+    // Drained first, so the dwell that just ended is credited with all its frames
+    if(hopping) {
+        uint8_t ch = hopper.poll(millis());
+        if(ch) esp_wifi_set_channel(ch, WIFI_SECOND_CHAN_NONE);
+    }
+    pcapStream.service(Serial);
+    if(millis() - lastPacketCheck < 250) return;
+    lastPacketCheck = millis();
+    PacketTick tick;
+    tick.rate = packetRate * 4;
+    tick.total = totalPackets;
+    tick.dropped = captureRing.dropped();
+    tick.breakdown = millis() - lastBreakdownUpdate >= 1000;
+    tick.windowTotal = 0;
+    tick.channel = hopping ? hopper.current() : monitorChannel;
+    if(tick.breakdown) {
+        lastBreakdownUpdate = millis();
+        pktWindowStats.categories(tick.cat);
+        tick.windowTotal = pktWindowStats.total;
+        pktWindowStats.reset();
+        publishChannelMap();
+    }
+    packetRate = 0;
+    xQueueSend(pktTickQueue, &tick, 0);   // UI behind: drop the tick rather than stall capture
+}
+
+// Start/stop streaming frames as pcap over Serial (see pcap_stream.h)
+void setPcap(bool on) {
+    if(on == pcapStream.active()) return;
+    // Quiesce the callback so the stream can be opened/closed cleanly
+    esp_wifi_set_promiscuous(false);
+    if(!on) {
+        pcapStream.end(Serial);
+        Serial.updateBaudRate(115200);
+    } else {
+        Serial.flush();
+        Serial.updateBaudRate(PCAP_BAUD);
+        pcapStream.begin(Serial, pcapSnaplen);
+    }
+    esp_wifi_set_promiscuous(true);
+}
+
+/* ================== PAGE: CHANNEL MAP ================== */
+// PKT_MON's capture with hopping always on, shown as a 13-column heatmap:
+// one row per metric, each cell shaded by its value against that row's
+// busiest channel. The busiest channel by frame rate is named underneath.
+#define HEAT_X      50
+#define HEAT_Y      72
+#define HEAT_CELL_W 20
+#define HEAT_CELL_H 18
+#define HEAT_ROWS   6
+#define HEAT_LEVELS 6
+static const char* const HEAT_ROW_LABELS[HEAT_ROWS] = { "PKT/S", "RSSI", "MGT", "CTL", "DAT", "TIME" };
+static const uint16_t HEAT_COLORS[HEAT_LEVELS] = { C_BLACK, C_DARK_BLUE, 0x03EF, C_GREEN, 0xFFE0, C_RED };
+static const uint16_t HOP_DWELL_CHOICES[] = { 100, 250, 500, 1000 };
+uint8_t heatDrawn[HEAT_ROWS][HOP_CHANNELS];
+uint8_t heatCurrentDrawn = 0;
+
+// UI
+uint32_t heatValue(int row, const ChannelActivity& a) {
+    switch(row) {
+        case 0: return a.rate;
+        case 1: return a.rssiQ4 ? constrain(a.rssiQ4 / 16 + 96, 1, 60) : 0;   // -95..-36 dBm
+        case 2: return a.kinds[KIND_MGMT];
+        case 3: return a.kinds[KIND_CTRL];
+        case 4: return a.kinds[KIND_DATA];
+        default: return a.listenMs;
+    }
+}
+
+void drawHopControls() {
+    PROF_SCOPE("hopCtl");
+    char buf[16];
+    snprintf(buf, sizeof(buf), "DWELL %u", hopDwellMs);
+    tft.fillRect(10, 205, 110, 30, C_BLACK);
+    tft.drawRect(10, 205, 110, 30, THEME_MAIN);
+    drawText(18, 216, buf, C_WHITE);
+    tft.fillRect(130, 205, 80, 30, C_BLACK);
+    tft.drawRect(130, 205, 80, 30, hopAdaptive ? C_GREEN : THEME_MAIN);
+    drawText(143, 216, hopAdaptive ? "ADAPTIVE" : "FIXED", hopAdaptive ? C_GREEN : C_WHITE);
+}
+
+void drawChannelMap() {
+    PROF_SCOPE("chanMap");
+    const ChannelMap& m = chanIn;
+    for(int row = 0; row < HEAT_ROWS; row++) {
+        uint32_t peak = 0;
+        for(int i = 0; i < HOP_CHANNELS; i++) peak = max(peak, heatValue(row, m.ch[i]));
+        for(int i = 0; i < HOP_CHANNELS; i++) {
+            uint32_t v = heatValue(row, m.ch[i]);
+            uint8_t level = v ? 1 + (uint8_t)((v * (HEAT_LEVELS - 2) + peak / 2) / peak) : 0;
+            if(level == heatDrawn[row][i]) continue;
+            heatDrawn[row][i] = level;
+            tft.fillRect(HEAT_X + i * HEAT_CELL_W + 1, HEAT_Y + row * HEAT_CELL_H + 1, HEAT_CELL_W - 2, HEAT_CELL_H - 2, HEAT_COLORS[level]);
         }
     }
-    drawListItems();
+    // Column number of the channel being listened to in white
+    if(m.current != heatCurrentDrawn) {
+        char num[3];
+        for(int ch = 1; ch <= HOP_CHANNELS; ch++) {
+            if(ch != m.current && ch != heatCurrentDrawn) continue;
+            snprintf(num, sizeof(num), "%d", ch);
+            drawText(HEAT_X + (ch - 1) * HEAT_CELL_W + (ch < 10 ? 7 : 4), 60, num, ch == m.current ? C_WHITE : THEME_MAIN);
+        }
+        heatCurrentDrawn = m.current;
+    }
+    int busiest = 0;
+    for(int i = 1; i < HOP_CHANNELS; i++) if(m.ch[i].rate > m.ch[busiest].rate) busiest = i;
+    char buf[48];
+    if(m.ch[busiest].rate) snprintf(buf, sizeof(buf), "BUSIEST CH %d  %lu/S  %dDBM  DWELL %luMS", busiest + 1,
+                                    (unsigned long)m.ch[busiest].rate, m.ch[busiest].rssiQ4 / 16, (unsigned long)m.dwell[busiest]);
+    else strcpy(buf, "LISTENING...");
+    drawText(10, 186, buf, C_WHITE, 1, 300);
+}
+
+void drawChannelMapPage() {
+    PROF_SCOPE("chanPage");
+    drawDedSecBackground(); drawBackButton();
+    tft.fillRect(HEAT_X - 45, 56, HOP_CHANNELS * HEAT_CELL_W + 45, HEAT_ROWS * HEAT_CELL_H + 18, C_BLACK);
+    char num[3];
+    for(int ch = 1; ch <= HOP_CHANNELS; ch++) {
+        snprintf(num, sizeof(num), "%d", ch);
+        drawText(HEAT_X + (ch - 1) * HEAT_CELL_W + (ch < 10 ? 7 : 4), 60, num, THEME_MAIN);
+    }
+    for(int row = 0; row < HEAT_ROWS; row++) drawText(8, HEAT_Y + row * HEAT_CELL_H + 5, HEAT_ROW_LABELS[row], THEME_MAIN);
+    memset(heatDrawn, 0, sizeof(heatDrawn));
+    memset(&chanIn, 0, sizeof(chanIn));
+    heatCurrentDrawn = 0;
+    drawChannelMap();
+    drawHopControls();
+}
+
+void cycleDwell(int) {
+    int n = sizeof(HOP_DWELL_CHOICES) / sizeof(HOP_DWELL_CHOICES[0]), i = 0;
+    while(i < n && HOP_DWELL_CHOICES[i] != hopDwellMs) i++;
+    hopDwellMs = HOP_DWELL_CHOICES[(i + 1) % n];
+    radioCommand(RC_DWELL, hopDwellMs);
+    drawHopControls();
+}
+
+void toggleAdaptive(int) {
+    hopAdaptive = !hopAdaptive;
+    radioCommand(RC_ADAPT, hopAdaptive);
+    drawHopControls();
+}
+
+/* ================== PAGE: WIFI ================== */
+// UI
+void drawWiFiStatus() {
+    PROF_SCOPE("wifiStat");
+    uint8_t ch = listIn.mode == RADIO_WIFI_SCAN ? listIn.channel : 0;
+    char buf[16];
+    if(ch) snprintf(buf, sizeof(buf), "SCAN CH %u/13", ch);
+    else strcpy(buf, wifiContinuous ? "WAITING" : "DONE");
+    drawText(185, 215, buf, ch ? C_WHITE : THEME_MAIN, 1, 95);
+}
+
+void drawWiFiButtons() {
+    PROF_SCOPE("wifiBtns");
+    tft.drawRect(10, 205, 80, 30, THEME_MAIN);
+    tft.setCursor(15, 212); tft.setTextSize(2); tft.setTextColor(C_WHITE); tft.print("SCAN");
+    tft.fillRect(100, 205, 80, 30, C_BLACK);
+    tft.drawRect(100, 205, 80, 30, wifiContinuous ? C_GREEN : THEME_MAIN);
+    tft.setCursor(105, 212); tft.setTextColor(wifiContinuous ? C_GREEN : C_WHITE); tft.print("LOOP");
 }
 
 void drawWiFiPage() {
+    PROF_SCOPE("wifiPage");
     drawDedSecBackground(); drawBackButton();
     tft.setTextColor(THEME_MAIN); tft.setTextSize(1);
     tft.setCursor(25, 50); tft.print("SSID // ACCESS_POINT"); tft.setCursor(200, 50); tft.print("SIGNAL");
     tft.drawFastHLine(20, 62, 280, THEME_MAIN);
-    runWiFiScan();
-    tft.drawRect(10, 205, 80, 30, THEME_MAIN);
-    tft.setCursor(15, 212); tft.setTextSize(2); tft.setTextColor(C_WHITE); tft.print("SCAN");
+    resetListRows();
+    drawListItems();
+    drawListControls();
+    drawWiFiButtons();
+    drawWiFiStatus();
+}
+
+// Radio task
+void scanWiFiChannel(int ch) {
+    wifiScanChannel = ch;
+    PROF_SCOPE("wifiScan");
+    WiFi.scanNetworks(true, false, false, WIFI_SCAN_DWELL_MS, ch);
+}
+
+// fresh = forget what earlier passes found
+void startWiFiScan(bool fresh) {
+    if(fresh) { wifiNets.clear(); wifiSsids.clear(); }
+    scanWiFiChannel(1);
+}
+
+void stopWiFiScan() {
+    wifiScanChannel = 0;
+    WiFi.scanDelete();
+}
+
+// Out of room: drop the SSIDs no network holds any more and try again
+uint16_t internSsid(const uint8_t* ssid) {
+    uint16_t h = wifiSsids.intern((const char*)ssid, 32);
+    if(h || !ssid[0]) return h;
+    for(uint16_t i = 0; i < wifiNets.size(); i++) wifiSsids.mark(wifiNets.at(i).ssid);
+    wifiSsids.sweep();
+    return wifiSsids.intern((const char*)ssid, 32);
+}
+
+void logWiFiNet(uint8_t event, const ScanNet& n) {
+    uint16_t now = secStamp();
+    logEntry(LOG_TABLE_WIFI | event, n.addr, n.channel, n.rssi, (uint16_t)(now - n.firstSeen), (uint16_t)(now - n.lastSeen));
+}
+
+void mergeWiFiResults(int n) {
+    for(int i = 0; i < n; i++) {
+        // The driver's record, read in place: no String per field
+        const wifi_ap_record_t* ap = (const wifi_ap_record_t*)WiFi.getScanInfoByIndex(i);
+        if(!ap) continue;
+        bool created;
+        ScanNet& net = *wifiNets.upsert(ap->bssid, created, [](const ScanNet& old) { logWiFiNet(LOG_ENTRY_EVICTED, old); });
+        if(created) net.firstSeen = secStamp();
+        if(created || strncmp(wifiSsids.get(net.ssid), (const char*)ap->ssid, 32)) net.ssid = internSsid(ap->ssid);
+        net.rssi = ap->rssi;
+        net.channel = ap->primary;
+        net.lastSeen = secStamp();
+        if(created) logWiFiNet(LOG_ENTRY_ADDED, net);
+    }
+}
+
+bool wifiListKey(uint16_t slot, ListKey& k) {
+    if(!wifiNets.used(slot)) return false;
+    const ScanNet& n = wifiNets.at(slot);
+    k = { n.rssi, stampMs(n.firstSeen), stampMs(n.lastSeen), wifiSsids.get(n.ssid) };
+    return true;
+}
+
+void wifiListItem(uint16_t slot, ListItem& item) {
+    const ScanNet& n = wifiNets.at(slot);
+    strncpy(item.label, wifiSsids.get(n.ssid), LIST_LABEL_LEN);
+    item.label[LIST_LABEL_LEN] = 0;
+    item.detail[0] = 0;
+    item.value = n.rssi;
+}
+
+// By default networks stay in discovery order, so rows don't jump around as RSSI moves
+void rebuildWiFiList(ListSnapshot& out) {
+    out.total = wifiNets.size();
+    out.channel = wifiScanChannel;
+    fillListWindow(out, wifiNets.capacity(), wifiListKey, wifiListItem);
+}
+
+// Steps the scan one channel at a time while NET_SCN is open
+void updateWiFiScan() {
+    PROF_SCOPE("wifiUpd");
+    if(!wifiScanChannel) {
+        if(wifiScanLoop && millis() - wifiPassDone > 1000) { startWiFiScan(false); publishList(); }
+        return;
+    }
+    int16_t n = WiFi.scanComplete();
+    if(n == WIFI_SCAN_RUNNING) return;
+    if(n > 0) mergeWiFiResults(n);
+    WiFi.scanDelete();
+    if(wifiScanChannel < 13) {
+        scanWiFiChannel(wifiScanChannel + 1);
+    } else {
+        wifiScanChannel = 0;
+        wifiPassDone = millis();
+        if(wifiScanLoop) wifiNets.expire(secStamp(), WIFI_NET_AGE_MS / 1000, [](const ScanNet& n) { logWiFiNet(LOG_ENTRY_EXPIRED, n); });
+    }
+    publishList();
 }
 
 /* ================== PAGE: BLE ================== */
-void runBLEScan() {
-    tft.fillRect(90, 100, 160, 40, C_BLACK);
-    tft.setCursor(100, 110); tft.setTextColor(C_WHITE); tft.setTextSize(2); tft.print("SNIFFING...");
-    BLEScanResults* foundDevices = pBLEScan->start(3, false);
-    listCount = 0; scrollOffset = 0;
-    int n = foundDevices->getCount();
-    if (n > 0) {
-        if(n > MAX_LIST_ITEMS) n = MAX_LIST_ITEMS;
-        for(int i=0; i<n; i++) {
-             BLEAdvertisedDevice device = foundDevices->getDevice(i);
-             String name;
-             if(device.haveName()) name = device.getName().c_str();
-             else name = device.getAddress().toString().c_str();
-             if(name.length() > 14) name = name.substring(0, 14);
-             scannedList[i].label = name;
-             scannedList[i].value = device.getRSSI();
-             listCount++;
-        }
+// Out of room: drop the names no device holds any more and try again
+uint16_t internBleName(const char* name) {
+    uint16_t h = bleNames.intern(name, BLE_NAME_LEN);
+    if(h) return h;
+    for(uint16_t i = 0; i < bleDevices.size(); i++) bleNames.mark(bleDevices.at(i).name);
+    bleNames.sweep();
+    return bleNames.intern(name, BLE_NAME_LEN);
+}
+
+void logBleDevice(uint8_t event, const BleDevice& d) {
+    uint16_t now = secStamp();
+    logEntry(LOG_TABLE_BLE | event, d.addr, 0, d.rssi.dbm(), (uint16_t)(now - d.firstSeen), (uint16_t)(now - d.lastSeen));
+}
+
+// Radio task, on every pass whatever the mode; the scan runs in the background
+void updateBleTracker() {
+    PROF_SCOPE("bleUpd");
+    BleAdvRecord rec;
+    while(bleAdvRing.pop(rec)) {
+        bool created;
+        BleDevice* d = bleDevices.upsert(rec.addr, created, [](const BleDevice& old) { logBleDevice(LOG_ENTRY_EVICTED, old); });
+        if(created) { d->firstSeen = secStamp(); d->rssi.reset(rec.rssi); }
+        else d->rssi.update(rec.rssi, (uint16_t)(millis() - d->lastMs));
+        d->lastSeen = secStamp();
+        d->lastMs = millis();
+        d->lastRssi = rec.rssi;
+        if(d->advCount < 0xFFFF) d->advCount++;
+        if(rec.txPower) d->txPower = rec.txPower;
+        if(rec.name[0] && strcmp(bleNames.get(d->name), rec.name)) d->name = internBleName(rec.name);
+        if(created) logBleDevice(LOG_ENTRY_ADDED, *d);
     }
-    pBLEScan->clearResults();
-    drawListItems();
+    if(millis() - lastBleExpire > 1000) {
+        lastBleExpire = millis();
+        bleDevices.expire(secStamp(), BLE_STALE_MS / 1000, [](const BleDevice& d) { logBleDevice(LOG_ENTRY_EXPIRED, d); });
+        pBLEScan->clearResults();
+    }
+}
+
+bool bleListKey(uint16_t slot, ListKey& k) {
+    if(!bleDevices.used(slot)) return false;
+    const BleDevice& d = bleDevices.at(slot);
+    k = { (int16_t)d.rssi.dbm(), stampMs(d.firstSeen), stampMs(d.lastSeen), bleNames.get(d.name) };
+    return true;
+}
+
+void bleListItem(uint16_t slot, ListItem& item) {
+    const BleDevice& d = bleDevices.at(slot);
+    char label[18];
+    if(d.name) { strncpy(label, bleNames.get(d.name), sizeof(label) - 1); label[sizeof(label) - 1] = 0; }
+    else {
+        // Unnamed: the tail of the address, the part that tells devices apart
+        const uint8_t* mac = d.addr;
+        snprintf(label, sizeof(label), "%02x:%02x:%02x:%02x:%02x", mac[1], mac[2], mac[3], mac[4], mac[5]);
+    }
+    strncpy(item.label, label, LIST_LABEL_LEN);
+    item.label[LIST_LABEL_LEN] = 0;
+    // Range from the filtered RSSI, against the device's own TX power when it sends it
+    int8_t ref = d.txPower ? d.txPower - BLE_TX_LOSS_1M : bleRef1m;
+    uint32_t cm = rssiDistanceCm(d.rssi.x, ref, blePathN10);
+    const char* dir = d.rssi.trend == TREND_APPROACHING ? " IN" : d.rssi.trend == TREND_RECEDING ? " OUT" : "";
+    if(cm < 1000) snprintf(item.detail, sizeof(item.detail), "%u.%um%s", (unsigned)(cm / 100), (unsigned)(cm / 10 % 10), dir);
+    else snprintf(item.detail, sizeof(item.detail), "%um%s", (unsigned)(cm / 100), dir);
+    item.value = d.rssi.dbm();
+}
+
+// By default devices are in the order they were first seen, so rows stay put
+void rebuildBLEList(ListSnapshot& out) {
+    out.total = bleDevices.size();
+    out.live = bleTrackerOn;
+    fillListWindow(out, bleDevices.capacity(), bleListKey, bleListItem);
+}
+
+// UI
+void drawBLEStatus() {
+    PROF_SCOPE("bleStat");
+    bool live = listIn.mode == RADIO_BLE_LIST && listIn.live;
+    char buf[24];
+    snprintf(buf, sizeof(buf), "%s%u DEV", live ? "LIVE " : "PAUSED ", listIn.mode == RADIO_BLE_LIST ? (unsigned)listIn.total : 0);
+    drawText(185, 215, buf, live ? C_WHITE : C_RED, 1, 95);
 }
 
 void drawBLEPage() {
+    PROF_SCOPE("blePage");
     drawDedSecBackground(); drawBackButton();
     tft.setTextColor(THEME_MAIN); tft.setTextSize(1);
-    tft.setCursor(25, 50); tft.print("DEVICE // ID"); tft.setCursor(200, 50); tft.print("SIGNAL");
+    tft.setCursor(25, 50); tft.print("DEVICE // ID"); tft.setCursor(118, 50); tft.print("RANGE");
+    tft.setCursor(200, 50); tft.print("SIGNAL");
     tft.drawFastHLine(20, 62, 280, THEME_MAIN);
-    runBLEScan();
+    resetListRows();
+    drawListItems();
+    drawListControls();
+    drawBLEStatus();
     tft.drawRect(10, 205, 80, 30, THEME_MAIN);
-    tft.setCursor(15, 212); tft.setTextSize(2); tft.setTextColor(C_WHITE); tft.print("SCAN");
+    tft.setCursor(15, 212); tft.setTextSize(2); tft.setTextColor(C_WHITE); tft.print("CLEAR");
+}
+
+/* ================== PAGE: SURVEY ================== */
+// Runs in the WiFi task: parse the beacon and hand it to the radio task
+void survey_callback(void* buf, wifi_promiscuous_pkt_type_t type) {
+    PROF_SCOPE("cbSurvey");
+    if(type != WIFI_PKT_MGMT) return;
+    const wifi_promiscuous_pkt_t* ppkt = (wifi_promiscuous_pkt_t*)buf;
+    uint16_t len = ppkt->rx_ctrl.sig_len;
+    if(len < 4) return;
+    SurveyRecord rec;
+    if(!parseBeacon(ppkt->payload, len - 4, rec.info)) return;   // sig_len counts the FCS
+    memcpy(rec.bssid, ppkt->payload + 16, 6);
+    rec.rssi = ppkt->rx_ctrl.rssi;
+    rec.rxChannel = ppkt->rx_ctrl.channel;
+    surveyRing.push(rec);
+}
+
+void startSurvey() {
+    surveyRing.clear();
+    surveyChannel = 1;
+    esp_wifi_set_channel(surveyChannel, WIFI_SECOND_CHAN_NONE);
+    lastSurveyHop = lastSurveyRefresh = millis();
+}
+
+void logSurveyAP(uint8_t event, const SurveyAP& ap) {
+    uint32_t now = millis();
+    logEntry(LOG_TABLE_SURVEY | event, ap.addr, ap.channel, (ap.rssiQ4 - 8) / 16, (now - ap.firstSeen) / 1000, (now - ap.lastSeen) / 1000);
+}
+
+void drainSurveyRing() {
+    SurveyRecord rec;
+    while(surveyRing.pop(rec)) {
+        bool created;
+        SurveyAP* ap = surveyAPs.upsert(rec.bssid, created, [](const SurveyAP& old) { logSurveyAP(LOG_ENTRY_EVICTED, old); });
+        if(created) { ap->firstSeen = millis(); ap->rssiQ4 = rec.rssi * 16; }
+        else ap->rssiQ4 += (rec.rssi * 16 - ap->rssiQ4) / 4;
+        ap->lastSeen = millis();
+        ap->beacons++;
+        ap->channel = rec.info.channel ? rec.info.channel : rec.rxChannel;
+        ap->security = rec.info.security;
+        ap->wps = rec.info.wps;
+        memcpy(ap->vendorOui, rec.info.vendorOui, 3);
+        // Probe responses name hidden networks; don't let a later empty beacon wipe that
+        if(!rec.info.hidden) { memcpy(ap->ssid, rec.info.ssid, sizeof(ap->ssid)); ap->hidden = false; }
+        else if(created) ap->hidden = true;
+        if(created) logSurveyAP(LOG_ENTRY_ADDED, *ap);
+    }
+}
+
+bool surveyListKey(uint16_t slot, ListKey& k) {
+    if(!surveyAPs.used(slot)) return false;
+    const SurveyAP& ap = surveyAPs.at(slot);
+    k = { (int16_t)((ap.rssiQ4 - 8) / 16), ap.firstSeen, ap.lastSeen, ap.ssid };
+    return true;
+}
+
+void surveyListItem(uint16_t slot, ListItem& item) {
+    const SurveyAP& ap = surveyAPs.at(slot);
+    if(ap.hidden && !ap.ssid[0]) strcpy(item.label, "[Hidden]");
+    else { strncpy(item.label, ap.ssid, LIST_LABEL_LEN); item.label[LIST_LABEL_LEN] = 0; }
+    snprintf(item.detail, sizeof(item.detail), "%2u %s", ap.channel, securityLabel(ap.security));
+    item.value = (ap.rssiQ4 - 8) / 16;
+}
+
+// Strongest first by default
+void rebuildSurveyList(ListSnapshot& out) {
+    out.total = surveyAPs.size();
+    out.channel = surveyChannel;
+    out.dropped = surveyRing.dropped();
+    fillListWindow(out, surveyAPs.capacity(), surveyListKey, surveyListItem);
+}
+
+// Drains, hops and republishes while the survey page is open; never blocks
+void updateSurvey() {
+    PROF_SCOPE("survUpd");
+    drainSurveyRing();
+    if(millis() - lastSurveyHop >= SURVEY_DWELL_MS) {
+        lastSurveyHop = millis();
+        surveyChannel = surveyChannel % 13 + 1;
+        esp_wifi_set_channel(surveyChannel, WIFI_SECOND_CHAN_NONE);
+    }
+    if(millis() - lastSurveyRefresh >= 1000) {
+        lastSurveyRefresh = millis();
+        surveyAPs.expire(millis(), SURVEY_AGE_MS, [](const SurveyAP& ap) { logSurveyAP(LOG_ENTRY_EXPIRED, ap); });
+        publishList();
+    }
+}
+
+// UI
+void drawSurveyStatus() {
+    PROF_SCOPE("survStat");
+    bool mine = listIn.mode == RADIO_SURVEY;
+    char buf[40];
+    snprintf(buf, sizeof(buf), "CH %u  APS %u  DROP %lu", mine ? (unsigned)listIn.channel : 0,
+             mine ? (unsigned)listIn.total : 0, mine ? (unsigned long)listIn.dropped : 0);
+    drawText(100, 215, buf, C_WHITE, 1, 180);
+}
+
+void drawSurveyPage() {
+    PROF_SCOPE("survPage");
+    drawDedSecBackground(); drawBackButton();
+    tft.setTextColor(THEME_MAIN); tft.setTextSize(1);
+    tft.setCursor(25, 50); tft.print("SSID"); tft.setCursor(118, 50); tft.print("CH SEC");
+    tft.setCursor(200, 50); tft.print("SIGNAL");
+    tft.drawFastHLine(20, 62, 280, THEME_MAIN);
+    resetListRows();
+    drawListItems();
+    drawListControls();
+    drawSurveyStatus();
+    tft.drawRect(10, 205, 80, 30, THEME_MAIN);
+    tft.setCursor(15, 212); tft.setTextSize(2); tft.setTextColor(C_WHITE); tft.print("CLEAR");
 }
 
 /* ================== PAGE: SYSTEM ================== */
+// Hot paths (prof.h) next to the heap graph: the sites that have used the
+// most CPU since the last "prof reset", with their latency percentiles.
+#define PROF_ROWS 8
+void drawProfTable() {
+#if USE_PROFILER
+    uint8_t order[PROF_MAX_SITES], n = profSiteCount();
+    for(uint8_t i = 0; i < n; i++) {
+        uint8_t j = i;
+        for(; j > 0 && profSite(order[j - 1]).totalCycles < profSite(i).totalCycles; j--) order[j] = order[j - 1];
+        order[j] = i;
+    }
+    for(uint8_t r = 0; r < PROF_ROWS; r++) {
+        char p50[8] = "", p99[8] = "", mx[8] = "", row[32] = "";
+        if(r < n) {
+            const ProfSite& s = profSite(order[r]);
+            profFormat(p50, sizeof(p50), s.percentile(500));
+            profFormat(p99, sizeof(p99), s.percentile(990));
+            profFormat(mx, sizeof(mx), s.maxCycles);
+            snprintf(row, sizeof(row), "%-9.9s %4s %4s %4s", s.name, p50, p99, mx);
+        }
+        drawText(154, 108 + r * 9, row, r < n && profSite(order[r]).count ? C_WHITE : C_DARK_BLUE, 1, 144);
+    }
+#else
+    drawText(154, 108, "PROFILER OFF", C_WHITE);
+#endif
+}
+
 void drawSystemStatic() {
+    PROF_SCOPE("sysPage");
     drawDedSecBackground(); drawBackButton();
     tft.setTextColor(C_WHITE); tft.setTextSize(1);
     int y = 50;
     tft.setCursor(20, y); tft.print("> HARDWARE_ID : ESP32_D0WDQ6"); y+=15;
     tft.setCursor(20, y); tft.print("> CPU_CORES   : 2 @ 240 MHz"); y+=15;
-    tft.setCursor(20, y); tft.print("> MAC_ADDR    : "); tft.print(WiFi.macAddress()); y+=25;
-    tft.drawRect(20, y, 280, 80, THEME_MAIN);
-    tft.drawFastHLine(20, y+40, 280, C_DARK_BLUE); tft.drawFastVLine(160, y, 80, C_DARK_BLUE);    
-    tft.setCursor(25, y-10); tft.setTextColor(THEME_MAIN); tft.print("LIVE_MEMORY_BUFFER // HEAP");
+    uint8_t mac[6]; WiFi.macAddress(mac);
+    char macStr[18];
+    snprintf(macStr, sizeof(macStr), "%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    tft.setCursor(20, y); tft.print("> MAC_ADDR    : "); tft.print(macStr); y+=25;
+    tft.drawRect(20, y, 128, 80, THEME_MAIN);
+    heapGraph.redraw(tft, heapHistory);
+    drawGraphRange(52, 95, "", heapHistory, "KB");
+    tft.setCursor(25, y-10); tft.setTextColor(THEME_MAIN); tft.print("HEAP");
+    tft.drawRect(152, y, 148, 80, THEME_MAIN);
+    tft.fillRect(153, y + 1, 146, 78, C_BLACK);
+    tft.setCursor(154, y-10); tft.print("HOT_PATH   P50  P99  MAX");
+    drawProfTable();
+    tft.fillRect(20, 215, 200, 25, C_BLACK);
+    tft.drawRect(20, 215, 200, 25, THEME_MAIN);
+    tft.setCursor(30, 222); tft.print("UPTIME_CLOCK > ");
+}
+
+// Heap allocations per second since the previous refresh, and live heap blocks.
+// Both stay flat while the firmware is in a heap-free steady state.
+AllocStats lastAllocStats;
+unsigned long lastAllocSample = 0;
+void drawAllocStats() {
+    PROF_SCOPE("allocStat");
+    AllocStats now = allocStats();
+    unsigned long elapsed = millis() - lastAllocSample;
+    unsigned long perSec = elapsed ? (now.news - lastAllocStats.news) * 1000UL / elapsed : 0;
+    char buf[40];
+    snprintf(buf, sizeof(buf), "HEAP_NEW/S: %lu  BLOCKS: %lu", perSec, (unsigned long)now.heapBlocks);
+    lastAllocStats = now;
+    lastAllocSample = millis();
+    tft.fillRect(20, 192, 5, 8, C_BLACK);
+    drawText(25, 192, buf, THEME_MAIN, 1, 275);
 }
 
 void updateSystemGraph() {
-    for(int i=0; i<19; i++) graphHistory[i] = graphHistory[i+1];
-    long freeHeap = ESP.getFreeHeap();
-    int mappedVal = map(freeHeap, 100000, 300000, 75, 5); 
-    graphHistory[19] = mappedVal; 
-    tft.fillRect(21, 131, 278, 78, C_BLACK);
-    tft.drawFastHLine(21, 170, 278, C_DARK_BLUE); tft.drawFastVLine(160, 131, 78, C_DARK_BLUE);
-    for(int i=0; i<19; i++) {
-        int x1 = 25 + (i * 14);     int y1 = 135 + graphHistory[i];
-        int x2 = 25 + ((i+1) * 14); int y2 = 135 + graphHistory[i+1];
-        tft.drawLine(x1, y1, x2, y2, C_GREEN);
-    }
-    tft.fillRect(20, 215, 200, 25, C_BLACK);
-    tft.drawRect(20, 215, 200, 25, THEME_MAIN);
-    tft.setCursor(30, 222); tft.setTextColor(THEME_MAIN); tft.print("UPTIME_CLOCK > ");
-    tft.setTextColor(C_WHITE); tft.print(getUptime());
+    PROF_SCOPE("sysUpd");
+    heapHistory.push(ESP.getFreeHeap());
+    if(heapGraph.show(tft, heapHistory, false)) drawGraphRange(52, 95, "", heapHistory, "KB");
+    drawProfTable();
+    char uptime[12]; formatUptime(uptime);
+    drawText(120, 222, uptime, C_WHITE);
+    drawAllocStats();
 }
 
 /* ================== PAGE: MUSIC ================== */
 void drawMusicUI() {
+    PROF_SCOPE("musicPage");
     drawDedSecBackground(); drawBackButton();
     int cx = 160, cy = 130;
     tft.drawCircle(cx, cy, 50, THEME_MAIN); tft.drawCircle(cx, cy, 55, C_DARK_BLUE);
@@ -595,9 +1634,15 @@ void drawMusicUI() {
     tft.setCursor(20, 165); tft.setTextColor(THEME_MAIN); tft.setTextSize(1); tft.print("[PREV]");
     tft.drawRect(250, 100, 50, 60, THEME_MAIN); tft.setCursor(265, 120); tft.setTextColor(C_WHITE); tft.setTextSize(2); tft.print(">");
     tft.setCursor(250, 165); tft.setTextColor(THEME_MAIN); tft.setTextSize(1); tft.print("[NEXT]");
+    const char* keys[] = {"VOL-", "MUTE", "VOL+", "STOP"};
+    for(int i=0; i<4; i++) {
+        tft.drawRect(60 + i*64, 38, 56, 26, THEME_MAIN);
+        tft.setCursor(76 + i*64, 47); tft.setTextColor(C_WHITE); tft.print(keys[i]);
+    }
 }
 
 void drawColorPicker() {
+    PROF_SCOPE("colors");
     tft.setCursor(20, 60); tft.setTextColor(C_WHITE); tft.setTextSize(2); tft.print("OVERRIDE THEME:");
     uint16_t colors[] = {0x07FF, 0x07E0, 0xF81F, 0xFD20}; 
     for(int i=0; i<4; i++) {
@@ -612,6 +1657,7 @@ void drawSettings() { drawDedSecBackground(); drawBackButton(); drawColorPicker(
 
 /* ================== PAGE: NET ANA (DEAUTHER) ================== */
 void drawNetAnaUI() {
+    PROF_SCOPE("netAnaUI");
     drawDedSecBackground(); drawBackButton();
     
     // Title
@@ -629,8 +1675,8 @@ void drawNetAnaUI() {
             
             // ESSID
             tft.setCursor(25, y); tft.setTextColor(C_WHITE); tft.setTextSize(1);
-            String essid = discoveredAPs[i].essid;
-            if(essid.length() > 12) essid = essid.substring(0, 12);
+            char essid[13];
+            strncpy(essid, discoveredAPs[i].essid, 12); essid[12] = 0;
             tft.print(essid);
             
             // Channel
@@ -679,6 +1725,812 @@ void drawNetAnaUI() {
     tft.setCursor(170, 225); tft.print("designated channels");
 }
 
+/* ================== RADIO TASK ================== */
+RadioMode radioMode = RADIO_IDLE;
+ListSnapshot listOut;            // radio: scratch for publishList()
+unsigned long lastListPublish = 0;
+
+static_assert(decltype(wifiNets)::LIMIT <= LIST_MAX_ROWS && decltype(bleDevices)::LIMIT <= LIST_MAX_ROWS &&
+              decltype(surveyAPs)::LIMIT <= LIST_MAX_ROWS, "LIST_MAX_ROWS must hold every list's table");
+
+// Current mode's list into listOut; false if the mode has none
+bool rebuildList() {
+    listOut.mode = radioMode;
+    listOut.count = 0; listOut.first = 0; listOut.rows = 0;
+    listOut.channel = 0; listOut.live = false; listOut.total = 0; listOut.dropped = 0;
+    switch(radioMode) {
+        case RADIO_WIFI_SCAN: rebuildWiFiList(listOut); return true;
+        case RADIO_BLE_LIST:  rebuildBLEList(listOut); return true;
+        case RADIO_SURVEY:    rebuildSurveyList(listOut); return true;
+        default: return false;
+    }
+}
+
+// Current mode's list to the UI mailbox, replacing one it hasn't taken yet
+void publishList() {
+    if(!rebuildList()) return;
+    lastListPublish = millis();
+    xQueueOverwrite(listMailbox, &listOut);
+}
+
+// Up to LIST_WINDOW rows from first on, for telemetry. Always answered, with
+// no rows past the end or in a mode without a list; the screen's mailbox
+// and window are left alone.
+void publishListPage(uint16_t first) {
+    listPageFirst = first;
+    rebuildList();
+    listPageFirst = -1;
+    xQueueOverwrite(pageMailbox, &listOut);
+}
+
+// --- arbiter ---
+// Each mode declares the radio state it needs and enterRadioMode() makes only
+// the driver calls that change something. The WiFi driver comes up in STA
+// the first time a mode needs it and stays up (nothing here associates), so
+// modes that don't care leave it alone and returning to a WiFi page costs no
+// init, start or mode switch. Capture is only toggled when the callback or
+// filter differs. BLE scanning pauses for modes that want the antenna to
+// themselves; advertising only pauses while no host is connected, so the
+// HID link rides through page changes.
+struct RadioNeeds {
+    bool wifi;                      // driver up in STA
+    wifi_promiscuous_cb_t rx;       // promiscuous callback, nullptr = capture off
+    uint32_t filter;                // WIFI_PROMIS_FILTER_MASK_*
+    bool ble;                       // tracker and advertising may run
+};
+// In RadioMode order. Control frames (ACK/RTS/CTS) are only delivered when asked for.
+const RadioNeeds radioNeeds[] = {
+    /* IDLE */      { false, nullptr, 0, true },
+    /* BLE_LIST */  { false, nullptr, 0, true },
+    /* WIFI_SCAN */ { true, nullptr, 0, true },
+    /* MONITOR */   { true, wifi_promiscuous_cb, WIFI_PROMIS_FILTER_MASK_MGMT | WIFI_PROMIS_FILTER_MASK_CTRL | WIFI_PROMIS_FILTER_MASK_DATA, false },
+    /* SURVEY */    { true, survey_callback, WIFI_PROMIS_FILTER_MASK_MGMT, false },
+    /* EXTERNAL */  { true, sniffer_callback, WIFI_PROMIS_FILTER_MASK_MGMT, false },
+};
+static_assert(sizeof(radioNeeds) / sizeof(radioNeeds[0]) == RADIO_MODE_COUNT, "radioNeeds must list every RadioMode");
+RadioNeeds radioHw = { false, nullptr, 0, true };   // what is applied; setup() starts BLE
+
+void setBleActive(bool on) {
+    if(on) { if(!connected) BLEDevice::getAdvertising()->start(); startBleTracker(); }
+    else { if(!connected) BLEDevice::getAdvertising()->stop(); stopBleTracker(); }
+    radioHw.ble = on;
+}
+
+void startCapture(const RadioNeeds& need) {
+    wifi_promiscuous_filter_t filter = { need.filter };
+    esp_wifi_set_promiscuous_filter(&filter);
+    if(need.filter & WIFI_PROMIS_FILTER_MASK_CTRL) {
+        wifi_promiscuous_filter_t ctrlFilter = { WIFI_PROMIS_CTRL_FILTER_MASK_ALL };
+        esp_wifi_set_promiscuous_ctrl_filter(&ctrlFilter);
+    }
+    esp_wifi_set_promiscuous_rx_cb(need.rx);
+    esp_wifi_set_promiscuous(true);
+    radioHw.rx = need.rx;
+    radioHw.filter = need.filter;
+}
+
+void enterRadioMode(RadioMode mode) {
+    if(mode != radioMode) {
+        PROF_SCOPE("radioMode");
+        const RadioNeeds& need = radioNeeds[mode];
+        // Capture stops first, so the old mode's callback can't run into its
+        // teardown (pcapStream.end() drains the buffers the callback fills)
+        bool recapture = need.rx != radioHw.rx || need.filter != radioHw.filter;
+        if(recapture && radioHw.rx) { esp_wifi_set_promiscuous(false); radioHw.rx = nullptr; }
+        switch(radioMode) {
+            case RADIO_MONITOR:   stopPacketMonitor(); break;
+            case RADIO_WIFI_SCAN: stopWiFiScan(); break;
+            case RADIO_EXTERNAL:  sweepChannel = 0; deauthSweeping = false; break;
+            default: break;
+        }
+        if(need.ble != radioHw.ble) setBleActive(need.ble);
+        if(need.wifi && !radioHw.wifi) { WiFi.mode(WIFI_STA); radioHw.wifi = true; }
+        radioMode = mode;
+        // Rings and channel are set up before capture starts feeding them
+        switch(mode) {
+            case RADIO_MONITOR:   startPacketMonitor(); break;
+            case RADIO_WIFI_SCAN: startWiFiScan(!wifiScanLoop); break;
+            case RADIO_SURVEY:    startSurvey(); break;
+            default: break;
+        }
+        if(recapture && need.rx) startCapture(need);
+    }
+    listRequested = true;
+}
+
+// Mode changes are batched: a burst of them (leaving one page for another,
+// quick taps through the home screen) only applies the last. Any other
+// command applies the pending mode first, since it may depend on it. List
+// changes (mode, clear, sort, filter, scroll) publish once per batch.
+RadioMode pendingMode = RADIO_IDLE;
+bool modePending = false;
+
+void applyPendingMode() {
+    if(!modePending) return;
+    modePending = false;
+    enterRadioMode(pendingMode);
+}
+
+void handleRadioCommand(const RadioCmd& cmd) {
+    if(cmd.type != RC_MODE) applyPendingMode();
+    switch(cmd.type) {
+        case RC_MODE: pendingMode = (RadioMode)cmd.arg; modePending = true; break;
+        case RC_CLEAR:
+            if(radioMode == RADIO_WIFI_SCAN) startWiFiScan(true);
+            else if(radioMode == RADIO_SURVEY) surveyAPs.clear();
+            else if(radioMode == RADIO_BLE_LIST) { bleDevices.clear(); bleNames.clear(); }
+            listRequested = true;
+            break;
+        case RC_WIFI_LOOP: wifiScanLoop = cmd.arg; break;
+        case RC_CHANNEL:
+            monitorChannel = cmd.arg;
+            if(radioMode == RADIO_MONITOR) setHopping(false);
+            break;
+        case RC_PCAP:      if(radioMode == RADIO_MONITOR) setPcap(cmd.arg); break;
+        case RC_PCAP_SNAPLEN: pcapSnaplen = cmd.arg; break;   // from the next start
+        case RC_HOP:       if(radioMode == RADIO_MONITOR) setHopping(cmd.arg); break;
+        case RC_SWEEP:
+            if(radioMode != RADIO_EXTERNAL) { deauthSweeping = false; break; }
+            sweepChannel = 1;
+            esp_wifi_set_channel(sweepChannel, WIFI_SECOND_CHAN_NONE);
+            sweepStepAt = millis();
+            break;
+        case RC_DWELL:     hopper.setBaseDwell(cmd.arg); break;
+        case RC_ADAPT:     hopper.setAdaptive(cmd.arg); break;
+        case RC_LIST_SORT:   listSortBy = cmd.arg; listRequested = true; break;
+        case RC_LIST_FILTER: listFilterBy = cmd.arg; listRequested = true; break;
+        case RC_LIST_TOP:    listTop = cmd.arg; listRequested = true; break;
+        case RC_LIST_PAGE:   publishListPage(cmd.arg); break;
+        case RC_BLE_REF:     bleRef1m = cmd.arg; listRequested = true; break;
+        case RC_BLE_PATH:    blePathN10 = cmd.arg; listRequested = true; break;
+    }
+}
+
+void radioStep() {
+    updateBleTracker();
+    switch(radioMode) {
+        case RADIO_MONITOR:   updatePacketMonitor(); break;
+        case RADIO_WIFI_SCAN: updateWiFiScan(); break;
+        case RADIO_SURVEY:    updateSurvey(); break;
+        case RADIO_EXTERNAL:  updateSweep(); break;
+        case RADIO_BLE_LIST:  if(millis() - lastListPublish >= 1000) publishList(); break;
+        default: break;
+    }
+}
+
+void radioTask(void*) {
+    for(;;) {
+        RadioCmd cmd;
+        // Sleep until a command arrives, but wake every tick to drain the rings
+        if(xQueueReceive(radioCmdQueue, &cmd, pdMS_TO_TICKS(RADIO_TICK_MS)) == pdTRUE) {
+            do handleRadioCommand(cmd); while(xQueueReceive(radioCmdQueue, &cmd, 0) == pdTRUE);
+            applyPendingMode();
+            if(listRequested) { listRequested = false; publishList(); }
+        }
+        radioStep();
+    }
+}
+
+void startRadioTask() {
+    radioCmdQueue = xQueueCreate(8, sizeof(RadioCmd));
+    pktTickQueue = xQueueCreate(4, sizeof(PacketTick));
+    listMailbox = xQueueCreate(1, sizeof(ListSnapshot));
+    chanMailbox = xQueueCreate(1, sizeof(ChannelMap));
+    pageMailbox = xQueueCreate(1, sizeof(ListSnapshot));
+    xTaskCreatePinnedToCore(radioTask, "radio", RADIO_TASK_STACK, nullptr, RADIO_TASK_PRIO, &radioTaskHandle, 0);
+}
+
+// --- UI side ---
+
+void showListSnapshot() {
+    listCount = listIn.rows;
+    listFirst = listIn.first;
+    listWindowCount = listIn.count;
+    memcpy(listWindow, listIn.items, listWindowCount * sizeof(ListItem));
+    if(scrollOffset > 0 && scrollOffset + LIST_ROWS > listCount) {
+        scrollOffset = max(0, listCount - LIST_ROWS);
+        radioCommand(RC_LIST_TOP, scrollOffset);
+    }
+    drawListItems();
+    if(currentPage == PAGE_WIFI) drawWiFiStatus();
+    else if(currentPage == PAGE_BLE) drawBLEStatus();
+    else if(currentPage == PAGE_SURVEY) drawSurveyStatus();
+}
+
+// Everything the radio task sent since the last pass; never waits
+void receiveRadioUpdates() {
+    PacketTick tick;
+    while(xQueueReceive(pktTickQueue, &tick, 0) == pdTRUE) {
+        if(currentPage == PAGE_PACKET) showPacketTick(tick);
+        histPktRateSum += tick.rate; histPktTicks++; histPktDropped = tick.dropped;
+        telemTick = tick; telemTickFresh = true;
+        if(tick.breakdown) memcpy(telemCat, tick.cat, sizeof(telemCat));
+    }
+    if(currentPage == PAGE_CHANMAP && xQueueReceive(chanMailbox, &chanIn, 0) == pdTRUE) drawChannelMap();
+    if(xQueueReceive(listMailbox, &listIn, 0) != pdTRUE) return;
+    histListFresh = telemListFresh = true;
+    if(listIn.mode == listModeFor(currentPage) && listIn.mode != RADIO_IDLE) showListSnapshot();
+}
+
+/* ================== HISTORY LOG ================== */
+void sampleHistory() {
+    unsigned long now = millis();
+    history.append(LOG_HEAP_KB, ESP.getFreeHeap() / 1024, now);
+    if(histPktTicks) {
+        history.append(LOG_PKT_RATE, histPktRateSum / histPktTicks, now);
+        history.append(LOG_PKT_DROPPED, histPktDropped, now);
+        histPktRateSum = histPktTicks = 0;
+    }
+    if(histListFresh) {
+        switch(listIn.mode) {
+            case RADIO_WIFI_SCAN: history.append(LOG_WIFI_NETS, listIn.total, now); break;
+            case RADIO_BLE_LIST:  history.append(LOG_BLE_DEVS, listIn.total, now); break;
+            case RADIO_SURVEY:
+                history.append(LOG_SURVEY_APS, listIn.total, now);
+                history.append(LOG_SURVEY_DROPPED, listIn.dropped, now);
+                break;
+            default: break;
+        }
+        histListFresh = false;
+    }
+}
+
+// FROM/TO in seconds on the log clock; negative means that long before now
+void startHistoryDump(long fromS, long toS, int given) {
+    int64_t now = history.clock(millis());
+    int64_t from = given >= 1 ? (fromS < 0 ? now + fromS * 1000LL : fromS * 1000LL) : 0;
+    int64_t to = given >= 2 ? (toS < 0 ? now + toS * 1000LL : toS * 1000LL) : now;
+    if(from < 0) from = 0;
+    history.flush();
+    historyDump.begin(history, from, to < 0 ? 0 : to);
+    historyDumping = true;
+    historyDumped = 0;
+    char buf[64];
+    snprintf(buf, sizeof(buf), "# log %lld..%lld ms, clock %lld", (long long)from, (long long)to, (long long)now);
+    Serial.println(buf);
+    Serial.println("ms,series,value");
+    Serial.println("# entries: ms,table_event,addr,channel,rssi,first_ms,last_ms");
+}
+
+// Log-clock time agoS seconds before ms, not before the clock started
+static uint64_t logAgo(uint64_t ms, uint16_t agoS) { return ms > agoS * 1000ULL ? ms - agoS * 1000ULL : 0; }
+
+// A few lines per pass, so loop() keeps drawing during a long dump
+void serviceHistoryDump() {
+    if(!historyDumping) return;
+    if(!serialIsText()) { historyDumping = false; return; }   // pcap or telemetry took the port
+    char buf[96];
+    for(int i = 0; i < LOG_DUMP_LINES && Serial.availableForWrite() >= (int)sizeof(buf); i++) {
+        TsLogRecord r;
+        if(!historyDump.next(r)) {
+            snprintf(buf, sizeof(buf), "# end, %lu records", (unsigned long)historyDumped);
+            Serial.println(buf);
+            historyDumping = false;
+            return;
+        }
+        if(r.series == TSLOG_ENTRY) {
+            const TsLogEntry& e = r.entry;
+            uint8_t table = e.kind & 0x0F, event = e.kind >> 4;
+            snprintf(buf, sizeof(buf), "%llu,%s_%s,%02X:%02X:%02X:%02X:%02X:%02X,%u,%d,%llu,%llu", (unsigned long long)r.ms,
+                     table < LOG_TABLE_COUNT ? logTableNames[table] : "?", event < LOG_EVENT_COUNT ? logEventNames[event] : "?",
+                     e.addr[0], e.addr[1], e.addr[2], e.addr[3], e.addr[4], e.addr[5], e.channel, e.rssi,
+                     (unsigned long long)logAgo(r.ms, e.firstAgoS), (unsigned long long)logAgo(r.ms, e.lastAgoS));
+        } else {
+            const char* name = r.series < LOG_SERIES_COUNT ? logSeriesNames[r.series] : "?";
+            snprintf(buf, sizeof(buf), "%llu,%s,%ld", (unsigned long long)r.ms, name, (long)r.value);
+        }
+        Serial.println(buf);
+        historyDumped++;
+    }
+}
+
+void printHistoryStats() {
+    TsLogStats st = history.stats();
+    char buf[96];
+    snprintf(buf, sizeof(buf), "[LOG] %u/%u segments, %lu bytes, %llu..%llu ms, %lu records this boot, %lu flushes",
+             st.segments, TSLOG_SEGMENTS, (unsigned long)st.bytes, (unsigned long long)st.firstMs,
+             (unsigned long long)st.lastMs, (unsigned long)st.records, (unsigned long)st.flushes);
+    Serial.println(buf);
+    snprintf(buf, sizeof(buf), "[LOG] flash %lu/%lu bytes used", (unsigned long)LittleFS.usedBytes(), (unsigned long)LittleFS.totalBytes());
+    Serial.println(buf);
+}
+
+// --- Serial console ---
+// Text commands, one per line; ignored while pcap owns the port
+#define SERIAL_LINE_MAX 48
+char serialLine[SERIAL_LINE_MAX];
+uint8_t serialLineLen = 0;
+void startTelemetry(long periodMs);   // TELEMETRY, below
+void stopTelemetry();
+
+// "ble ref DBM" / "ble n X10" tune the BLE range estimate and keep it in NVS
+void bleModelCommand(const char* args) {
+    long v;
+    if(sscanf(args, " ref %ld", &v) == 1 && v >= -100 && v <= 0) { prefs.putUChar("bleRef", -v); radioCommand(RC_BLE_REF, v); }
+    else if(sscanf(args, " n %ld", &v) == 1 && v >= 10 && v <= 60) { prefs.putUChar("bleN", v); radioCommand(RC_BLE_PATH, v); }
+    else if(args[0]) { Serial.println("[BLE] ble ref DBM (-100..0, RSSI at 1 m) | ble n X10 (10..60, path-loss exponent x10)"); return; }
+    int n = prefs.getUChar("bleN", BLE_PATH_N10);
+    char buf[64];
+    snprintf(buf, sizeof(buf), "[BLE] %d dBm at 1 m, path-loss exponent %d.%d", -(int)prefs.getUChar("bleRef", -BLE_REF_1M_DBM), n / 10, n % 10);
+    Serial.println(buf);
+}
+
+// "pcap snaplen N": bytes of each frame the next PCAP stream keeps, kept in NVS
+void pcapCommand(const char* args) {
+    long v;
+    if(sscanf(args, " snaplen %ld", &v) == 1 && v >= PCAP_MIN_SNAPLEN && v <= PCAP_MAX_SNAPLEN) {
+        prefs.putUShort("pcapSnap", v);
+        radioCommand(RC_PCAP_SNAPLEN, v);
+    } else if(args[0]) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "[PCAP] pcap snaplen N (%d..%d)", PCAP_MIN_SNAPLEN, PCAP_MAX_SNAPLEN);
+        Serial.println(buf);
+        return;
+    }
+    char buf[48];
+    snprintf(buf, sizeof(buf), "[PCAP] snaplen %u, from the next start", prefs.getUShort("pcapSnap", PCAP_DEFAULT_SNAPLEN));
+    Serial.println(buf);
+}
+
+void runSerialCommand(const char* line) {
+    long a = 0, b = 0;
+    if(!strncmp(line, "log dump", 8)) { int n = sscanf(line + 8, "%ld %ld", &a, &b); startHistoryDump(a, b, n < 0 ? 0 : n); }
+    else if(!strcmp(line, "log stat")) printHistoryStats();
+    else if(!strcmp(line, "log clear")) { history.clear(millis()); Serial.println("[LOG] Cleared"); }
+    else if(!strcmp(line, "prof")) profDump(Serial);
+    else if(!strcmp(line, "prof reset")) { profReset(); Serial.println("[PROF] Reset"); }
+    else if(!strncmp(line, "ble", 3)) bleModelCommand(line + 3);
+    else if(!strncmp(line, "pcap", 4)) pcapCommand(line + 4);
+    else if(!strncmp(line, "telem", 5)) startTelemetry(sscanf(line + 5, "%ld", &a) == 1 ? a : TELEM_DEFAULT_MS);
+    else if(line[0]) Serial.println("[CMD] log dump [FROM_S [TO_S]] | log stat | log clear | prof | prof reset | ble [ref DBM | n X10] | pcap [snaplen N] | telem [PERIOD_MS]");
+}
+
+void pollSerialCommands() {
+    while(serialIsText() && Serial.available()) {
+        int c = Serial.read();
+        if(c == '\r') continue;
+        if(c != '\n') {
+            if(serialLineLen < SERIAL_LINE_MAX - 1) serialLine[serialLineLen++] = (char)c;
+            continue;
+        }
+        serialLine[serialLineLen] = 0;
+        serialLineLen = 0;
+        runSerialCommand(serialLine);
+    }
+}
+
+void serviceHistory() {
+    if(millis() - lastHistorySample >= LOG_SAMPLE_MS) {
+        sampleHistory();
+        lastHistorySample = millis();
+    }
+    TsLogEntry e;
+    while(logEntryRing.pop(e)) history.appendEntry(e, millis());
+    history.service(millis());
+    pollSerialCommands();
+    serviceHistoryDump();
+}
+
+/* ================== TOUCH ================== */
+// PENIRQ only wakes the sampler; the sampler runs on an esp_timer, reads the
+// controller while the pen is down and queues events (touch_input.h).
+// loop() never talks to the touch controller, it just drains the queue and
+// resolves each event against the current page's hit table.
+volatile bool touchIrqPending = false;
+esp_timer_handle_t touchTimer;
+
+void IRAM_ATTR touchIrq() { touchIrqPending = true; }
+
+void touchSampleTick(void*) {
+    if(!touchIrqPending && !touch.active()) return;   // idle: no SPI traffic
+    touchIrqPending = false;
+    TS_Point p = ts.getPoint();
+    touch.sample(p.x, p.y, p.z, millis());
+}
+
+void startTouch() {
+    pinMode(T_IRQ, INPUT);
+    attachInterrupt(digitalPinToInterrupt(T_IRQ), touchIrq, FALLING);
+    esp_timer_create_args_t args = {};
+    args.callback = touchSampleTick;
+    args.name = "touch";
+    esp_timer_create(&args, &touchTimer);
+    esp_timer_start_periodic(touchTimer, TOUCH_SAMPLE_MS * 1000);
+}
+
+// --- hit tables ---
+// TouchZone and hitTest() are in page_layout.h; the home tiles are hit-tested
+// through HOME_GRID, the same layout drawHome() draws from.
+
+// List pages start empty; the radio task publishes the list as soon as it has switched mode
+void openList(RadioMode mode) {
+    listCount = listWindowCount = 0;
+    scrollOffset = 0;
+    setRadioMode(mode);
+    radioCommand(RC_LIST_SORT, listSort[mode]);
+    radioCommand(RC_LIST_FILTER, listFilter[mode]);
+    radioCommand(RC_LIST_TOP, 0);
+}
+
+void openPage(int page) {
+    currentPage = (Page)page;
+    switch(currentPage) {
+        case PAGE_MUSIC:    drawMusicUI(); break;
+        case PAGE_WIFI:     openList(RADIO_WIFI_SCAN); drawWiFiPage(); break;
+        case PAGE_SETTINGS: drawSettings(); break;
+        case PAGE_SYSTEM:   drawSystemStatic(); break;
+        case PAGE_BLE:      openList(RADIO_BLE_LIST); drawBLEPage(); break;
+        case PAGE_PACKET:   setRadioMode(RADIO_MONITOR); resetPacketView(); drawPacketUI(); break;
+        case PAGE_NET_ANA:  startDeauther(); drawNetAnaUI(); break;
+        case PAGE_SURVEY:   openList(RADIO_SURVEY); drawSurveyPage(); break;
+        case PAGE_CHANMAP:
+            setRadioMode(RADIO_MONITOR);
+            radioCommand(RC_DWELL, hopDwellMs);
+            radioCommand(RC_ADAPT, hopAdaptive);
+            radioCommand(RC_HOP, 1);
+            xQueueReceive(chanMailbox, &chanIn, 0);   // drop a map left from an earlier session
+            drawChannelMapPage();
+            break;
+        default:            setRadioMode(RADIO_IDLE); drawHome(); break;
+    }
+}
+
+// Leaving NET_ANA any way other than its own button must not leave the
+// deauther transmitting
+void switchPage(int page) {
+    if(currentPage == PAGE_NET_ANA) stopDeauther();
+    openPage(page);
+}
+
+void goHome(int) { switchPage(PAGE_HOME); }
+
+void flipHomePage(int dir) {
+    int next = homePageIndex + dir;
+    if(next < 0 || next >= HOME_PAGES) return;
+    homePageIndex = next;
+    drawHome();
+}
+
+void playPause(int) { isPlaying = !isPlaying; drawMusicUI(); hidTap(HID_USAGE_PLAY_PAUSE); }
+void mediaKey(int usage) { hidTap(usage); }
+void setTheme(int color) {
+    if(THEME_MAIN != color) {
+        THEME_MAIN = color;
+        prefs.putUShort("theme", color);
+        history.append(LOG_THEME, color, millis());
+    }
+    drawSettings();
+}
+
+void scrollList(int rows) {
+    int maxOffset = max(0, listCount - LIST_ROWS);
+    int next = constrain(scrollOffset + rows, 0, maxOffset);
+    if(next == scrollOffset) return;
+    scrollOffset = next;
+    drawListItems();   // rows already in the window; the rest follow in the next snapshot
+    radioCommand(RC_LIST_TOP, scrollOffset);
+}
+
+// SCAN on NET_SCN, CLEAR on the BLE and survey pages
+void clearList(int) {
+    listCount = listWindowCount = 0;
+    scrollOffset = 0;
+    drawListItems();
+    radioCommand(RC_CLEAR);
+    radioCommand(RC_LIST_TOP, 0);
+}
+
+// The order changes under every row, so back to the top until it arrives
+void changeListView(uint8_t type, uint8_t value) {
+    listWindowCount = 0;
+    scrollOffset = 0;
+    radioCommand(type, value);
+    radioCommand(RC_LIST_TOP, 0);
+    drawListControls();
+}
+void cycleListSort(int) {
+    uint8_t& s = listSort[listModeFor(currentPage)];
+    s = (s + 1) % SORT_COUNT;
+    changeListView(RC_LIST_SORT, s);
+}
+void cycleListFilter(int) {
+    uint8_t& f = listFilter[listModeFor(currentPage)];
+    f = (f + 1) % FILTER_COUNT;
+    changeListView(RC_LIST_FILTER, f);
+}
+void wifiToggleLoop(int) { wifiContinuous = !wifiContinuous; radioCommand(RC_WIFI_LOOP, wifiContinuous); drawWiFiButtons(); drawWiFiStatus(); }
+void channelStep(int dir) { changeChannel(dir); }
+void pcapButton(int) {
+    pcapOn = !pcapOn;
+    if(pcapOn && telemOn) stopTelemetry();   // one binary stream at a time
+    radioCommand(RC_PCAP, pcapOn);
+    drawPcapButton();
+}
+void deauthButton(int) { if(isDeauthRunning) stopDeauther(); else startDeauther(); drawNetAnaUI(); }
+
+const TouchZone backZone[] = { { -1, 25, 50, 60, goHome, 0, false } };
+// The arrows take taps out to the screen edges
+const TouchZone homeZones[] = {
+    { -1, HOME_PREV.y - 10, HOME_PREV.x + HOME_PREV.w, 241, flipHomePage, -1, false },
+    { HOME_NEXT.x, HOME_NEXT.y - 10, 321, 241, flipHomePage, 1, false },
+};
+const TouchZone musicZones[] = {
+    { 110, 80, 210, 180, playPause, 0, false },
+    { 250, 100, 321, 160, mediaKey, HID_USAGE_NEXT, false },
+    { -1, 100, 70, 160, mediaKey, HID_USAGE_PREV, false },
+    { 60, 38, 116, 64, mediaKey, HID_USAGE_VOL_DOWN, true },
+    { 124, 38, 180, 64, mediaKey, HID_USAGE_MUTE, false },
+    { 188, 38, 244, 64, mediaKey, HID_USAGE_VOL_UP, true },
+    { 252, 38, 308, 64, mediaKey, HID_USAGE_STOP, false },
+};
+const TouchZone settingsZones[] = {
+    { 20, 90, 80, 150, setTheme, C_CYAN, false },
+    { 95, 90, 155, 150, setTheme, C_GREEN, false },
+    { 170, 90, 230, 150, setTheme, C_RED, false },
+    { 245, 90, 305, 150, setTheme, 0xFD20, false },
+};
+#define LIST_ZONES \
+    { 290, 70, 321, 130, scrollList, -1, true }, \
+    { 290, 140, 321, 200, scrollList, 1, true }, \
+    { 149, 25, 229, 46, cycleListSort, 0, false }, \
+    { 233, 25, 321, 46, cycleListFilter, 0, false }
+const TouchZone wifiZones[] = {
+    LIST_ZONES,
+    { -1, 200, 95, 241, clearList, 0, false },
+    { 94, 200, 185, 241, wifiToggleLoop, 0, false },
+};
+const TouchZone bleZones[] = { LIST_ZONES, { -1, 200, 100, 241, clearList, 0, false } };
+const TouchZone surveyZones[] = { LIST_ZONES, { -1, 200, 100, 241, clearList, 0, false } };
+const TouchZone packetZones[] = {
+    { 20, 50, 80, 90, channelStep, -1, true },
+    { 240, 50, 300, 90, channelStep, 1, true },
+    { 100, 50, 220, 90, toggleHop, 0, false },
+    { 232, 210, 321, 241, pcapButton, 0, false },
+};
+const TouchZone chanMapZones[] = {
+    { 10, 205, 120, 235, cycleDwell, 0, false },
+    { 130, 205, 210, 235, toggleAdaptive, 0, false },
+};
+const TouchZone netAnaZones[] = { { 30, 190, 150, 230, deauthButton, 0, false } };
+
+// In Page order
+const ZoneTable pageZones[] = {
+    ZONES(homeZones), ZONES(musicZones), ZONES(settingsZones), ZONES(wifiZones), { nullptr, 0 },
+    ZONES(bleZones), ZONES(packetZones), ZONES(netAnaZones), ZONES(surveyZones), ZONES(chanMapZones),
+};
+static_assert(sizeof(pageZones) / sizeof(pageZones[0]) == PAGE_COUNT, "pageZones must list every Page");
+
+// --- list drag / flick ---
+#define LIST_ROW_H      25
+#define LIST_FLING_DIV  400   // px/s of release speed per extra row
+
+bool isListPage() { return currentPage == PAGE_WIFI || currentPage == PAGE_BLE || currentPage == PAGE_SURVEY; }
+
+Page touchPage = PAGE_HOME;       // page the current touch started on
+const TouchZone* heldZone = nullptr;
+bool listDragging = false;
+int listDragOrigin = 0;          // scrollOffset when the drag started
+
+void handleTouch() {
+    TouchEvent ev;
+    while(touch.next(ev)) {
+        // A touch that opened another page doesn't act on the new one
+        if(ev.type != TOUCH_DOWN && currentPage != touchPage) continue;
+        switch(ev.type) {
+            case TOUCH_DOWN: {
+                touchPage = currentPage;
+                heldZone = nullptr;
+                listDragging = isListPage() && ev.x > 10 && ev.x < 288 && ev.y > 65 && ev.y < 200;
+                listDragOrigin = scrollOffset;
+                const TouchZone* z = nullptr;
+                if(currentPage == PAGE_HOME) {
+                    const AppTile* app = homeAppAt(ev.x, ev.y);
+                    if(app) { openPage(app->page); break; }
+                } else { ZoneTable back = ZONES(backZone); z = hitTest(back, ev.x, ev.y); }
+                if(!z) z = hitTest(pageZones[currentPage], ev.x, ev.y);
+                if(z) { heldZone = z->repeat ? z : nullptr; z->action(z->arg); }
+                break;
+            }
+            case TOUCH_REPEAT:
+                if(heldZone) heldZone->action(heldZone->arg);
+                break;
+            case TOUCH_DRAG:
+                heldZone = nullptr;
+                // Content follows the finger: dragging up shows later rows
+                if(listDragging) scrollList(listDragOrigin - ev.dy / LIST_ROW_H - scrollOffset);
+                break;
+            case TOUCH_SWIPE:
+                if(listDragging) scrollList(-ev.dy / LIST_FLING_DIV);
+                break;
+            case TOUCH_UP:
+                heldZone = nullptr;
+                listDragging = false;
+                break;
+        }
+    }
+}
+
+/* ================== TELEMETRY ================== */
+// Frames go out only when the UART has room for the whole frame; one that
+// doesn't fit is dropped but still takes a seq number, so the host sees the
+// gap. STATUS goes out every period, PACKETS and LIST when something new
+// arrived since the last one.
+//
+// TC_LIST pages through the whole list: the radio task formats LIST_WINDOW
+// rows at a time into pageMailbox, and each page goes out as a TM_LIST
+// tagged with the command's seq before the next one is asked for. A page
+// waits in the mailbox until the UART has room for it, so none are dropped.
+// Pages that don't start where the request is up to are stale and skipped.
+TelemDecoder telemIn;
+uint16_t telemPeriodMs = TELEM_DEFAULT_MS;
+uint16_t telemTxSeq = 0;
+uint32_t telemDropped = 0;
+unsigned long lastTelemSample = 0;
+uint32_t telemLastPass = 0;                   // micros() of the previous loop() pass
+uint32_t telemLoopSum = 0, telemLoopMax = 0;  // us between passes, since the last STATUS
+uint32_t telemLoops = 0;
+bool telemPaging = false;                     // a TC_LIST is being answered
+uint16_t telemPageNext = 0, telemPageEnd = 0; // rows still to send: next .. end - 1
+uint16_t telemPageSeq = 0;                    // the TC_LIST's seq
+ListSnapshot telemPage;
+
+bool sendTelem(uint8_t type, const TelemWriter& w) {
+    static uint8_t wire[TELEM_MAX_WIRE];
+    size_t n = w.overflow ? 0 : telemEncode(type, telemTxSeq++, millis(), w.buf, w.len, wire);
+    if(!n || Serial.availableForWrite() < (int)n) { telemDropped++; return false; }
+    Serial.write(wire, n);
+    return true;
+}
+
+void sendTelemHello() {
+    TelemWriter w;
+    w.u16(telemPeriodMs); w.u8(currentPage); w.str("esp32-device-thinga");
+    sendTelem(TM_HELLO, w);
+}
+
+void sendTelemStatus() {
+    TelemWriter w;
+    w.u32(ESP.getFreeHeap()); w.u32(ESP.getMinFreeHeap());
+    w.u32(telemLoops); w.u32(telemLoops ? telemLoopSum / telemLoops : 0); w.u32(telemLoopMax);
+    w.u8(currentPage); w.u32(telemDropped);
+    sendTelem(TM_STATUS, w);
+    telemLoops = 0; telemLoopSum = telemLoopMax = 0;
+}
+
+void sendTelemPackets() {
+    TelemWriter w;
+    w.u32(telemTick.rate); w.u32(telemTick.total); w.u32(telemTick.dropped); w.u8(telemTick.channel);
+    w.u8(FCAT_COUNT);
+    for(int i = 0; i < FCAT_COUNT; i++) w.u32(telemCat[i]);
+    sendTelem(TM_PACKETS, w);
+}
+
+// Unpaged: the rows the UI holds, the window around the screen. Paged: rows
+// of a TC_LIST answer, cut to the count asked for.
+bool sendTelemList(const ListSnapshot& l, uint8_t count, bool paged, uint16_t cmdSeq) {
+    TelemWriter w;
+    w.u8(l.mode); w.u8(l.channel); w.u8(l.live);
+    w.u16(l.rows); w.u16(l.total); w.u32(l.dropped); w.u16(l.first);
+    w.u8(count);
+    for(int i = 0; i < count; i++) {
+        const ListItem& it = l.items[i];
+        w.str(it.label); w.str(it.detail); w.u16((uint16_t)(int16_t)it.value);
+    }
+    w.u8(paged); w.u16(cmdSeq);
+    return sendTelem(TM_LIST, w);
+}
+
+void requestTelemPage() { radioCommand(RC_LIST_PAGE, min(telemPageNext, (uint16_t)LIST_MAX_ROWS)); }
+
+void serviceTelemPages() {
+    if(!telemPaging || Serial.availableForWrite() < TELEM_MAX_WIRE) return;
+    if(xQueueReceive(pageMailbox, &telemPage, 0) != pdTRUE) return;
+    if(telemPage.first != min(telemPageNext, telemPage.rows)) return;   // asked for by an earlier TC_LIST
+    uint8_t n = min<int>(telemPage.count, telemPageEnd - telemPage.first);
+    sendTelemList(telemPage, n, true, telemPageSeq);
+    telemPageNext = telemPage.first + n;
+    if(n && telemPageNext < telemPageEnd && telemPageNext < telemPage.rows) requestTelemPage();
+    else telemPaging = false;
+}
+
+void startTelemetry(long periodMs) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "[TELEM] Binary at %d baud until TC_STOP", TELEM_BAUD);
+    Serial.println(buf);
+    Serial.flush();
+    Serial.updateBaudRate(TELEM_BAUD);
+    telemPeriodMs = constrain(periodMs, TELEM_MIN_MS, 60000);
+    telemIn = TelemDecoder();
+    telemTxSeq = 0;
+    telemDropped = 0;
+    telemLastPass = 0;
+    telemLoops = 0; telemLoopSum = telemLoopMax = 0;
+    telemTickFresh = telemListFresh = false;
+    telemPaging = false;
+    memset(telemCat, 0, sizeof(telemCat));
+    lastTelemSample = millis();
+    telemOn = true;
+    Serial.write((uint8_t)0);   // ends the text as far as the host's decoder is concerned
+    sendTelemHello();
+}
+
+void stopTelemetry() {
+    Serial.flush();
+    Serial.updateBaudRate(115200);
+    telemOn = false;
+    serialLineLen = 0;
+    Serial.println("[TELEM] Stopped");
+}
+
+void runTelemCommand(const TelemFrame& f) {
+    TelemReader r(f.payload, f.len);
+    uint8_t result = TR_OK;
+    switch(f.type) {
+        case TC_PING: sendTelemHello(); return;
+        case TC_RATE: {
+            uint16_t ms = r.u16();
+            if(!r.ok || ms < TELEM_MIN_MS) result = TR_BAD_ARG;
+            else telemPeriodMs = ms;
+            break;
+        }
+        case TC_CHANNEL: {
+            uint8_t ch = r.u8();
+            if(!r.ok || ch < 1 || ch > 13) result = TR_BAD_ARG;
+            else setChannel(ch);
+            break;
+        }
+        case TC_SCAN:
+            if(isListPage()) clearList(0);
+            else switchPage(PAGE_WIFI);
+            break;
+        case TC_PAGE: {
+            uint8_t page = r.u8();
+            if(!r.ok || page >= PAGE_COUNT) result = TR_BAD_ARG;
+            else if(page == PAGE_NET_ANA) result = TR_REFUSED;   // transmits; only from the screen
+            else if(page != currentPage) switchPage(page);
+            break;
+        }
+        case TC_LIST: {
+            uint16_t first = r.u16(), count = r.u16();
+            if(!r.ok || !count) { result = TR_BAD_ARG; break; }
+            telemPageNext = first;
+            telemPageEnd = min<uint32_t>((uint32_t)first + count, 0xFFFF);
+            telemPageSeq = f.seq;
+            telemPaging = true;
+            requestTelemPage();
+            break;
+        }
+        case TC_STOP: break;
+        default: result = TR_UNKNOWN; break;
+    }
+    TelemWriter w;
+    w.u8(f.type); w.u16(f.seq); w.u8(result);
+    sendTelem(TM_ACK, w);
+    if(f.type == TC_STOP) stopTelemetry();
+}
+
+void serviceTelemetry() {
+    if(!telemOn) return;
+    uint32_t now = micros();
+    if(telemLastPass) {
+        uint32_t d = now - telemLastPass;
+        telemLoopSum += d;
+        if(d > telemLoopMax) telemLoopMax = d;
+        telemLoops++;
+    }
+    telemLastPass = now;
+
+    TelemFrame f;
+    while(telemOn && Serial.available()) if(telemIn.push(Serial.read(), f)) runTelemCommand(f);
+    if(!telemOn) return;
+    serviceTelemPages();
+    if(millis() - lastTelemSample < telemPeriodMs) return;
+    lastTelemSample = millis();
+    sendTelemStatus();
+    if(telemTickFresh) { sendTelemPackets(); telemTickFresh = false; }
+    if(telemListFresh) { sendTelemList(listIn, listIn.count, false, 0); telemListFresh = false; }
+}
+
 /* ================== SETUP ================== */
 void bootSequence() {
     tft.fillScreen(C_BLACK); tft.setTextSize(2); tft.setTextColor(C_WHITE);
@@ -692,15 +2544,26 @@ void bootSequence() {
     for(int i=0; i<236; i+=10) { 
         tft.fillRect(42, 202, i, 11, C_WHITE); 
         int noiseX = random(0, 320); int noiseY = random(0, 240); tft.drawPixel(noiseX, noiseY, C_WHITE);
+        flushDisplay();
         delay(30); 
     }
 }
 
 void setup() {
+  Serial.setTxBufferSize(PCAP_BATCH_BYTES);  // lets pcap batches go out without blocking
   Serial.begin(115200);
+  prefs.begin("thinga", false);
+  THEME_MAIN = prefs.getUShort("theme", C_CYAN);
+  bleRef1m = -(int)prefs.getUChar("bleRef", -BLE_REF_1M_DBM);   // before the radio task reads them
+  blePathN10 = prefs.getUChar("bleN", BLE_PATH_N10);
+  pcapSnaplen = constrain(prefs.getUShort("pcapSnap", PCAP_DEFAULT_SNAPLEN), PCAP_MIN_SNAPLEN, PCAP_MAX_SNAPLEN);
+  if(LittleFS.begin(true)) history.begin(LittleFS, millis());
+  else Serial.println("[LOG] No filesystem, history is off");
   tft.begin(); tft.setRotation(3); 
+  glyphs.begin();
   bootSequence(); 
   touchSPI.begin(14, 12, 13, T_CS); ts.begin(touchSPI); ts.setRotation(3); 
+  startTouch();
   
   BLEDevice::init("ESP32_CYBERDECK");
   BLEServer* pServer = BLEDevice::createServer();
@@ -712,6 +2575,7 @@ void setup() {
   hid->hidInfo(0x00, 0x01);
   hid->reportMap((uint8_t*)reportMap, sizeof(reportMap));
   hid->startServices();
+  startHid();
   
   // Configure BLE advertising with HID service
   BLEAdvertising *pAdvertising = pServer->getAdvertising();
@@ -721,116 +2585,30 @@ void setup() {
   
   pBLEScan = BLEDevice::getScan();
   pBLEScan->setActiveScan(true);
+  startBleTracker();
+  startRadioTask();
   drawHome();
 }
 
 /* ================== LOOP ================== */
-unsigned long lastDebounce = 0;
 unsigned long lastGraphUpdate = 0;
 
 void loop() {
+  PROF_SCOPE("loop");
+  flushDisplay();
+
   if(currentPage == PAGE_SYSTEM && millis() - lastGraphUpdate > 500) {
       updateSystemGraph();
       lastGraphUpdate = millis();
   }
   
-  if(currentPage == PAGE_PACKET) {
-      updatePacketGraph();
-  }
+  receiveRadioUpdates();
+  serviceHistory();
+  serviceTelemetry();
   
   if(currentPage == PAGE_NET_ANA) {
       updateDeauther();
   }
 
-  if (ts.touched()) {
-    TS_Point p = ts.getPoint();
-    if (p.z > 200 && (millis() - lastDebounce > DEBOUNCE_DELAY)) {
-        int x = map(p.x, 3700, 200, 0, 320); 
-        int y = map(p.y, 3700, 200, 0, 240);
-        
-        // BACK BUTTON
-        if(currentPage != PAGE_HOME && x < 50 && y > 25 && y < 60) {
-            if(currentPage == PAGE_PACKET) stopPacketMonitor();
-            if(currentPage == PAGE_NET_ANA) stopDeauther();
-            currentPage = PAGE_HOME; drawHome(); lastDebounce = millis(); return;
-        }
-
-        // HOME PAGE CLICKS
-        if(currentPage == PAGE_HOME) {
-            if (homePageIndex == 0) {
-                // PAGE 1
-                if(x > 10 && x < 100 && y > 50 && y < 120) { currentPage = PAGE_MUSIC; drawMusicUI(); }
-                else if(x > 115 && x < 205 && y > 50 && y < 120) { currentPage = PAGE_WIFI; drawWiFiPage(); }
-                else if(x > 220 && x < 310 && y > 50 && y < 120) { currentPage = PAGE_SETTINGS; drawSettings(); }
-                else if(x > 10 && x < 100 && y > 140 && y < 210) { currentPage = PAGE_SYSTEM; drawSystemStatic(); }
-                else if(x > 115 && x < 205 && y > 140 && y < 210) { currentPage = PAGE_BLE; drawBLEPage(); }
-                else if(x > 220 && x < 310 && y > 140 && y < 210) { currentPage = PAGE_PACKET; startPacketMonitor(); drawPacketUI(); }
-            }
-            else if (homePageIndex == 1) {
-                // PAGE 2 (App 7 goes here, currently using same bounds as app 1)
-                if(x > 10 && x < 100 && y > 50 && y < 120) {
-                    currentPage = PAGE_NET_ANA; startDeauther(); drawNetAnaUI();
-                }
-            }
-
-            // PAGINATION TOUCH ZONES
-            if(y > 200) {
-                if(x < 60 && homePageIndex > 0) { homePageIndex--; drawHome(); }
-                else if(x > 260 && homePageIndex < 1) { homePageIndex++; drawHome(); }
-            }
-        }
-
-        // MUSIC PAGE
-        else if(currentPage == PAGE_MUSIC) {
-            if(abs(x-160) < 50 && abs(y-130) < 50) { isPlaying = !isPlaying; drawMusicUI(); sendMediaKey(8); }
-            else if(x > 250 && y > 100 && y < 160) sendMediaKey(1);
-            else if(x < 70 && y > 100 && y < 160) sendMediaKey(2);
-        }
-
-        // SETTINGS PAGE
-        else if(currentPage == PAGE_SETTINGS) {
-            if(y > 90 && y < 150) {
-                if(x > 20 && x < 80) THEME_MAIN = C_CYAN;       
-                else if(x > 95 && x < 155) THEME_MAIN = C_GREEN; 
-                else if(x > 170 && x < 230) THEME_MAIN = C_RED; 
-                else if(x > 245 && x < 305) THEME_MAIN = 0xFD20;
-                drawSettings(); 
-            }
-        }
-        
-        // WIFI & BLE (Scrolling)
-        else if(currentPage == PAGE_WIFI || currentPage == PAGE_BLE) {
-            if(x > 290 && y > 70 && y < 130) {
-                if(scrollOffset > 0) { scrollOffset--; drawListItems(); }
-            }
-            else if(x > 290 && y > 140 && y < 200) {
-                if(scrollOffset + 5 < listCount) { scrollOffset++; drawListItems(); }
-            }
-            else if(x < 100 && y > 200) {
-                if(currentPage == PAGE_WIFI) drawWiFiPage(); else drawBLEPage();
-            }
-        }
-        
-        // PACKET MONITOR (Channel Controls)
-        else if(currentPage == PAGE_PACKET) {
-            if(x > 20 && x < 80 && y > 50 && y < 90) changeChannel(-1);
-            else if(x > 240 && x < 300 && y > 50 && y < 90) changeChannel(1);
-        }
-        
-        // NET ANA (Deauther Control)
-        else if(currentPage == PAGE_NET_ANA) {
-            // START/STOP button: x: 30-150, y: 190-230
-            if(x > 30 && x < 150 && y > 190 && y < 230) {
-                if(isDeauthRunning) {
-                    stopDeauther();
-                } else {
-                    startDeauther();
-                }
-                drawNetAnaUI();
-            }
-        }
-
-        lastDebounce = millis();
-    }
-  }
+  handleTouch();
 }
\ No newline at end of file
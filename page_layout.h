@@ -0,0 +1,56 @@
+#pragma once
+#include <stdint.h>
+
+/* ================== PAGE LAYOUT ================== */
+// Flash-resident descriptions of what is on a page, so the draw code and the
+// touch handler read their geometry from one place instead of each keeping
+// a copy of the numbers.
+//
+// A TouchZone is a hit rectangle and the action it fires. A TileGrid lays
+// out equal cells (the home screen's app tiles) by slot number: rects are
+// computed from the slot, so a table of apps needs no coordinates at all,
+// and one more app is one more table row, however many pages that makes.
+//
+// Everything here is constexpr and meant for const tables; nothing is built
+// at run time and nothing lives in RAM.
+
+struct Rect {
+    int16_t x, y, w, h;
+    // Edges are exclusive, like the comparisons the hit tables replaced
+    constexpr bool contains(int16_t px, int16_t py) const { return px > x && px < x + w && py > y && py < y + h; }
+};
+
+// --- hit tables ---
+// The first zone that contains the touch wins. Zones marked repeat fire
+// again while held.
+struct TouchZone { int16_t x0, y0, x1, y1; void (*action)(int); int arg; bool repeat; };
+struct ZoneTable { const TouchZone* zones; uint8_t count; };
+#define ZONES(t) { t, sizeof(t) / sizeof(t[0]) }
+
+inline const TouchZone* hitTest(const ZoneTable& t, int16_t x, int16_t y) {
+    for(uint8_t i = 0; i < t.count; i++) {
+        const TouchZone& z = t.zones[i];
+        if(x > z.x0 && x < z.x1 && y > z.y0 && y < z.y1) return &z;
+    }
+    return nullptr;
+}
+
+// --- tile grids ---
+// cols x rows cells of w x h, stepX/stepY apart, filled row by row. Slots
+// past cols * rows continue on the next page.
+struct TileGrid {
+    int16_t x, y, w, h, stepX, stepY;
+    uint8_t cols, rows;
+
+    constexpr uint8_t perPage() const { return cols * rows; }
+    constexpr uint8_t pages(uint16_t tiles) const { return tiles ? (tiles + perPage() - 1) / perPage() : 1; }
+    constexpr Rect cell(uint8_t slot) const {
+        return { (int16_t)(x + slot % cols * stepX), (int16_t)(y + slot / cols % rows * stepY), w, h };
+    }
+
+    // Slot on the page under (px, py), or -1
+    int8_t slotAt(int16_t px, int16_t py) const {
+        for(uint8_t s = 0; s < perPage(); s++) if(cell(s).contains(px, py)) return s;
+        return -1;
+    }
+};
@@ -0,0 +1,137 @@
+#include "pcap_stream.h"
+
+#define PCAP_RECORD_HEADER 16
+#define RADIOTAP_LEN       16
+
+static inline void putLE16(uint8_t* p, uint16_t v) { p[0] = v & 0xFF; p[1] = v >> 8; }
+static inline void putLE32(uint8_t* p, uint32_t v) { p[0] = v & 0xFF; p[1] = (v >> 8) & 0xFF; p[2] = (v >> 16) & 0xFF; p[3] = v >> 24; }
+
+void PcapStream::begin(Print& out, uint16_t snaplen) {
+    snap = (snaplen == 0 || snaplen > PCAP_MAX_SNAPLEN) ? PCAP_MAX_SNAPLEN : snaplen;
+    used[0] = used[1] = 0;
+    ready[0].store(0); ready[1].store(0);
+    fill = 0; sendNext = 0; sendOffset = 0;
+    frames.store(0); dropped.store(0);
+    bytesSent = 0;
+    flushRequest.store(false);
+    lastHandOff = millis();
+
+    uint8_t hdr[24];
+    putLE32(hdr, 0xA1B2C3D4);        // magic, microsecond timestamps
+    putLE16(hdr + 4, 2);             // version 2.4
+    putLE16(hdr + 6, 4);
+    putLE32(hdr + 8, 0);             // thiszone
+    putLE32(hdr + 12, 0);            // sigfigs
+    putLE32(hdr + 16, snap + RADIOTAP_LEN);
+    putLE32(hdr + 20, PCAP_LINKTYPE_RADIOTAP);
+    out.write(hdr, sizeof(hdr));
+    bytesSent += sizeof(hdr);
+    enabled.store(true, std::memory_order_release);
+}
+
+// Producer: give the current batch to the consumer and switch to the other
+// buffer, if the consumer has finished sending it.
+bool PcapStream::handOff() {
+    uint8_t other = fill ^ 1;
+    if(ready[other].load(std::memory_order_acquire)) return false;
+    ready[fill].store(1, std::memory_order_release);
+    fill = other;
+    used[fill] = 0;
+    return true;
+}
+
+void PcapStream::capture(const wifi_promiscuous_pkt_t* pkt) {
+    if(!enabled.load(std::memory_order_acquire)) return;
+    const wifi_pkt_rx_ctrl_t& rx = pkt->rx_ctrl;
+    uint16_t origLen = rx.sig_len;
+    uint16_t capLen = origLen < snap ? origLen : snap;
+    uint16_t need = PCAP_RECORD_HEADER + RADIOTAP_LEN + capLen;
+
+    if(flushRequest.load(std::memory_order_acquire) && used[fill]) {
+        if(handOff()) flushRequest.store(false, std::memory_order_release);
+    }
+    if(used[fill] + need > PCAP_BATCH_BYTES && !handOff()) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    uint8_t* p = bufs[fill] + used[fill];
+    uint32_t ts = rx.timestamp;
+    putLE32(p, ts / 1000000);
+    putLE32(p + 4, ts % 1000000);
+    putLE32(p + 8, RADIOTAP_LEN + capLen);
+    putLE32(p + 12, RADIOTAP_LEN + origLen);
+    p += PCAP_RECORD_HEADER;
+
+    // Radiotap: flags, channel, antenna signal, antenna noise
+    uint16_t freq = (rx.channel == 14) ? 2484 : 2407 + 5 * rx.channel;
+    p[0] = 0; p[1] = 0;
+    putLE16(p + 2, RADIOTAP_LEN);
+    putLE32(p + 4, (1 << 1) | (1 << 3) | (1 << 5) | (1 << 6));
+    p[8] = (capLen == origLen) ? 0x10 : 0x00;   // FCS at end, only if it made it in
+    p[9] = 0;                                   // pad: channel is 16-bit aligned
+    putLE16(p + 10, freq);
+    putLE16(p + 12, 0x0080);                    // 2 GHz spectrum
+    p[14] = (uint8_t)(int8_t)rx.rssi;
+    p[15] = (uint8_t)(int8_t)rx.noise_floor;
+    memcpy(p + RADIOTAP_LEN, pkt->payload, capLen);
+
+    used[fill] += need;
+    frames.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Consumer: write as much of batch idx as the UART will take without
+// blocking. Returns the bytes still pending in that batch.
+size_t PcapStream::sendSome(Print& out, uint8_t idx) {
+    size_t remaining = used[idx] - sendOffset;
+    int room = out.availableForWrite();
+    if(room <= 0) return remaining;
+    size_t n = remaining < (size_t)room ? remaining : (size_t)room;
+    out.write(bufs[idx] + sendOffset, n);
+    sendOffset += n;
+    bytesSent += n;
+    return remaining - n;
+}
+
+void PcapStream::service(Print& out) {
+    if(!active()) return;
+    while(ready[sendNext].load(std::memory_order_acquire)) {
+        if(sendSome(out, sendNext)) return;  // UART full, resume next pass
+        sendOffset = 0;
+        ready[sendNext].store(0, std::memory_order_release);
+        sendNext ^= 1;
+        lastHandOff = millis();
+    }
+    if(millis() - lastHandOff > PCAP_FLUSH_MS) {
+        flushRequest.store(true, std::memory_order_release);
+        lastHandOff = millis();
+    }
+}
+
+void PcapStream::end(Print& out) {
+    enabled.store(false, std::memory_order_release);
+    // The producer is stopped, so both buffers can be drained in order.
+    for(int i = 0; i < 2; i++) {
+        if(ready[sendNext].load(std::memory_order_acquire)) {
+            while(sendSome(out, sendNext)) delay(1);
+            sendOffset = 0;
+            ready[sendNext].store(0);
+            sendNext ^= 1;
+        }
+    }
+    if(used[fill]) {
+        sendOffset = 0;
+        while(sendSome(out, fill)) delay(1);
+        used[fill] = 0;
+    }
+    sendOffset = 0;
+    out.flush();
+}
+
+PcapStats PcapStream::stats() const {
+    PcapStats s;
+    s.frames = frames.load(std::memory_order_relaxed);
+    s.dropped = dropped.load(std::memory_order_relaxed);
+    s.bytesSent = bytesSent;
+    return s;
+}
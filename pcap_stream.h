@@ -0,0 +1,59 @@
+#pragma once
+#include <Arduino.h>
+#include <esp_wifi.h>
+#include <atomic>
+
+/* ================== PCAP OVER SERIAL ================== */
+// Streams captured frames as a standard pcap file (LINKTYPE_IEEE802_11_RADIOTAP,
+// with channel, RSSI and noise in the radiotap header) over Serial.
+//
+// The promiscuous callback writes each record, already in wire format, into
+// one of two batch buffers; loop() sends a finished batch straight out of
+// that buffer while the callback fills the other one. A frame that finds both
+// buffers busy is dropped and counted, never blocking the WiFi task.
+// host/pcap_recv.cpp turns the stream back into a .pcap file.
+
+#define PCAP_BATCH_BYTES    4096
+#define PCAP_FLUSH_MS       100     // hand over a partial batch after this long
+#define PCAP_DEFAULT_SNAPLEN 128
+#define PCAP_MAX_SNAPLEN    2324
+#define PCAP_MIN_SNAPLEN    24      // an 802.11 MAC header
+#define PCAP_LINKTYPE_RADIOTAP 127
+
+struct PcapStats {
+    uint32_t frames;
+    uint32_t dropped;
+    uint32_t bytesSent;
+};
+
+class PcapStream {
+public:
+    // Consumer side. begin() writes the pcap global header; end() must only be
+    // called once the callback can no longer run (promiscuous mode off).
+    void begin(Print& out, uint16_t snaplen);
+    void service(Print& out);
+    void end(Print& out);
+    bool active() const { return enabled.load(std::memory_order_acquire); }
+    uint16_t snaplen() const { return snap; }
+    PcapStats stats() const;
+
+    // Producer side (WiFi task)
+    void capture(const wifi_promiscuous_pkt_t* pkt);
+
+private:
+    bool handOff();
+    size_t sendSome(Print& out, uint8_t idx);
+
+    uint8_t bufs[2][PCAP_BATCH_BYTES];
+    uint16_t used[2] = {0, 0};
+    std::atomic<uint8_t> ready[2] = {{0}, {0}};   // 1 = owned by the consumer
+    uint8_t fill = 0;                             // producer-owned
+    uint8_t sendNext = 0;                         // consumer-owned
+    uint16_t sendOffset = 0;
+    std::atomic<bool> flushRequest{false};
+    std::atomic<bool> enabled{false};
+    uint16_t snap = PCAP_DEFAULT_SNAPLEN;
+    unsigned long lastHandOff = 0;
+    std::atomic<uint32_t> frames{0}, dropped{0};
+    uint32_t bytesSent = 0;
+};
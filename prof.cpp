@@ -0,0 +1,93 @@
+#include "prof.h"
+#include <atomic>
+#include <string.h>
+
+static ProfSite* sites[PROF_MAX_SITES];
+static std::atomic<uint8_t> siteCount{0};
+static unsigned long resetAt = 0;
+
+static inline uint8_t bucketOf(uint32_t cycles) {
+    if(cycles < (1u << PROF_MIN_SHIFT)) return 0;
+    uint8_t octave = 31 - __builtin_clz(cycles);
+    uint8_t sub = (cycles >> (octave - PROF_SUB_BITS)) & ((1 << PROF_SUB_BITS) - 1);
+    return 1 + ((octave - PROF_MIN_SHIFT) << PROF_SUB_BITS) + sub;
+}
+
+// Largest cycle count that lands in bucket b
+static uint32_t bucketTop(uint8_t b) {
+    if(b == 0) return (1u << PROF_MIN_SHIFT) - 1;
+    uint8_t octave = PROF_MIN_SHIFT + ((b - 1) >> PROF_SUB_BITS);
+    uint32_t sub = (b - 1) & ((1 << PROF_SUB_BITS) - 1);
+    uint32_t width = 1u << (octave - PROF_SUB_BITS);
+    return (((1u << PROF_SUB_BITS) + sub) * width) + (width - 1);
+}
+
+ProfSite::ProfSite(const char* n) : name(n) {
+    reset();
+    uint8_t i = siteCount.fetch_add(1);
+    if(i < PROF_MAX_SITES) sites[i] = this;
+    else siteCount.store(PROF_MAX_SITES);   // still records, just isn't listed
+}
+
+void ProfSite::record(uint32_t cycles) {
+    count++;
+    totalCycles += cycles;
+    if(cycles > maxCycles) maxCycles = cycles;
+    uint16_t& slot = hist[bucketOf(cycles)];
+    if(slot == 0xFFFF) for(int b = 0; b < PROF_BUCKETS; b++) hist[b] >>= 1;
+    slot++;
+}
+
+uint32_t ProfSite::percentile(uint16_t permille) const {
+    uint32_t total = 0;
+    for(int b = 0; b < PROF_BUCKETS; b++) total += hist[b];
+    if(!total) return 0;
+    uint32_t rank = (total * permille + 999) / 1000, seen = 0;
+    for(int b = 0; b < PROF_BUCKETS; b++) {
+        seen += hist[b];
+        if(seen >= rank) { uint32_t top = bucketTop(b); return top < maxCycles ? top : maxCycles; }
+    }
+    return maxCycles;
+}
+
+void ProfSite::reset() {
+    count = 0;
+    maxCycles = 0;
+    totalCycles = 0;
+    memset(hist, 0, sizeof(hist));
+}
+
+uint8_t profSiteCount() { return siteCount.load(); }
+ProfSite& profSite(uint8_t i) { return *sites[i]; }
+
+void profReset() {
+    for(uint8_t i = 0; i < profSiteCount(); i++) sites[i]->reset();
+    resetAt = millis();
+}
+
+uint32_t profSinceResetMs() { return millis() - resetAt; }
+
+void profFormat(char* out, size_t len, uint32_t cycles) {
+    uint32_t us = cycles / PROF_CPU_MHZ;
+    if(us < 1000) snprintf(out, len, "%luu", (unsigned long)us);
+    else if(us < 10000) snprintf(out, len, "%lu.%lum", (unsigned long)(us / 1000), (unsigned long)(us / 100 % 10));
+    else if(us < 1000000) snprintf(out, len, "%lum", (unsigned long)(us / 1000));
+    else snprintf(out, len, "%lu.%lus", (unsigned long)(us / 1000000), (unsigned long)(us / 100000 % 10));
+}
+
+void profDump(Print& out) {
+    char line[96];
+    uint64_t window = (uint64_t)profSinceResetMs() * 1000 * PROF_CPU_MHZ;
+    snprintf(line, sizeof(line), "# prof over %lu ms", (unsigned long)profSinceResetMs());
+    out.println(line);
+    out.println("site,calls,p50_us,p99_us,max_us,total_ms,load_pct");
+    for(uint8_t i = 0; i < profSiteCount(); i++) {
+        const ProfSite& s = *sites[i];
+        uint32_t load = window ? (uint32_t)(s.totalCycles * 1000 / window) : 0;   // permille
+        snprintf(line, sizeof(line), "%s,%lu,%lu,%lu,%lu,%lu,%lu.%lu", s.name, (unsigned long)s.count,
+                 (unsigned long)(s.percentile(500) / PROF_CPU_MHZ), (unsigned long)(s.percentile(990) / PROF_CPU_MHZ),
+                 (unsigned long)(s.maxCycles / PROF_CPU_MHZ), (unsigned long)(s.totalCycles / (1000 * PROF_CPU_MHZ)),
+                 (unsigned long)(load / 10), (unsigned long)(load % 10));
+        out.println(line);
+    }
+}
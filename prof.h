@@ -0,0 +1,70 @@
+#pragma once
+#include <Arduino.h>
+#include <stdint.h>
+
+/* ================== HOT-PATH PROFILER ================== */
+// PROF_SCOPE("name") at the top of a block times it with the CPU cycle
+// counter, from there to the end of the block, into a per-site histogram.
+// Buckets are log-scale, four per power of two (under 19% error), and
+// anything below 128 cycles lands in the first one. p50/p99 come back as
+// the upper edge of the bucket they fall in; max is exact. Times are
+// inclusive: loop() contains everything it calls.
+//
+// Each site has a single writer (the task that runs the scope). Readers on
+// other tasks and profReset() can race with it and see a slightly
+// inconsistent snapshot, which is fine for these numbers.
+//
+// Build with -DUSE_PROFILER=0 and PROF_SCOPE expands to nothing.
+
+#ifndef USE_PROFILER
+#define USE_PROFILER 1
+#endif
+
+#define PROF_MAX_SITES  48
+#define PROF_SUB_BITS   2      // buckets per power of two = 1 << PROF_SUB_BITS
+#define PROF_MIN_SHIFT  7      // bucket 0 holds everything under 1 << PROF_MIN_SHIFT cycles
+#define PROF_BUCKETS    (1 + ((32 - PROF_MIN_SHIFT) << PROF_SUB_BITS))
+#define PROF_CPU_MHZ    240
+
+struct ProfSite {
+    explicit ProfSite(const char* name);   // registers the site
+
+    void record(uint32_t cycles);
+    uint32_t percentile(uint16_t permille) const;   // in cycles
+    void reset();
+
+    const char* name;
+    uint32_t count;          // since reset
+    uint32_t maxCycles;
+    uint64_t totalCycles;
+    uint16_t hist[PROF_BUCKETS];   // halved together when one saturates
+};
+
+class ProfScope {
+public:
+    explicit ProfScope(ProfSite& s) : site(s), start(ESP.getCycleCount()) {}
+    ~ProfScope() { site.record(ESP.getCycleCount() - start); }
+
+private:
+    ProfSite& site;
+    uint32_t start;
+};
+
+uint8_t profSiteCount();
+ProfSite& profSite(uint8_t i);
+void profReset();
+uint32_t profSinceResetMs();
+// "12u", "3.4m", "120m", "1.5s": cycles as time in at most 4 characters
+void profFormat(char* out, size_t len, uint32_t cycles);
+// One CSV line per site: name, calls, p50/p99/max in us, total ms, load in % of one core
+void profDump(Print& out);
+
+#define PROF_CAT2(a, b) a##b
+#define PROF_CAT(a, b)  PROF_CAT2(a, b)
+#if USE_PROFILER
+#define PROF_SCOPE(name) \
+    static ProfSite PROF_CAT(profSite_, __LINE__)(name); \
+    ProfScope PROF_CAT(profScope_, __LINE__)(PROF_CAT(profSite_, __LINE__))
+#else
+#define PROF_SCOPE(name) do {} while(0)
+#endif
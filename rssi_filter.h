@@ -0,0 +1,98 @@
+#pragma once
+#include <stdint.h>
+
+/* ================== RSSI FILTER ================== */
+// Per-device smoothing of advertisement RSSI in integer maths, cheap enough
+// to run on every advertisement from a full device table: one divide and a
+// handful of multiplies per update, 12 bytes per device.
+//
+// The estimate is a 1-D Kalman filter on a random walk. Its variance grows
+// by RSSI_Q for every second since the last reading, and each reading pulls
+// it in as far as that variance allows against the reading noise RSSI_R. A
+// device advertising ten times a second is smoothed hard; one heard every
+// few seconds follows its readings more closely, since it may have moved.
+// Readings more than RSSI_GATE_DB off the estimate count as RSSI_GATE_DB
+// off, so one multipath fade can't drag it down.
+//
+// A slow average (time constant RSSI_TREND_MS, whatever the advertising
+// rate) trails the estimate. It carries RSSI_TREND_SHIFT extra fraction
+// bits: each step moves it by w / RSSI_TREND_MS of the gap, which in plain
+// Q4 rounds to nothing for gaps of a few dB at ten adverts a second, and
+// the trend would never settle. Running ahead of it by RSSI_TREND_ON_DB
+// means the signal is rising (approaching); the trend holds until the gap
+// is back under RSSI_TREND_OFF_DB, so it doesn't flicker.
+//
+// rssiDistanceCm() is the log-distance path loss model,
+// d = 10^((ref1m - rssi) / (10 n)): ref1m is the RSSI at one metre and n
+// the path-loss exponent (2 in free space, 2.5-4 indoors). It runs per
+// displayed row, not per advertisement.
+
+#define RSSI_R             (25 << 8)   // reading variance, dB^2 in Q8 (5 dB sd)
+#define RSSI_Q             (4 << 8)    // variance added per 1024 ms, Q8 (2 dB per sqrt(s))
+#define RSSI_P_MAX         (16 * RSSI_R)   // past this a reading is taken almost as is
+#define RSSI_GATE_DB       12
+#define RSSI_TREND_SHIFT   13
+#define RSSI_TREND_MS      (1 << RSSI_TREND_SHIFT)
+#define RSSI_TREND_ON_DB   3
+#define RSSI_TREND_OFF_DB  1
+
+enum RssiTrend : int8_t { TREND_RECEDING = -1, TREND_STEADY = 0, TREND_APPROACHING = 1 };
+
+struct RssiFilter {
+    int32_t slow;       // trailing average of x, Q4 << RSSI_TREND_SHIFT
+    uint32_t p;         // variance of x, dB^2 in Q8
+    int16_t x;          // estimate, dBm in Q4
+    int8_t trend;       // RssiTrend
+
+    void reset(int8_t rssi) {
+        x = rssi * 16;
+        slow = (int32_t)x << RSSI_TREND_SHIFT;
+        p = RSSI_R;
+        trend = TREND_STEADY;
+    }
+
+    // dtMs: since the previous reading
+    void update(int8_t rssi, uint32_t dtMs) {
+        if(dtMs > 0xFFFF) dtMs = 0xFFFF;   // keeps the product in range; p is capped anyway
+        p += (RSSI_Q * dtMs) >> 10;
+        if(p > RSSI_P_MAX) p = RSSI_P_MAX;
+        int32_t e = rssi * 16 - x;
+        if(e > RSSI_GATE_DB * 16) e = RSSI_GATE_DB * 16;
+        if(e < -RSSI_GATE_DB * 16) e = -RSSI_GATE_DB * 16;
+        uint32_t k = (p << 12) / (p + RSSI_R);            // gain, Q12
+        x += (e * (int32_t)k + (e < 0 ? -2048 : 2048)) / 4096;
+        p -= (p * k) >> 12;
+
+        uint32_t w = dtMs < RSSI_TREND_MS ? dtMs : RSSI_TREND_MS;
+        int64_t d = ((int64_t)x << RSSI_TREND_SHIFT) - slow;
+        int64_t step = d * w;                              // rounded half away from zero
+        step = step < 0 ? -((-step + RSSI_TREND_MS / 2) >> RSSI_TREND_SHIFT) : (step + RSSI_TREND_MS / 2) >> RSSI_TREND_SHIFT;
+        slow += (int32_t)step;
+        int32_t gap = x - ((slow + (1 << (RSSI_TREND_SHIFT - 1))) >> RSSI_TREND_SHIFT);
+        if(gap > RSSI_TREND_ON_DB * 16) trend = TREND_APPROACHING;
+        else if(gap < -RSSI_TREND_ON_DB * 16) trend = TREND_RECEDING;
+        else if(gap < RSSI_TREND_OFF_DB * 16 && gap > -RSSI_TREND_OFF_DB * 16) trend = TREND_STEADY;
+    }
+
+    int dbm() const { return (x >= 0 ? x + 8 : x - 8) / 16; }
+};
+
+// 10^(i/16) in Q12
+static const uint16_t RSSI_POW10_Q12[17] = {
+    4096, 4730, 5462, 6308, 7284, 8411, 9713, 11217, 12953,
+    14958, 17273, 19946, 23034, 26599, 30716, 35470, 40960
+};
+
+// Range for an RSSI estimate (Q4 dBm), clamped to 10 cm .. 100 m.
+// pathN10: the path-loss exponent times ten.
+static inline uint32_t rssiDistanceCm(int16_t xQ4, int8_t ref1m, uint8_t pathN10) {
+    int32_t e = ((int32_t)ref1m * 16 - xQ4) * 16 / (pathN10 ? pathN10 : 1);   // decades from 1 m, Q8
+    if(e < -256) e = -256;
+    if(e > 512) e = 512;
+    e += 256;                                            // decades from 10 cm
+    uint32_t i = (e & 255) >> 4, f = e & 15;
+    uint32_t frac = RSSI_POW10_Q12[i] + (((RSSI_POW10_Q12[i + 1] - RSSI_POW10_Q12[i]) * f) >> 4);
+    uint32_t cm = 10;
+    for(int d = e >> 8; d > 0; d--) cm *= 10;
+    return (cm * frac + 2048) >> 12;
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <stdint.h>
+
+/* ================== SPARKLINE ================== */
+// Fixed-size history of one live metric (heap, packet rate, device count,
+// loop time, ...). Samples are stored as uint16_t in units of Scale, so
+// Sparkline<40, 1024> keeps 40 heap readings in KB for ~100 bytes.
+//
+// push() is O(1): it writes into a ring and keeps the sum, min and max up to
+// date. Only when the sample leaving the window was the min or max does it
+// rescan the window for a new one. rescale() picks a "nice" display range
+// around the data and only moves it when the data leaves the range or
+// shrinks well inside it, so a trace doesn't jump around from tick to tick.
+//
+// No display dependencies; SweepGraph::show() draws one.
+
+template <uint16_t Capacity, uint32_t Scale = 1>
+class Sparkline {
+    static_assert(Capacity >= 2, "Sparkline needs room for at least two samples");
+
+public:
+    void clear() { head = 0; count = 0; total = 0; sum = 0; lo = hi = 0; }
+
+    void push(uint32_t raw) {
+        uint32_t scaled = (raw + Scale / 2) / Scale;
+        uint16_t v = scaled > 0xFFFF ? 0xFFFF : (uint16_t)scaled;
+        bool rescan = false;
+        if(count == Capacity) {
+            uint16_t old = samples[head];
+            sum -= old;
+            rescan = (old == minV || old == maxV);
+        } else {
+            count++;
+        }
+        samples[head] = v;
+        head = (head + 1) % Capacity;
+        sum += v;
+        total++;
+
+        if(count == 1) { minV = maxV = v; }
+        else if(rescan) { recompute(); }
+        else { if(v < minV) minV = v; if(v > maxV) maxV = v; }
+    }
+
+    uint16_t size() const { return count; }
+    uint32_t pushes() const { return total; }   // samples ever pushed, for sweep alignment
+    static constexpr uint16_t capacity() { return Capacity; }
+    static constexpr uint32_t scale() { return Scale; }
+
+    // i = 0 is the oldest sample still held
+    uint16_t at(uint16_t i) const { return samples[(head + Capacity - count + i) % Capacity]; }
+    uint16_t last() const { return count ? at(count - 1) : 0; }
+    uint16_t min() const { return count ? minV : 0; }
+    uint16_t max() const { return count ? maxV : 0; }
+    uint16_t avg() const { return count ? (uint16_t)((sum + count / 2) / count) : 0; }
+
+    // Display range. fromZero pins the bottom at 0 (rates, counts).
+    // Returns true when the range moved and the plot needs a full redraw.
+    bool rescale(bool fromZero) {
+        if(!count) return false;
+        uint16_t floorV = fromZero ? 0 : minV;
+        uint16_t unit = niceUnit((maxV - floorV) / 4 + 1);
+        uint16_t newLo = (floorV / unit) * unit;
+        if(!fromZero && newLo == minV && newLo >= unit) newLo -= unit;  // keep the trace off the bottom edge
+        uint32_t top = ((uint32_t)maxV / unit + 1) * unit;
+        uint16_t newHi = top > 0xFFFF ? 0xFFFF : (uint16_t)top;
+        bool contains = (hi > lo) && minV >= lo && maxV <= hi;
+        bool tooLoose = (uint32_t)(newHi - newLo) * 2 < (uint32_t)(hi - lo);
+        if(contains && !tooLoose) return false;
+        lo = newLo; hi = newHi;
+        return true;
+    }
+    uint16_t rangeLo() const { return lo; }
+    uint16_t rangeHi() const { return hi; }
+
+private:
+    void recompute() {
+        minV = 0xFFFF; maxV = 0;
+        for(uint16_t i = 0; i < count; i++) {
+            uint16_t v = samples[i];   // order doesn't matter here
+            if(v < minV) minV = v;
+            if(v > maxV) maxV = v;
+        }
+    }
+
+    // Smallest 1/2/5 x 10^n that is >= x
+    static uint16_t niceUnit(uint32_t x) {
+        uint32_t p = 1;
+        while(true) {
+            if(x <= p) return p;
+            if(x <= 2 * p) return 2 * p;
+            if(x <= 5 * p) return 5 * p;
+            if(p >= 10000) return 10000;
+            p *= 10;
+        }
+    }
+
+    uint16_t samples[Capacity];
+    uint16_t head = 0, count = 0;
+    uint16_t minV = 0, maxV = 0;
+    uint16_t lo = 0, hi = 0;
+    uint32_t sum = 0;
+    uint32_t total = 0;
+};
@@ -0,0 +1,75 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+
+/* ================== STRING POOL ================== */
+// Short strings (SSIDs, BLE names) kept once for a result table, so an entry
+// holds a 2-byte handle instead of a fixed array sized for the longest name.
+// Equal strings share one copy: mesh networks repeat an SSID on every AP.
+//
+// Handles are slot numbers, 0 for "", and stay valid while the string is in
+// use. There is no reference counting: when intern() runs out of room the
+// owner marks the handles its live entries hold and sweep() frees the rest,
+// sliding the survivors down so the free space is in one piece again.
+//
+// Each string costs its bytes, a terminator, a 2-byte back link in the arena
+// and a 4-byte slot.
+
+template <uint16_t BYTES, uint16_t STRINGS>
+class StringPool {
+public:
+    StringPool() { clear(); }
+    void clear() { memset(slots, 0, sizeof(slots)); used = 0; }
+
+    // Handle for the first len bytes of s (stops early at a 0 byte); 0 for an
+    // empty string or when there is no room left
+    uint16_t intern(const char* s, uint8_t len) {
+        len = strnlen(s, len);
+        if(!len) return 0;
+        for(uint16_t h = 1; h <= STRINGS; h++) {
+            const Slot& e = slots[h - 1];
+            if(e.len == len && memcmp(arena + e.at, s, len) == 0) return h;
+        }
+        if(used + 2 + len + 1 > BYTES) return 0;
+        uint16_t h = 1;
+        while(h <= STRINGS && slots[h - 1].len) h++;
+        if(h > STRINGS) return 0;
+        arena[used] = h; arena[used + 1] = h >> 8;
+        slots[h - 1] = { (uint16_t)(used + 2), len, 0 };
+        memcpy(arena + used + 2, s, len);
+        arena[used + 2 + len] = 0;
+        used += 2 + len + 1;
+        return h;
+    }
+
+    const char* get(uint16_t h) const { return h ? (const char*)arena + slots[h - 1].at : ""; }
+
+    // Collection: mark() every handle still held, then sweep()
+    void mark(uint16_t h) { if(h) slots[h - 1].marked = 1; }
+    void sweep() {
+        uint16_t in = 0, out = 0;
+        while(in < used) {
+            uint16_t h = arena[in] | arena[in + 1] << 8;
+            Slot& e = slots[h - 1];
+            uint16_t n = 2 + e.len + 1;
+            if(e.marked) {
+                memmove(arena + out, arena + in, n);
+                e.at = out + 2;
+                e.marked = 0;
+                out += n;
+            } else {
+                e = {};
+            }
+            in += n;
+        }
+        used = out;
+    }
+
+    uint16_t bytesUsed() const { return used; }
+
+private:
+    struct Slot { uint16_t at; uint8_t len; uint8_t marked; };   // len 0 = free
+    uint8_t arena[BYTES];
+    Slot slots[STRINGS];
+    uint16_t used;
+};
@@ -0,0 +1,95 @@
+#pragma once
+#include <Adafruit_GFX.h>
+
+/* ================== SWEEP GRAPH ================== */
+// Oscilloscope-style trace. Instead of shifting the whole history left and
+// repainting the plot every tick, each new sample is drawn in its own strip
+// at a cursor that walks left to right and wraps. A blank strip is kept
+// just ahead of the cursor so the newest point is easy to spot. One sample
+// costs (1 + SWEEP_GAP) strips of `step` x h pixels, not the full w x h.
+//
+// The ILI9341 hardware scroll can't do this here. It only moves whole
+// lines of the panel's native 320-pixel axis, and in rotation 3 those lines
+// are full-height screen columns, so everything above and below the graph
+// would scroll with it.
+//
+// show() draws a Sparkline (sparkline.h) and scales it to the plot area.
+// Sample n always lands in strip n % strips(), so after the range changes
+// the visible history can be replayed into the same places.
+
+#define SWEEP_GAP 1   // blank strips kept ahead of the cursor
+
+struct SweepGraph {
+    int16_t x, y, w, h;          // plot area, inside the frame
+    uint8_t step;                // pixels per sample
+    uint16_t lineColor, fillColor, bgColor;
+    bool filled;                 // shade under the trace
+    int16_t gridX = -1, gridY = -1;  // optional grid lines to keep intact
+    uint16_t gridColor = 0;
+
+    int16_t cursor = 0;          // strip the next sample goes into
+    int16_t lastY = -1;          // previous point, -1 after a wrap/reset
+
+    int16_t strips() const { return w / step; }
+
+    // Blank the plot area and restart at the left edge
+    void reset(Adafruit_GFX& gfx) {
+        gfx.fillRect(x, y, w, h, bgColor);
+        if(gridY >= y && gridY < y + h) gfx.drawFastHLine(x, gridY, w, gridColor);
+        if(gridX >= x && gridX < x + w) gfx.drawFastVLine(gridX, y, h, gridColor);
+        cursor = 0;
+        lastY = -1;
+    }
+
+    // v is the point's screen y, clamped to the plot area
+    void plot(Adafruit_GFX& gfx, int16_t v) {
+        if(v < y) v = y;
+        if(v > y + h - 1) v = y + h - 1;
+        int16_t px = x + (cursor + 1) * step - 1;   // point sits on the strip's right edge
+        if(filled) gfx.drawFastVLine(px, v, y + h - v, fillColor);
+        if(lastY < 0) gfx.drawPixel(px, v, lineColor);
+        else gfx.drawLine(px - step, lastY, px, v, lineColor);
+        lastY = v;
+
+        cursor++;
+        if(cursor >= strips()) { cursor = 0; lastY = -1; }
+        for(int i = 0; i < SWEEP_GAP; i++) clearStrip(gfx, (cursor + i) % strips());
+    }
+
+    // Newest sample of `line`, or its whole visible history if the display
+    // range moved. Returns true in that case, so the caller can relabel.
+    template <class Line>
+    bool show(Adafruit_GFX& gfx, Line& line, bool fromZero) {
+        if(!line.size()) return false;
+        if(line.rescale(fromZero)) { redraw(gfx, line); return true; }
+        plot(gfx, toY(line, line.last()));
+        return false;
+    }
+
+    // Blank the plot and replay as much of `line` as fits
+    template <class Line>
+    void redraw(Adafruit_GFX& gfx, const Line& line) {
+        reset(gfx);
+        uint16_t k = line.size();
+        if(k > strips() - SWEEP_GAP) k = strips() - SWEEP_GAP;
+        cursor = (line.pushes() - k) % strips();
+        for(uint16_t i = line.size() - k; i < line.size(); i++) plot(gfx, toY(line, line.at(i)));
+    }
+
+private:
+    template <class Line>
+    int16_t toY(const Line& line, uint16_t v) const {
+        uint16_t lo = line.rangeLo(), hi = line.rangeHi();
+        if(hi <= lo) return y + h - 1;
+        if(v < lo) v = lo;
+        if(v > hi) v = hi;
+        return y + h - 1 - (int32_t)(v - lo) * (h - 1) / (hi - lo);
+    }
+
+    void clearStrip(Adafruit_GFX& gfx, int16_t s) {
+        int16_t sx = x + s * step;
+        gfx.fillRect(sx, y, step, h, bgColor);
+        if(gridY >= y && gridY < y + h) gfx.drawFastHLine(sx, gridY, step, gridColor);
+        if(gridX >= sx && gridX < sx + step) gfx.drawFastVLine(gridX, y, h, gridColor);
+    }
+};
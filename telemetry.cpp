@@ -0,0 +1,76 @@
+#include "telemetry.h"
+
+uint16_t telemCrc16(const uint8_t* data, size_t len, uint16_t crc) {
+    while(len--) {
+        crc ^= (uint16_t)*data++ << 8;
+        for(int i = 0; i < 8; i++) crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+    return crc;
+}
+
+size_t cobsEncode(const uint8_t* in, size_t len, uint8_t* out) {
+    size_t code = 0, o = 1;   // code: where the current block's length byte goes
+    uint8_t run = 1;
+    for(size_t i = 0; i < len; i++) {
+        if(in[i]) { out[o++] = in[i]; run++; }
+        if(!in[i] || run == 0xFF) {
+            out[code] = run;
+            code = o++;
+            run = 1;
+        }
+    }
+    out[code] = run;
+    return o;
+}
+
+size_t cobsDecode(const uint8_t* in, size_t len, uint8_t* out) {
+    size_t i = 0, o = 0;
+    while(i < len) {
+        uint8_t run = in[i++];
+        if(!run || i + run - 1 > len) return 0;
+        for(uint8_t k = 1; k < run; k++) {
+            if(!in[i]) return 0;
+            out[o++] = in[i++];
+        }
+        if(run < 0xFF && i < len) out[o++] = 0;
+    }
+    return o;
+}
+
+size_t telemEncode(uint8_t type, uint16_t seq, uint32_t ms, const uint8_t* payload, size_t len, uint8_t* out) {
+    if(len > TELEM_MAX_PAYLOAD) return 0;
+    uint8_t raw[TELEM_MAX_RAW];
+    raw[0] = TELEM_VERSION; raw[1] = type;
+    raw[2] = seq; raw[3] = seq >> 8;
+    raw[4] = ms; raw[5] = ms >> 8; raw[6] = ms >> 16; raw[7] = ms >> 24;
+    memcpy(raw + TELEM_HEADER, payload, len);
+    size_t n = TELEM_HEADER + len;
+    uint16_t crc = telemCrc16(raw, n);
+    raw[n++] = crc; raw[n++] = crc >> 8;
+    size_t w = cobsEncode(raw, n, out);
+    out[w++] = 0;
+    return w;
+}
+
+bool TelemDecoder::push(uint8_t byte, TelemFrame& f) {
+    if(byte) {
+        if(used < sizeof(buf)) buf[used++] = byte;
+        else overrun = true;
+        return false;
+    }
+    size_t n = used;
+    bool over = overrun;
+    used = 0; overrun = false;
+    if(over) { st.overruns++; return false; }
+    if(!n) return false;   // back-to-back delimiters
+    n = cobsDecode(buf, n, buf);
+    if(n < TELEM_HEADER + 2 || telemCrc16(buf, n - 2) != (buf[n - 2] | buf[n - 1] << 8)) { st.badFrames++; return false; }
+    if(buf[0] != TELEM_VERSION) { st.otherVersion++; return false; }
+    f.type = buf[1];
+    f.seq = buf[2] | buf[3] << 8;
+    f.ms = buf[4] | buf[5] << 8 | buf[6] << 16 | (uint32_t)buf[7] << 24;
+    f.payload = buf + TELEM_HEADER;
+    f.len = n - 2 - TELEM_HEADER;
+    st.frames++;
+    return true;
+}
@@ -0,0 +1,139 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+/* ================== TELEMETRY PROTOCOL ================== */
+// Binary messages over Serial for a logging box that drives and watches
+// units without parsing text. Both directions use the same framing:
+//
+//   COBS( version, type, seq (LE16), ms (LE32), payload..., CRC-16 (LE16) ) 00
+//
+// COBS leaves no zero bytes inside a frame, so a zero always ends one and a
+// receiver that joins mid-stream (or hits line noise) is back in sync at the
+// next zero. The CRC is CRC-16/CCITT-FALSE over everything before it. seq
+// counts frames per direction, so the receiver can tell how many it lost; ms
+// is millis() of the sender (0 from the host). Integers are little-endian,
+// strings are a length byte and the bytes, without a terminator.
+//
+// A receiver skips frames with an unknown version, and messages of a known
+// version may only grow at the end: old decoders read the fields they know
+// and ignore the rest. Anything else needs a new TELEM_VERSION.
+//
+// The TM_LIST sent every period (paged = 0) is the window of rows around the
+// screen. For the rest of the list the host sends TC_LIST; after its TM_ACK
+// the rows come back as TM_LISTs with paged = 1 and the TC_LIST's seq, each
+// picking up at the row after the last one's first + n, until count rows are
+// sent or the list ends (a short or empty page). rows is the list's length
+// when the page was made; the list may change between pages, so a host that
+// needs one consistent copy pauses the scan first. A new TC_LIST cancels
+// the one in progress.
+//
+// Nothing in here touches Arduino, so host/telem_recv.cpp builds it as is.
+
+#define TELEM_VERSION      1
+#define TELEM_HEADER       8
+#define TELEM_MAX_PAYLOAD  512
+#define TELEM_MAX_RAW      (TELEM_HEADER + TELEM_MAX_PAYLOAD + 2)
+#define TELEM_MAX_WIRE     (TELEM_MAX_RAW + TELEM_MAX_RAW / 254 + 2)   // COBS overhead + delimiter
+
+enum TelemType : uint8_t {
+    // Device -> host
+    TM_HELLO   = 0x01,   // u16 periodMs, u8 page, str firmware
+    TM_STATUS  = 0x02,   // u32 freeHeap, u32 minFreeHeap, u32 loops, u32 loopAvgUs, u32 loopMaxUs, u8 page,
+                         // u32 framesDropped (telemetry frames the UART had no room for)
+    TM_PACKETS = 0x03,   // u32 rate (frames/s), u32 total, u32 dropped, u8 channel, u8 n, n x u32 per-category counts
+    TM_LIST    = 0x04,   // u8 radioMode, u8 channel, u8 live, u16 rows, u16 total, u32 dropped, u16 first,
+                         // u8 n, n x (str label, str detail, i16 value), u8 paged, u16 command seq
+    TM_ACK     = 0x05,   // u8 command type, u16 command seq, u8 TelemResult
+    // Host -> device
+    TC_PING    = 0x81,   // answered with TM_HELLO
+    TC_RATE    = 0x82,   // u16 periodMs
+    TC_CHANNEL = 0x83,   // u8 channel, stops hopping
+    TC_SCAN    = 0x84,   // rescan the open list page, or open NET_SCN
+    TC_PAGE    = 0x85,   // u8 page
+    TC_STOP    = 0x86,   // back to the text console
+    TC_LIST    = 0x87,   // u16 first, u16 count: the list from row first on, in paged TM_LISTs
+};
+
+enum TelemResult : uint8_t { TR_OK, TR_BAD_ARG, TR_REFUSED, TR_UNKNOWN };
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF); "123456789" gives 0x29B1
+uint16_t telemCrc16(const uint8_t* data, size_t len, uint16_t crc = 0xFFFF);
+
+// out needs len + len / 254 + 1 bytes. No trailing zero is written.
+size_t cobsEncode(const uint8_t* in, size_t len, uint8_t* out);
+// Decodes one frame without its zero; out may be in. 0 if malformed.
+size_t cobsDecode(const uint8_t* in, size_t len, uint8_t* out);
+
+// Wraps payload as a frame, delimiter included, into out[TELEM_MAX_WIRE].
+// Returns the bytes to send, 0 if the payload is too long.
+size_t telemEncode(uint8_t type, uint16_t seq, uint32_t ms, const uint8_t* payload, size_t len, uint8_t* out);
+
+// --- payloads ---
+struct TelemWriter {
+    uint8_t buf[TELEM_MAX_PAYLOAD];
+    uint16_t len = 0;
+    bool overflow = false;
+
+    void bytes(const void* p, size_t n) {
+        if(len + n > sizeof(buf)) { overflow = true; return; }
+        memcpy(buf + len, p, n);
+        len += n;
+    }
+    void u8(uint8_t v) { bytes(&v, 1); }
+    void u16(uint16_t v) { uint8_t b[2] = { (uint8_t)v, (uint8_t)(v >> 8) }; bytes(b, 2); }
+    void u32(uint32_t v) { uint8_t b[4] = { (uint8_t)v, (uint8_t)(v >> 8), (uint8_t)(v >> 16), (uint8_t)(v >> 24) }; bytes(b, 4); }
+    void str(const char* s) { size_t n = strnlen(s, 255); u8(n); bytes(s, n); }
+};
+
+// Reads past the end return 0 / "" and clear ok
+struct TelemReader {
+    const uint8_t* p;
+    size_t left;
+    bool ok = true;
+
+    TelemReader(const uint8_t* data, size_t len) : p(data), left(len) {}
+    bool take(size_t n) { if(n > left) { ok = false; left = 0; return false; } return true; }
+    uint8_t u8() { if(!take(1)) return 0; left--; return *p++; }
+    uint16_t u16() { if(!take(2)) return 0; uint16_t v = p[0] | p[1] << 8; p += 2; left -= 2; return v; }
+    uint32_t u32() { if(!take(4)) return 0; uint32_t v = p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24; p += 4; left -= 4; return v; }
+    // Copies into out[outLen], always terminated
+    void str(char* out, size_t outLen) {
+        uint8_t n = u8();
+        if(!take(n)) { out[0] = 0; return; }
+        size_t k = n < outLen - 1 ? n : outLen - 1;
+        memcpy(out, p, k); out[k] = 0;
+        p += n; left -= n;
+    }
+};
+
+// --- receiving ---
+struct TelemFrame {
+    uint8_t type;
+    uint16_t seq;
+    uint32_t ms;
+    const uint8_t* payload;   // valid until the next push()
+    uint16_t len;
+};
+
+struct TelemDecoderStats {
+    uint32_t frames;
+    uint32_t badFrames;       // COBS or CRC errors, or too short
+    uint32_t otherVersion;
+    uint32_t overruns;        // longer than TELEM_MAX_WIRE
+};
+
+// Feed it the stream a byte at a time; push() returns true when that byte
+// completed a good frame.
+class TelemDecoder {
+public:
+    bool push(uint8_t byte, TelemFrame& f);
+    const TelemDecoderStats& stats() const { return st; }
+
+private:
+    uint8_t buf[TELEM_MAX_WIRE];
+    uint16_t used = 0;
+    bool overrun = false;
+    TelemDecoderStats st = {};
+};
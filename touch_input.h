@@ -0,0 +1,125 @@
+#pragma once
+#include <stdint.h>
+#include <stdlib.h>
+#include "capture_ring.h"
+
+/* ================== TOUCH INPUT ================== */
+// Turns raw XPT2046 samples into touch events. sample() is the producer side
+// and runs from the touch sampling timer, not from loop(). It applies a
+// pressure threshold with hysteresis, requires a couple of agreeing samples
+// before reporting a press or a release (the controller bounces at the
+// start and end of a touch), smooths the position and converts it to screen
+// coordinates. The results go into an SPSC queue that loop() drains with
+// next().
+//
+// Events:
+//   TOUCH_DOWN    press confirmed at (x, y)
+//   TOUCH_DRAG    moved past TOUCH_SLOP; (dx, dy) is the offset from DOWN
+//   TOUCH_REPEAT  held still: after TOUCH_REPEAT_DELAY, then every TOUCH_REPEAT_MS
+//   TOUCH_SWIPE   lifted while moving fast; (dx, dy) is the velocity in px/s
+//   TOUCH_UP      released at (x, y); (dx, dy) is the total offset
+
+#define TOUCH_SAMPLE_MS     5     // sampling period while the pen is down
+#define TOUCH_Z_PRESS       200   // pressure needed to start a touch
+#define TOUCH_Z_RELEASE     120   // ... and to keep it going
+#define TOUCH_DOWN_SAMPLES  2     // agreeing samples before DOWN
+#define TOUCH_UP_SAMPLES    3     // missing samples before UP
+#define TOUCH_SLOP          8     // px of movement before a touch becomes a drag
+#define TOUCH_SWIPE_SPEED   300   // px/s at release to count as a swipe
+#define TOUCH_REPEAT_DELAY  400
+#define TOUCH_REPEAT_MS     150
+
+enum TouchEventType : uint8_t { TOUCH_DOWN, TOUCH_DRAG, TOUCH_REPEAT, TOUCH_SWIPE, TOUCH_UP };
+
+struct TouchEvent {
+    uint8_t type;
+    int16_t x, y;
+    int16_t dx, dy;
+    uint32_t ms;      // millis() of the sample that produced it
+};
+
+// Raw readings at the left/right and top/bottom screen edges
+struct TouchCal {
+    int16_t rawLeft, rawRight, rawTop, rawBottom;
+    int16_t width, height;
+};
+
+class TouchInput {
+public:
+    explicit TouchInput(const TouchCal& c) : cal(c) {}
+
+    // Producer: one controller reading
+    void sample(int16_t rawX, int16_t rawY, int16_t z, uint32_t now) {
+        bool pressed = z >= (down ? TOUCH_Z_RELEASE : TOUCH_Z_PRESS);
+        if(!pressed) {
+            pressCount = 0;
+            if(!down || ++releaseCount < TOUCH_UP_SAMPLES) return;
+            down = false;
+            if(dragging && (abs(vx) >= TOUCH_SWIPE_SPEED || abs(vy) >= TOUCH_SWIPE_SPEED)) emit(TOUCH_SWIPE, vx, vy, now);
+            emit(TOUCH_UP, x - x0, y - y0, now);
+            return;
+        }
+        releaseCount = 0;
+        if(pressCount == 0 && !down) { fx = rawX; fy = rawY; }
+        else { fx = (fx + rawX) / 2; fy = (fy + rawY) / 2; }
+
+        if(!down) {
+            if(++pressCount < TOUCH_DOWN_SAMPLES) return;
+            down = true;
+            dragging = false;
+            x = x0 = toScreen(fx, cal.rawLeft, cal.rawRight, cal.width);
+            y = y0 = toScreen(fy, cal.rawTop, cal.rawBottom, cal.height);
+            vx = vy = 0;
+            lastMs = now;
+            nextRepeat = now + TOUCH_REPEAT_DELAY;
+            emit(TOUCH_DOWN, 0, 0, now);
+            return;
+        }
+
+        int16_t nx = toScreen(fx, cal.rawLeft, cal.rawRight, cal.width);
+        int16_t ny = toScreen(fy, cal.rawTop, cal.rawBottom, cal.height);
+        uint32_t dt = now - lastMs;
+        if(dt) {
+            // Smoothed velocity, so one noisy sample at lift-off can't fake a swipe
+            vx += ((int32_t)(nx - x) * 1000 / (int32_t)dt - vx) / 2;
+            vy += ((int32_t)(ny - y) * 1000 / (int32_t)dt - vy) / 2;
+        }
+        lastMs = now;
+        bool moved = (nx != x || ny != y);
+        x = nx; y = ny;
+
+        if(!dragging && (abs(x - x0) > TOUCH_SLOP || abs(y - y0) > TOUCH_SLOP)) { dragging = true; moved = true; }
+        if(dragging) { if(moved) emit(TOUCH_DRAG, x - x0, y - y0, now); }
+        else if((int32_t)(now - nextRepeat) >= 0) { emit(TOUCH_REPEAT, 0, 0, now); nextRepeat += TOUCH_REPEAT_MS; }
+    }
+
+    // True while a touch is in progress or being confirmed; the sampler
+    // keeps running until this goes false.
+    bool active() const { return down || pressCount > 0; }
+
+    // Consumer
+    bool next(TouchEvent& ev) { return events.pop(ev); }
+    uint32_t dropped() const { return events.dropped(); }
+
+private:
+    static int16_t toScreen(int32_t raw, int16_t r0, int16_t r1, int16_t span) {
+        int32_t v = (raw - r0) * span / (r1 - r0);
+        return v < 0 ? 0 : (v >= span ? span - 1 : (int16_t)v);
+    }
+
+    static int16_t clamp16(int32_t v) { return v < -32767 ? -32767 : (v > 32767 ? 32767 : (int16_t)v); }
+
+    void emit(uint8_t type, int32_t dx, int32_t dy, uint32_t now) {
+        TouchEvent ev = { type, x, y, clamp16(dx), clamp16(dy), now };
+        events.push(ev);   // a full queue drops the event; DRAG offsets are absolute, so the next one catches up
+    }
+
+    TouchCal cal;
+    SpscRing<TouchEvent, 32> events;
+    int32_t fx = 0, fy = 0;            // smoothed raw position
+    int16_t x = 0, y = 0, x0 = 0, y0 = 0;
+    int32_t vx = 0, vy = 0;
+    uint32_t lastMs = 0, nextRepeat = 0;
+    uint8_t pressCount = 0, releaseCount = 0;
+    bool down = false, dragging = false;
+};
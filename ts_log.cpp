@@ -0,0 +1,302 @@
+#include "ts_log.h"
+#include <stdio.h>
+#include <string.h>
+
+static inline void putLE32(uint8_t* p, uint32_t v) { p[0] = v & 0xFF; p[1] = (v >> 8) & 0xFF; p[2] = (v >> 16) & 0xFF; p[3] = v >> 24; }
+static inline uint32_t getLE32(const uint8_t* p) { return p[0] | p[1] << 8 | p[2] << 16 | (uint32_t)p[3] << 24; }
+
+static uint8_t putVarint(uint8_t* p, uint64_t v) {
+    uint8_t n = 0;
+    while(v >= 0x80) { p[n++] = (uint8_t)v | 0x80; v >>= 7; }
+    p[n++] = (uint8_t)v;
+    return n;
+}
+
+static void segmentPath(char* out, size_t len, uint8_t slot) { snprintf(out, len, TSLOG_DIR "/%02u.bin", slot); }
+
+/* ================== CURSOR ================== */
+bool TsLogCursor::open(fs::FS& fs, uint8_t slot, uint32_t maxBytes) {
+    char path[24];
+    segmentPath(path, sizeof(path), slot);
+    file = fs.open(path, "r");
+    if(!file) return false;
+    uint8_t hdr[TSLOG_HEADER_BYTES];
+    if(maxBytes < TSLOG_HEADER_BYTES || file.read(hdr, sizeof(hdr)) != sizeof(hdr) || getLE32(hdr) != TSLOG_MAGIC) {
+        file.close();
+        return false;
+    }
+    segSeq = getLE32(hdr + 4);
+    startTime = getLE32(hdr + 8) | (uint64_t)getLE32(hdr + 12) << 32;
+    limit = maxBytes;
+    good = blkOffset = TSLOG_HEADER_BYTES;
+    blkLen = blkPos = 0;
+    t = startTime;
+    memset(prev, 0, sizeof(prev));
+    return true;
+}
+
+int TsLogCursor::get() {
+    if(blkPos == blkLen) {
+        blkOffset += blkLen;
+        blkPos = 0;
+        uint32_t want = limit - blkOffset;
+        if(want > sizeof(blk)) want = sizeof(blk);
+        blkLen = want ? file.read(blk, want) : 0;
+        if(!blkLen) return -1;
+    }
+    return blk[blkPos++];
+}
+
+bool TsLogCursor::getVarint(uint64_t& v) {
+    v = 0;
+    for(int shift = 0; shift < 64; shift += 7) {
+        int c = get();
+        if(c < 0) return false;
+        v |= (uint64_t)(c & 0x7F) << shift;
+        if(!(c & 0x80)) return true;
+    }
+    return false;
+}
+
+bool TsLogCursor::getEntry(TsLogEntry& e) {
+    uint8_t raw[9];
+    for(uint8_t i = 0; i < sizeof(raw); i++) {
+        int c = get();
+        if(c < 0) return false;
+        raw[i] = c;
+    }
+    uint64_t first, last;
+    if(!getVarint(first) || !getVarint(last) || first > 0xFFFF || last > 0xFFFF) return false;
+    e.kind = raw[0];
+    memcpy(e.addr, raw + 1, 6);
+    e.channel = raw[7];
+    e.rssi = (int8_t)raw[8];
+    e.firstAgoS = first;
+    e.lastAgoS = last;
+    return true;
+}
+
+bool TsLogCursor::next(TsLogRecord& rec) {
+    if(!file) return false;
+    uint64_t dt, zz;
+    int series = get();
+    if(series == TSLOG_ENTRY) {
+        if(!getVarint(dt) || !getEntry(rec.entry)) { file.close(); return false; }
+        t += dt;
+        rec.ms = t;
+        rec.series = TSLOG_ENTRY;
+        rec.value = 0;
+        good = blkOffset + blkPos;
+        return true;
+    }
+    if(series < 0 || series >= TSLOG_SERIES || !getVarint(dt) || !getVarint(zz)) { file.close(); return false; }
+    int64_t delta = (int64_t)(zz >> 1) ^ -(int64_t)(zz & 1);
+    t += dt;
+    prev[series] = (int32_t)(prev[series] + delta);
+    rec.ms = t;
+    rec.series = series;
+    rec.value = prev[series];
+    good = blkOffset + blkPos;
+    return true;
+}
+
+/* ================== WRITER ================== */
+// Rebuilds one index entry. A torn tail (power lost mid-flush) just ends the
+// segment early; nothing is ever appended to a segment from an earlier boot.
+void TsLog::scan(uint8_t slot) {
+    TsLogSegment& seg = index[slot];
+    seg = {};
+    TsLogCursor cur;
+    if(!cur.open(*fs, slot, TSLOG_SEG_BYTES) || cur.seq() == 0 || cur.seq() % TSLOG_SEGMENTS != slot) return;
+    seg.seq = cur.seq();
+    seg.firstMs = seg.lastMs = cur.startMs();
+    TsLogRecord rec;
+    while(cur.next(rec)) seg.lastMs = rec.ms;
+    seg.bytes = cur.goodBytes();
+}
+
+bool TsLog::begin(fs::FS& f, uint32_t nowMillis) {
+    fs = &f;
+    fs->mkdir(TSLOG_DIR);
+    seq = 0;
+    uint64_t newest = 0;
+    for(uint8_t slot = 0; slot < TSLOG_SEGMENTS; slot++) {
+        scan(slot);
+        if(index[slot].seq > seq) { seq = index[slot].seq; newest = index[slot].lastMs; }
+    }
+    bootMillis = nowMillis;
+    base = seq ? newest + 1 : 0;
+    lastFlush = nowMillis;
+    startSegment(base);
+    append(TSLOG_SERIES_BOOT, (int32_t)seq, nowMillis);
+    return true;
+}
+
+void TsLog::startSegment(uint64_t ms) {
+    flush();
+    seq++;
+    uint8_t slot = seq % TSLOG_SEGMENTS;
+    char path[24];
+    segmentPath(path, sizeof(path), slot);
+    uint8_t hdr[TSLOG_HEADER_BYTES];
+    putLE32(hdr, TSLOG_MAGIC);
+    putLE32(hdr + 4, seq);
+    putLE32(hdr + 8, (uint32_t)ms);
+    putLE32(hdr + 12, (uint32_t)(ms >> 32));
+    fs::File file = fs->open(path, "w");   // truncates the oldest segment
+    bool ok = file && file.write(hdr, sizeof(hdr)) == sizeof(hdr);
+    file.close();
+    index[slot] = { ok ? seq : 0, TSLOG_HEADER_BYTES, ms, ms };
+    lastMs = ms;
+    memset(prev, 0, sizeof(prev));
+}
+
+uint8_t TsLog::encode(uint8_t* out, uint8_t series, uint64_t dt, int32_t value) const {
+    int64_t delta = (int64_t)value - prev[series];
+    uint8_t n = 0;
+    out[n++] = series;
+    n += putVarint(out + n, dt);
+    n += putVarint(out + n, ((uint64_t)delta << 1) ^ (uint64_t)(delta >> 63));
+    return n;
+}
+
+uint8_t TsLog::encodeEntry(uint8_t* out, uint64_t dt, const TsLogEntry& e) const {
+    uint8_t n = 0;
+    out[n++] = TSLOG_ENTRY;
+    n += putVarint(out + n, dt);
+    out[n++] = e.kind;
+    memcpy(out + n, e.addr, 6);
+    n += 6;
+    out[n++] = e.channel;
+    out[n++] = (uint8_t)e.rssi;
+    n += putVarint(out + n, e.firstAgoS);
+    n += putVarint(out + n, e.lastAgoS);
+    return n;
+}
+
+void TsLog::append(uint8_t series, int32_t value, uint32_t nowMillis) {
+    if(!fs || series >= TSLOG_SERIES) return;
+    uint64_t ms = clock(nowMillis);
+    if(ms < lastMs) ms = lastMs;
+    uint8_t rec[TSLOG_RECORD_MAX];
+    uint8_t n = encode(rec, series, ms - lastMs, value);
+    if(index[seq % TSLOG_SEGMENTS].bytes + bufLen + n > TSLOG_SEG_BYTES) {
+        startSegment(ms);
+        n = encode(rec, series, 0, value);
+    }
+    put(rec, n, ms);
+    prev[series] = value;
+}
+
+void TsLog::appendEntry(const TsLogEntry& entry, uint32_t nowMillis) {
+    if(!fs) return;
+    uint64_t ms = clock(nowMillis);
+    if(ms < lastMs) ms = lastMs;
+    uint8_t rec[TSLOG_RECORD_MAX];
+    uint8_t n = encodeEntry(rec, ms - lastMs, entry);
+    if(index[seq % TSLOG_SEGMENTS].bytes + bufLen + n > TSLOG_SEG_BYTES) {
+        startSegment(ms);
+        n = encodeEntry(rec, 0, entry);
+    }
+    put(rec, n, ms);
+}
+
+void TsLog::put(const uint8_t* rec, uint8_t n, uint64_t ms) {
+    if(bufLen + n > TSLOG_BUF_BYTES) flush();
+    memcpy(buf + bufLen, rec, n);
+    bufLen += n;
+    lastMs = ms;
+    index[seq % TSLOG_SEGMENTS].lastMs = ms;
+    records++;
+}
+
+void TsLog::flush() {
+    if(!fs || !bufLen) return;
+    uint16_t len = bufLen;
+    bufLen = 0;
+    TsLogSegment& seg = index[seq % TSLOG_SEGMENTS];
+    if(seg.seq != seq) return;   // the segment couldn't be created; drop rather than write headerless
+    char path[24];
+    segmentPath(path, sizeof(path), seq % TSLOG_SEGMENTS);
+    fs::File file = fs->open(path, "a");
+    size_t written = file ? file.write(buf, len) : 0;
+    file.close();
+    seg.bytes += written;
+    flushes++;
+    // A short write leaves a torn record; readers stop there, so carry on in a new segment
+    if(written != len) startSegment(lastMs);
+}
+
+void TsLog::service(uint32_t nowMillis) {
+    if(nowMillis - lastFlush < TSLOG_FLUSH_MS) return;
+    lastFlush = nowMillis;
+    flush();
+}
+
+void TsLog::clear(uint32_t nowMillis) {
+    if(!fs) return;
+    bufLen = 0;
+    char path[24];
+    for(uint8_t slot = 0; slot < TSLOG_SEGMENTS; slot++) {
+        if(!index[slot].seq) continue;
+        segmentPath(path, sizeof(path), slot);
+        fs->remove(path);
+        index[slot] = {};
+    }
+    startSegment(clock(nowMillis));
+}
+
+TsLogStats TsLog::stats() const {
+    TsLogStats s = {};
+    s.records = records;
+    s.flushes = flushes;
+    s.bytes = bufLen;
+    for(uint8_t slot = 0; slot < TSLOG_SEGMENTS; slot++) {
+        const TsLogSegment& seg = index[slot];
+        if(!seg.seq) continue;
+        if(!s.segments || seg.firstMs < s.firstMs) s.firstMs = seg.firstMs;
+        if(seg.lastMs > s.lastMs) s.lastMs = seg.lastMs;
+        s.segments++;
+        s.bytes += seg.bytes;
+    }
+    return s;
+}
+
+/* ================== READER ================== */
+void TsLogReader::begin(TsLog& l, uint64_t fromMs, uint64_t toMs) {
+    log = &l;
+    from = fromMs;
+    to = toMs;
+    cursor.close();
+    inSegment = false;
+    lastSeq = l.seq;
+    nextSeq = lastSeq >= TSLOG_SEGMENTS ? lastSeq - TSLOG_SEGMENTS + 1 : 1;
+}
+
+bool TsLogReader::next(TsLogRecord& rec) {
+    if(!log || !log->fs) return false;
+    for(;;) {
+        if(!inSegment) {
+            if(nextSeq > lastSeq) return false;
+            uint32_t s = nextSeq++;
+            const TsLogSegment& seg = log->index[s % TSLOG_SEGMENTS];
+            if(seg.seq != s || seg.lastMs < from || seg.firstMs > to) continue;   // the index skips whole segments
+            if(!cursor.open(*log->fs, s % TSLOG_SEGMENTS, seg.bytes) || cursor.seq() != s) continue;
+            inSegment = true;
+        }
+        // The ring may have wrapped onto this slot since begin()
+        if(log->index[cursor.seq() % TSLOG_SEGMENTS].seq != cursor.seq() || !cursor.next(rec)) {
+            cursor.close();
+            inSegment = false;
+            continue;
+        }
+        if(rec.ms < from) continue;
+        if(rec.ms > to) {   // times only grow from here on
+            cursor.close();
+            inSegment = false;
+            nextSeq = lastSeq + 1;
+            return false;
+        }
+        return true;
+    }
+}
@@ -0,0 +1,153 @@
+#pragma once
+#include <FS.h>
+#include <stdint.h>
+
+/* ================== TIME-SERIES LOG ================== */
+// History that outlives the page it was measured on. Samples are appended to
+// a ring of TSLOG_SEGMENTS segment files on LittleFS; when the newest one is
+// full the oldest file is truncated and reused, so every segment gets
+// rewritten in turn and the log never grows past SEGMENTS * SEG_BYTES.
+// Records are buffered in RAM and written at most every TSLOG_FLUSH_MS (or
+// when the buffer fills), so flash sees a few hundred bytes a minute.
+//
+// A record is one series byte, the time since the previous record and the
+// change from the series' previous value, both as varints (the value
+// zigzagged). A sample every 10 s costs 3-4 bytes, so the default ring holds
+// several days. Deltas restart at each segment, so a segment decodes on its
+// own; its header carries the absolute start time.
+//
+// Scan results are logged per entry as well: an entry record is the
+// TSLOG_ENTRY byte, the time since the previous record, a kind byte the
+// caller defines, the 6-byte address, channel and RSSI, then how many seconds
+// before the record the entry was first and last seen, as varints. About 15
+// bytes each; they don't take part in the series deltas.
+//
+// Times are on the log clock: milliseconds of powered-on time, continued
+// across reboots from the last record on flash (there is no RTC). Every
+// boot starts a fresh segment with a TSLOG_SERIES_BOOT record.
+//
+// The in-RAM index keeps each segment's time span, so a range read opens
+// only the segments that overlap it.
+
+#define TSLOG_DIR           "/tslog"
+#define TSLOG_SEGMENTS      32
+#define TSLOG_SEG_BYTES     8192
+#define TSLOG_BUF_BYTES     256
+#define TSLOG_FLUSH_MS      60000
+#define TSLOG_SERIES        16        // series ids 0..15
+#define TSLOG_SERIES_BOOT   0         // value: the new segment's sequence number
+#define TSLOG_MAGIC         0x314C5354UL   // "TSL1"
+#define TSLOG_HEADER_BYTES  16        // magic, seq, start ms (u64), little-endian
+#define TSLOG_ENTRY         0x80      // series byte of an entry record
+#define TSLOG_RECORD_MAX    27        // an entry: tag, 10-byte varint, 10 bytes, two 3-byte varints
+
+// One scan result: added to a table or gone from it
+struct TsLogEntry {
+    uint8_t kind;
+    uint8_t addr[6];
+    uint8_t channel;
+    int8_t rssi;
+    uint16_t firstAgoS;     // seconds before the record
+    uint16_t lastAgoS;
+};
+
+struct TsLogRecord {
+    uint64_t ms;
+    uint8_t series;         // TSLOG_ENTRY: entry is set, value isn't
+    int32_t value;
+    TsLogEntry entry;
+};
+
+// Index entry for one ring slot
+struct TsLogSegment {
+    uint32_t seq;           // 0 = slot unused
+    uint32_t bytes;         // on flash, header included
+    uint64_t firstMs;
+    uint64_t lastMs;        // includes records still in the RAM buffer
+};
+
+struct TsLogStats {
+    uint8_t segments;
+    uint32_t bytes;         // on flash + buffered
+    uint32_t records;       // appended since boot
+    uint32_t flushes;
+    uint64_t firstMs, lastMs;
+};
+
+// Decodes one segment file front to back, a block at a time
+class TsLogCursor {
+public:
+    bool open(fs::FS& fs, uint8_t slot, uint32_t limit);   // limit: bytes to read at most
+    bool next(TsLogRecord& rec);    // false at the end or at a torn record
+    void close() { file.close(); }
+    uint32_t seq() const { return segSeq; }
+    uint64_t startMs() const { return startTime; }
+    uint32_t goodBytes() const { return good; }   // up to the end of the last whole record
+
+private:
+    int get();
+    bool getVarint(uint64_t& v);
+    bool getEntry(TsLogEntry& e);
+
+    fs::File file;
+    uint32_t segSeq = 0;
+    uint64_t startTime = 0;
+    uint32_t limit = 0, good = 0;
+    uint32_t blkOffset = 0;         // file offset of blk[0]
+    uint16_t blkLen = 0, blkPos = 0;
+    uint8_t blk[256];
+    uint64_t t = 0;
+    int32_t prev[TSLOG_SERIES];
+};
+
+class TsLog {
+public:
+    // Scans the ring, rebuilds the index and opens a new segment
+    bool begin(fs::FS& fs, uint32_t nowMillis);
+    bool ready() const { return fs != nullptr; }
+
+    void append(uint8_t series, int32_t value, uint32_t nowMillis);
+    void appendEntry(const TsLogEntry& entry, uint32_t nowMillis);
+    void service(uint32_t nowMillis);   // flushes every TSLOG_FLUSH_MS
+    void flush();
+    void clear(uint32_t nowMillis);
+
+    uint64_t clock(uint32_t nowMillis) const { return base + (uint32_t)(nowMillis - bootMillis); }
+    TsLogStats stats() const;
+
+private:
+    friend class TsLogReader;
+    void scan(uint8_t slot);
+    void startSegment(uint64_t ms);
+    uint8_t encode(uint8_t* out, uint8_t series, uint64_t dt, int32_t value) const;
+    uint8_t encodeEntry(uint8_t* out, uint64_t dt, const TsLogEntry& entry) const;
+    void put(const uint8_t* rec, uint8_t n, uint64_t ms);
+
+    fs::FS* fs = nullptr;
+    TsLogSegment index[TSLOG_SEGMENTS];
+    uint32_t seq = 0;               // segment being appended to
+    uint64_t base = 0;              // log clock at bootMillis
+    uint32_t bootMillis = 0;
+    uint64_t lastMs = 0;            // time of the previous record in this segment
+    int32_t prev[TSLOG_SERIES];
+    uint8_t buf[TSLOG_BUF_BYTES];
+    uint16_t bufLen = 0;
+    uint32_t lastFlush = 0;
+    uint32_t records = 0, flushes = 0;
+};
+
+// Records with fromMs <= ms <= toMs, oldest first, a record per next() call,
+// so a dump can be spread over many loop() passes. Only what was on flash
+// when begin() was called is read: flush() first to include the buffer.
+class TsLogReader {
+public:
+    void begin(TsLog& log, uint64_t fromMs, uint64_t toMs);
+    bool next(TsLogRecord& rec);
+
+private:
+    TsLog* log = nullptr;
+    TsLogCursor cursor;
+    bool inSegment = false;
+    uint32_t nextSeq = 0, lastSeq = 0;
+    uint64_t from = 0, to = 0;
+};